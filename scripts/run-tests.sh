@@ -18,6 +18,9 @@ cp ../tests/data/pokemoninfo/* . -R
 ./test-pokemoninfo
 ensure_good_run
 
+./test-serverfiles
+ensure_good_run
+
 [[ -f BattleServer ]] && (./BattleServer &> /dev/null &) || (./BattleServer_debug &> /dev/null &)
 
 #Give time to the battle server to initialize
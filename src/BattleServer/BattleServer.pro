@@ -32,7 +32,9 @@ SOURCES += main.cpp \
     moves.cpp \
     serverconnection.cpp \
     analyzer.cpp \
-    consolereader.cpp
+    consolereader.cpp \
+    effecthooks.cpp \
+    resimulation.cpp
 
 HEADERS += \
     rbymoves.h \
@@ -57,7 +59,9 @@ HEADERS += \
     pluginmanager.h \
     serverconnection.h \
     analyzer.h \
-    consolereader.h
+    consolereader.h \
+    effecthooks.h \
+    resimulation.h
 
 include(../Shared/Common.pri)
 
@@ -9,14 +9,16 @@ QHash<int, AbilityMechanics> AbilityEffect::mechanics;
 QHash<int, QString> AbilityEffect::names;
 QHash<QString, int> AbilityEffect::nums;
 
-void AbilityEffect::activate(const QString &effect, int num, int source, int target, BattleSituation &b)
+void AbilityEffect::activate(int hook, int num, int source, int target, BattleSituation &b)
 {
     AbilityInfo::Effect e = AbilityInfo::Effects(num, b.gen());
 
-    if (!mechanics.contains(e.num) || !mechanics[e.num].functions.contains(effect)) {
+    QHash<int, AbilityMechanics>::const_iterator it = mechanics.constFind(e.num);
+
+    if (it == mechanics.constEnd() || !it->functions.contains(hook)) {
         return;
     }
-    mechanics[e.num].functions[effect](source, target, b);
+    it->functions.value(hook)(source, target, b);
 }
 
 void AbilityEffect::setup(int num, int source, BattleSituation &b, bool firstAct)
@@ -48,7 +50,7 @@ void AbilityEffect::setup(int num, int source, BattleSituation &b, bool firstAct
         }
     }
 
-    activate("UponSetup", num, source, source, b);
+    activate(EffectHook::UponSetup, num, source, source, b);
 }
 
 struct AMPinch : public AM
@@ -292,11 +294,11 @@ struct AMCuteCharm : public AM {
                 b.disposeItem(t);
             } else {
                 b.link(s, t, "Attract");
-                addFunction(poke(b,t), "DetermineAttackPossible", "Attract", &pda);
+                addFunction(poke(b,t), EffectHook::DetermineAttackPossible, "Attract", &pda);
 
                 if (b.hasWorkingItem(t, Item::DestinyKnot) && b.isSeductionPossible(t, s) && !b.linked(s, "Attract")) {
                     b.link(t, s, "Attract");
-                    addFunction(poke(b,s), "DetermineAttackPossible", "Attract", &pda);
+                    addFunction(poke(b,s), EffectHook::DetermineAttackPossible, "Attract", &pda);
                     b.sendItemMessage(41,t,0,s);
                 }
             }
@@ -1702,7 +1704,7 @@ struct AMSheerForce : public AM
 
         /* Ugly, to tell life orb not to activate =/ */
         turn(b,s)["EncourageBug"] = true;
-        addFunction(poke(b,s), "BasePowerModifier", "SheerForce", &bpm);
+        addFunction(poke(b,s), EffectHook::BasePowerModifier, "SheerForce", &bpm);
     }
 
     static void bpm(int s, int, BS &b) {
@@ -2136,7 +2138,7 @@ struct AMUnnerve : public AM {
             foreach (int p, tars) {
                 int item = b.poke(p).item();
                 if (ItemInfo::isBerry(item)) {
-                    ItemEffect::activate("UponReactivation", item, p, p, b);
+                    ItemEffect::activate(EffectHook::UponReactivation, item, p, p, b);
                 }
             }
         }
@@ -2174,13 +2176,13 @@ struct AMAura : public AM {
     }
 
     static void us(int s, int, BS &b) {
-        addFunction(b.battleMemory(), "BeforeTargetList", "Aura", &dgaf);
+        addFunction(b.battleMemory(), EffectHook::BeforeTargetList, "Aura", &dgaf);
         int type = poke(b,s)["AbilityArg"].toString().mid(5).toInt();
         b.sendAbMessage(103,0,s,0,type);
     }
 
     static void dgaf(int s, int, BS &b) {
-        addFunction(turn(b,s), "BeforeHitting", "Aura", &bh);
+        addFunction(turn(b,s), EffectHook::BeforeHitting, "Aura", &bh);
     }
 
     static void bh(int s, int, BS &b) {
@@ -2224,7 +2226,7 @@ struct AMVeil: public AM {
     }
 
     static void us(int, int, BS &b) {
-        addFunction(b.battleMemory(), "PreventStatChange", "Veil", &dgaf);
+        addFunction(b.battleMemory(), EffectHook::PreventStatChange, "Veil", &dgaf);
     }
 
     static void dgaf(int s, int t, BS &b) {
@@ -2391,7 +2393,7 @@ struct AMParentalBond : public AM
     static void ms(int s, int, BS &b) {
         /* We do it that way because parental bond still halves the second hit if hit
          * by Mummy. So we need a halving function that works even though ability is lost */
-        addFunction(turn(b,s), "BasePowerModifier", "ParentalBond", &btl);
+        addFunction(turn(b,s), EffectHook::BasePowerModifier, "ParentalBond", &btl);
     }
 
     static void btl(int s, int, BS &b) {
@@ -2470,7 +2472,7 @@ struct AMKlutz : public AM
 
     static void ol(int s, int, BS &b) {
         int item = b.poke(s).item();
-        ItemEffect::activate("UponReactivation", item, s, s, b);
+        ItemEffect::activate(EffectHook::UponReactivation, item, s, s, b);
     }
 };
 
@@ -2769,7 +2771,7 @@ struct AMWimpOut : public AMPinch /*Mostly copied from Eject Button */
         turn(b,s)["WimpedOut"] = true;
         turn(b,s)["WimpOutCount"] = slot(b,s)["SwitchCount"];
 
-        addFunction(turn(b,t), "AfterAttackFinished", "WimpOut", &aaf);
+        addFunction(turn(b,t), EffectHook::AfterAttackFinished, "WimpOut", &aaf);
     }
 
     static void asd(int s, int, BS &b) {
@@ -248,7 +248,7 @@ void BattleSituation::getVectorRef(priorityBracket b)
 
     if (i == endTurnEffects.size() || b < endTurnEffects[i]) {
         endTurnEffects.insert(i, b);
-        bracketToEffect[b] = QString("EndTurn%1.%2").arg(b.bracket).arg(b.priority);
+        bracketToEffect[b] = EffectHook::id(QString("EndTurn%1.%2").arg(b.bracket).arg(b.priority));
     }
 }
 
@@ -266,7 +266,7 @@ void BattleSituation::addEndTurnEffect(EffectType type, int bracket, int priorit
     getVectorRef(b);
     bracketType[b] = type;
 
-    QString effect = bracketToEffect[b];
+    int effect = bracketToEffect[b];
 
     if (f && !effectToBracket.contains(function)) {
         effectToBracket[function] = b;
@@ -310,7 +310,7 @@ void BattleSituation::addEndTurnEffect(EffectType type, int bracket, int priorit
 void BattleSituation::removeEndTurnEffect(EffectType type, int slot, const QString &function)
 {
     priorityBracket b = effectToBracket[function];
-    QString effect = bracketToEffect[b];
+    int effect = bracketToEffect[b];
 
     switch(type) {
     case PokeEffect:
@@ -396,7 +396,7 @@ void BattleSituation::endTurn()
             int flags = bracketType[b];
 
             if (flags == FieldEffect) {
-                QString effect = bracketToEffect[b];
+                int effect = bracketToEffect[b];
                 callbeffects(Player1, Player1, effect);
                 continue;
             }
@@ -419,7 +419,7 @@ void BattleSituation::endTurn()
             }
             for (int j = beginning; j <= i; j++) {
                 priorityBracket b = endTurnEffects[j];
-                QString effect = bracketToEffect[b];
+                int effect = bracketToEffect[b];
                 int flags = bracketType[b];
 
                 /* TODO: make a vector of function pointers with those in,
@@ -473,7 +473,7 @@ void BattleSituation::endTurn()
 
                     int flags = bracketType[b];
                     if (flags == ZoneEffect) {
-                        QString effect = bracketToEffect[b];
+                        int effect = bracketToEffect[b];
 
                         callzeffects(p, p, effect);
                     }
@@ -553,10 +553,15 @@ void BattleSituation::personalEndTurn(int player)
         return;
     endTurnPoison(player);
     endTurnBurn(player);
-    callpeffects(player, player, "EndTurn6.4");//leech seed
-    callpeffects(player, player, "EndTurn6.7");//nightmare
-    callpeffects(player, player, "EndTurn6.9");//curse
-    callpeffects(player, player, "EndTurn6.10");//bind
+    static const int leechSeed = EffectHook::id("EndTurn6.4");
+    static const int nightmare = EffectHook::id("EndTurn6.7");
+    static const int curse = EffectHook::id("EndTurn6.9");
+    static const int bind = EffectHook::id("EndTurn6.10");
+
+    callpeffects(player, player, leechSeed);
+    callpeffects(player, player, nightmare);
+    callpeffects(player, player, curse);
+    callpeffects(player, player, bind);
 
     testWin();
 }
@@ -581,7 +586,7 @@ void BattleSituation::endTurnPoison(int player)
             inflictDamage(player, poke(player).totalLifePoints() * (16 - poke(player).statusCount()) / 16, player);
             //poke(player).statusCount() = std::max(1, poke(player).statusCount() - 1); //Already being applied earlier.
         }
-        callaeffects(player, player, "AfterStatusDamage");
+        callaeffects(player, player, EffectHook::AfterStatusDamage);
     }
     /* Toxic still increases under magic guard, poison heal */
     if (poke(player).statusCount() != 0)
@@ -607,7 +612,7 @@ void BattleSituation::endTurnBurn(int player)
         denom *= 2;
     }
     inflictDamage(player, poke(player).totalLifePoints() / denom, player);
-    callaeffects(player, player, "AfterStatusDamage");
+    callaeffects(player, player, EffectHook::AfterStatusDamage);
 }
 
 BattleChoices BattleSituation::createChoice(int spot)
@@ -621,9 +626,9 @@ BattleChoices BattleSituation::createChoice(int spot)
     ret.numSlot = spot;
 
     /* attacks ok, lets see which ones then */
-    callpeffects(spot, spot, "MovesPossible");
-    callieffects(spot, spot, "MovesPossible");
-    callbeffects(spot, spot,"MovesPossible");
+    callpeffects(spot, spot, EffectHook::MovesPossible);
+    callieffects(spot, spot, EffectHook::MovesPossible);
+    callbeffects(spot, spot,EffectHook::MovesPossible);
 
     for (int i = 0; i < 4; i++) {
         if (!isMovePossible(spot,i)) {
@@ -663,7 +668,7 @@ BattleChoices BattleSituation::createChoice(int spot)
 
         QList<int> opps = revs(spot);
         foreach(int opp, opps){
-            callaeffects(opp, spot, "IsItTrapped");
+            callaeffects(opp, spot, EffectHook::IsItTrapped);
             if (turnMemory(spot).value("Trapped").toBool()) {
                 ret.switchAllowed = false;
                 break;
@@ -702,7 +707,7 @@ void BattleSituation::analyzeChoice(int slot)
     int player = this->player(slot);
 
     attackCount() += 1;
-    /* It's already verified that the choice is valid, by battleChoiceReceived, called in a different thread */
+    /* It's already verified that the choice is valid, by receiveChoice */
     if (choice(slot).attackingChoice()) {
         turnMemory(slot)["Target"] = choice(slot).target();
         if (!wasKoed(slot)) {
@@ -813,13 +818,13 @@ BattleSituation::priority_order BattleSituation::calculatePriorities(const std::
             if (gen() >= 5) {
                 /* Only run once */
                 if (!afterMegas) {
-                    calleffects(i, i, "PriorityChoice"); //Me First. Needs to go above effects
+                    calleffects(i, i, EffectHook::PriorityChoice); //Me First. Needs to go above effects
                 }
                 /* In gen 7, run this code when afterMegas is true for megas, and when it's false for others.
                 * So that we don't run PriorityChoice twice.
                 */
                 if (gen() <= 6 || (afterMegas == choice(i).mega())) {
-                    callaeffects(i, i, "PriorityChoice");
+                    callaeffects(i, i, EffectHook::PriorityChoice);
                 }
             }
             priorities[tmove(i).priority].push_back(i);
@@ -874,8 +879,8 @@ void BattleSituation::analyzeChoices()
         } else {
             /* Stall effects / abilities aren't affected by mega evolving, and are determined
              * once at the beginning of the turn */
-            callaeffects(spot, spot, "TurnOrder"); //Stall
-            callieffects(spot, spot, "TurnOrder"); //Lagging tail & ...
+            callaeffects(spot, spot, EffectHook::TurnOrder); //Stall
+            callieffects(spot, spot, EffectHook::TurnOrder); //Lagging tail & ...
         }
     }
 
@@ -1113,13 +1118,13 @@ void BattleSituation::sendPoke(int slot, int pok, bool silent)
        we need to remove this so that hazard kos can happen */
     turnMem(player).remove(TM::WasKoed);
 
-    calleffects(slot, slot, "UponSwitchIn");
-    callseffects(slot, slot, "UponSwitchIn");
-    callzeffects(player, slot, "UponSwitchIn");
+    calleffects(slot, slot, EffectHook::UponSwitchIn);
+    callseffects(slot, slot, EffectHook::UponSwitchIn);
+    callzeffects(player, slot, EffectHook::UponSwitchIn);
     if(turn() != 0) {
         QList<int> opps = revs(slot);
         foreach(int opp, opps){
-            callaeffects(opp, opp, "UponOpponentSwitchIn");
+            callaeffects(opp, opp, EffectHook::UponOpponentSwitchIn);
         }
     }
 }
@@ -1134,107 +1139,53 @@ void BattleSituation::callEntryEffects(int player)
 
            So All those must be taken in account when changing something to
            how the items are set up. */
-        callieffects(player, player, "UponSetup");
+        callieffects(player, player, EffectHook::UponSetup);
 
         if (gen() >= 3 && !turnMemory(player).contains("PrimalForme"))
             acquireAbility(player, poke(player).ability(), true);
-        calleffects(player, player, "AfterSwitchIn");
+        calleffects(player, player, EffectHook::AfterSwitchIn);
     }
 }
 
-void BattleSituation::calleffects(int source, int target, const QString &name)
+void BattleSituation::calleffects(int source, int target, int hook)
 {
     if (!isOut(source)) {
         return;
     }
-    context &turn = turnMemory(source);
-    if (turn.contains("Effect_" + name)) {
-        turn["TurnEffectCall"] = true;
-        turn["TurnEffectCalled"] = name;
-        QSet<QString> &effects = *turn.value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = turn.value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            if (f)
-                f(source, target, *this);
-        }
-        turn["TurnEffectCall"] = false;
-    }
+    Mechanics::callFunctions(turnMemory(source), hook, source, target, *this);
 }
 
-void BattleSituation::callpeffects(int source, int target, const QString &name)
+void BattleSituation::callpeffects(int source, int target, int hook)
 {
-    if (pokeMemory(source).contains("Effect_" + name)) {
-        turnMemory(source)["PokeEffectCall"] = true;
-        QSet<QString> &effects = *pokeMemory(source).value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = pokeMemory(source).value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            /* If a pokemons dies from leechseed,its status changes, and so nightmare function would be removed
-               but still be in the foreach, causing a crash */
-            if(f)
-                f(source, target, *this);
-        }
-        turnMemory(source)["PokeEffectCall"] = false;
-    }
+    Mechanics::callFunctions(pokeMemory(source), hook, source, target, *this);
 }
 
-void BattleSituation::callbeffects(int source, int target, const QString &name, bool stopOnFail)
+void BattleSituation::callbeffects(int source, int target, int hook, bool stopOnFail)
 {
-    if (battleMemory().contains("Effect_" + name)) {
-        QSet<QString> &effects = *battleMemory().value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = battleMemory().value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            if(f) f(source, target, *this);
-
-            if(stopOnFail && testFail(source)) return;
-        }
-    }
+    Mechanics::callFunctions(battleMemory(), hook, source, target, *this, stopOnFail);
 }
 
-void BattleSituation::callzeffects(int source, int target, const QString &name)
+void BattleSituation::callzeffects(int source, int target, int hook)
 {
-    if (teamMemory(source).contains("Effect_" + name)) {
-        QSet<QString> &effects = *teamMemory(source).value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = teamMemory(source).value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            if (f)
-                f(source, target, *this);
-        }
-    }
+    Mechanics::callFunctions(teamMemory(source), hook, source, target, *this);
 }
 
-void BattleSituation::callseffects(int source, int target, const QString &name)
+void BattleSituation::callseffects(int source, int target, int hook)
 {
-    if (slotMemory(source).contains("Effect_" + name)) {
-        QSet<QString> &effects = *slotMemory(source).value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = slotMemory(source).value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            if (f)
-                f(source, target, *this);
-        }
-    }
+    Mechanics::callFunctions(slotMemory(source), hook, source, target, *this);
 }
 
-void BattleSituation::callieffects(int source, int target, const QString &name)
+void BattleSituation::callieffects(int source, int target, int hook)
 {
     if (isOut(source) && hasWorkingItem(source, poke(source).item())) {
-        ItemEffect::activate(name, poke(source).item(), source, target, *this);
+        ItemEffect::activate(hook, poke(source).item(), source, target, *this);
     }
 }
 
-void BattleSituation::callaeffects(int source, int target, const QString &name)
+void BattleSituation::callaeffects(int source, int target, int hook)
 {
     if (gen() > 2 && isOut(source) && hasWorkingAbility(source, ability(source))) {
-        AbilityEffect::activate(name, ability(source), source, target, *this);
+        AbilityEffect::activate(hook, ability(source), source, target, *this);
     }
 }
 
@@ -1262,7 +1213,7 @@ void BattleSituation::sendBack(int player, bool silent)
                 analyzeChoice(opp);
 
                 if (koed(player)) {
-                    Mechanics::removeFunction(turnMemory(player),"UponSwitchIn","BatonPass");
+                    Mechanics::removeFunction(turnMemory(player),EffectHook::UponSwitchIn,"BatonPass");
                     //If a Pokemon is KOed with Pursuit when it is being sent back, we don't want to display the sending back message, so we override whatever was already defined.
                     silent = true;
                     break;
@@ -1289,7 +1240,7 @@ void BattleSituation::sendBack(int player, bool silent)
     BattleBase::sendBack(player, silent);
 
     if (!koed(player)) {
-        callaeffects(player,player,"UponSwitchOut");
+        callaeffects(player,player,EffectHook::UponSwitchOut);
         /* Natural cure bypasses gastro acid (tested in 4th gen, but not role play/skill swap),
            so we don't check if the ability is working, and just make a test
            directly. */
@@ -1306,8 +1257,8 @@ bool BattleSituation::testAccuracy(int player, int target, bool silent)
     bool multiTar = tarChoice != Move::ChosenTarget && tarChoice != Move::RandomTarget;
 
     turnMemory(target).remove("EvadeAttack");
-    callaeffects(player, target, "ActivateProtean");
-    callpeffects(target, player, "TestEvasion"); /*dig bounce  ... */
+    callaeffects(player, target, EffectHook::ActivateProtean);
+    callpeffects(target, player, EffectHook::TestEvasion); /*dig bounce  ... */
 
     if (locked(player, target)) {
         return true;
@@ -1332,7 +1283,7 @@ bool BattleSituation::testAccuracy(int player, int target, bool silent)
         return true;
     }
     /* Miracle skin can make some attacks miss */
-    callaeffects(target, player, "TestEvasion");
+    callaeffects(target, player, EffectHook::TestEvasion);
 
     if (turnMemory(target).contains("EvadeAttack")) {
         if (!silent) {
@@ -1364,14 +1315,14 @@ bool BattleSituation::testAccuracy(int player, int target, bool silent)
     turnMemory(target).remove("Stat7ItemModifier");
     turnMemory(target).remove("Stat7AbilityModifier");
     pokeMemory(player).remove("Stat6BerryModifier");
-    callieffects(player,target,"StatModifier");
-    callaeffects(player,target,"StatModifier");
-    callieffects(target,player,"StatModifier");
-    callaeffects(target,player,"StatModifier");
+    callieffects(player,target,EffectHook::StatModifier);
+    callaeffects(player,target,EffectHook::StatModifier);
+    callieffects(target,player,EffectHook::StatModifier);
+    callaeffects(target,player,EffectHook::StatModifier);
     if (multiples()) {
         for (int partner = 0; partner < numberOfSlots(); partner++) {
             if (partner != player && arePartners(partner, player) && !koed(partner))
-                callaeffects(partner, player, "PartnerStatModifier");
+                callaeffects(partner, player, EffectHook::PartnerStatModifier);
         }
     }
 
@@ -1391,7 +1342,7 @@ bool BattleSituation::testAccuracy(int player, int target, bool silent)
         if (!silent) {
             notifyMiss(multiTar, player, target);
         }
-        calleffects(player,target,"MissAttack");
+        calleffects(player,target,EffectHook::MissAttack);
         return false;
     }
 }
@@ -1522,7 +1473,7 @@ bool BattleSituation::testStatus(int player)
             if (coinflip(1, 2)) {
                 if (isDisguised(player)) {
                     notify(All, StatusMessage, player, qint8(HurtConfusion));
-                    callaeffects(player, player, "Disguise");
+                    callaeffects(player, player, EffectHook::Disguise);
                 } else {
                     inflictConfusedDamage(player);
                 }
@@ -1610,7 +1561,7 @@ void BattleSituation::testFlinch(int player, int target)
 }
 
 #define checkAttackFailed() if (testFail(player)) { \
-        calleffects(player,target,"AttackSomehowFailed"); \
+        calleffects(player,target,EffectHook::AttackSomehowFailed); \
         continue; \
     }
 
@@ -1663,25 +1614,25 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
         counters(player).decreaseCounters();
     }
 
-    calleffects(player,player,"EvenWhenCantMove");
+    calleffects(player,player,EffectHook::EvenWhenCantMove);
     if (gen() <= 6)
-        callaeffects(player,player,"EvenWhenCantMove");
+        callaeffects(player,player,EffectHook::EvenWhenCantMove);
 
     if (!testStatus(player)) {
         goto trueend;
     }
 
     //Just for truant
-    callaeffects(player, player, "DetermineAttackPossible");
+    callaeffects(player, player, EffectHook::DetermineAttackPossible);
     /*Normalize, Aerilate, etc. Needs to be higher than "MovesPossible" to allow proper interaction with Ion Deluge*/
-    callaeffects(player, player, "MoveSettings");
+    callaeffects(player, player, EffectHook::MoveSettings);
 
     if (!specialOccurence) {
         if (turnMemory(player).value("ImpossibleToMove").toBool() == true) {
             goto trueend;
         }
 
-        callpeffects(player, player, "DetermineAttackPossible");
+        callpeffects(player, player, EffectHook::DetermineAttackPossible);
         if (turnMemory(player).value("ImpossibleToMove").toBool() == true) {
             goto trueend;
         }
@@ -1699,7 +1650,7 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
         } else {
             sendItemMessage(68, player, 2, 0, 0, attack);
             //notify(All, UseAttack, player, qint16(attack), false, special); //TODO: Prepend "Z-" to the attack name
-            calleffects(player, player, "ZMove"); //Z Moves
+            calleffects(player, player, EffectHook::ZMove); //Z Moves
         }
     }
 
@@ -1707,12 +1658,12 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
 
     // Z-Moves ignore taunt, disable, etc.
     if (!specialOccurence && !zmoving) {
-        callbeffects(player,player,"MovePossible");
+        callbeffects(player,player,EffectHook::MovePossible);
         if (turnMemory(player)["ImpossibleToMove"].toBool()) {
             goto trueend;
         }
 
-        callpeffects(player, player, "MovePossible");
+        callpeffects(player, player, EffectHook::MovePossible);
         if (turnMemory(player).value("ImpossibleToMove").toBool()) {
             goto trueend;
         }
@@ -1720,7 +1671,7 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
 
     // Charge moves can be blocked on the second turn
     if (specialOccurence && pokeMemory(player)["ReleaseTurn"] == turn()) {
-        callpeffects(player, player, "MovePossible");
+        callpeffects(player, player, EffectHook::MovePossible);
         if (turnMemory(player).value("ImpossibleToMove").toBool()) {
             goto trueend;
         }
@@ -1728,7 +1679,7 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
 
     //Healing moves called with another move while under heal block are still blocked
     if (specialOccurence && pokeMemory(player).value("HealBlockCount").toInt() > 0) {
-        callpeffects(player, player, "MovePossible");
+        callpeffects(player, player, EffectHook::MovePossible);
         if (turnMemory(player).value("ImpossibleToMove").toBool()) {
             goto trueend;
         }
@@ -1790,7 +1741,7 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
         fpoke(player).lastMoveUsed = attack;
     }
 
-    calleffects(player, player, "MoveSettings");
+    calleffects(player, player, EffectHook::MoveSettings);
 
     //Sleep Talked moves should be tracked on tooltip. We use a new bool so PP isn't deducted from the tooltip.
     if (turnMemory(player).contains("SleepTalkedMove")) {
@@ -1799,7 +1750,7 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
     if (!zmovenotify) {
         notify(All, UseAttack, player, qint16(attack), !(tellPlayers && !turnMemory(player).contains("TellPlayers")), special);
     }
-    calleffects(player, player, "AfterTellingPlayers");
+    calleffects(player, player, EffectHook::AfterTellingPlayers);
 
     if (!specialOccurence) {
         if (turnMemory(player).value("PowderExploded").toBool()) {
@@ -1811,12 +1762,12 @@ void BattleSituation::useAttack(int player, int move, bool specialOccurence, boo
     }
 
     //Follow Me takes priority over abilities
-    callbeffects(player,player, "GeneralTargetChange");
+    callbeffects(player,player, EffectHook::GeneralTargetChange);
 
     /* Lightning Rod & Storm Drain */
     foreach(int poke, sortedBySpeed()) {
         if (poke != player) {
-            callaeffects(poke, player, "GeneralTargetChange");
+            callaeffects(poke, player, EffectHook::GeneralTargetChange);
         }
     }
 
@@ -1849,7 +1800,7 @@ ppfunction:
     }
 
     /* Choice items act before target selection if no target in gen 5 */
-    callieffects(player, player, "BeforeTargetList");
+    callieffects(player, player, EffectHook::BeforeTargetList);
 
     if (targetList.size() == 0) {
         notify(All, NoOpponent, player);
@@ -1858,8 +1809,8 @@ ppfunction:
 
     turnMem(player).remove(TM::Failed);
 
-    calleffects(player, player, "BeforeTargetList");
-    callaeffects(player, player, "BeforeTargetList");
+    calleffects(player, player, EffectHook::BeforeTargetList);
+    callaeffects(player, player, EffectHook::BeforeTargetList);
 
     /* Choice item memory, copycat in gen 4 and less */
     if (!specialOccurence && attack != Move::Struggle) {
@@ -1867,7 +1818,7 @@ ppfunction:
     }
 
     /* Aura abilities, Snatch */
-    callbeffects(player, player, "BeforeTargetList", true);
+    callbeffects(player, player, EffectHook::BeforeTargetList, true);
     if (turnMem(player).failed()) {
         goto trueend;
     }
@@ -1891,28 +1842,28 @@ ppfunction:
             continue;
         }
         if (target != player && !testAccuracy(player, target)) {
-            calleffects(player,target,"AttackSomehowFailed");
+            calleffects(player,target,EffectHook::AttackSomehowFailed);
             continue;
         }
 
         /* Pollen Puff */
-        calleffects(player, target, "MoveClassModifier");
+        calleffects(player, target, EffectHook::MoveClassModifier);
 
         if (tmove(player).power > 0)
         {
             calculateTypeModStab();
 
-            calleffects(player, target, "BeforeCalculatingDamage");
+            calleffects(player, target, EffectHook::BeforeCalculatingDamage);
             /* For Focus Punch*/
             if (turnMemory(player).contains("LostFocus")) {
-                calleffects(player,target,"AttackSomehowFailed");
+                calleffects(player,target,EffectHook::AttackSomehowFailed);
                 continue;
             }
 
             /* King's Shield*/
             /* also abilities are called before type mods */
             if (gen() >= 7) {
-                calleffects(target, player, "DetermineProtectedAgainstAttackKS");
+                calleffects(target, player, EffectHook::DetermineProtectedAgainstAttackKS);
                 checkAttackFailed();
             }
 
@@ -1920,7 +1871,7 @@ ppfunction:
             if (typemod < -50) {
                 /* If it's ineffective we just say it */
                 notify(All, Effective, target, quint8(0));
-                calleffects(player,target,"AttackSomehowFailed");
+                calleffects(player,target,EffectHook::AttackSomehowFailed);
                 continue;
             }
 
@@ -1935,26 +1886,26 @@ ppfunction:
                 continue;
             }
 
-            callpeffects(player, target, "DetermineAttackFailure");
+            callpeffects(player, target, EffectHook::DetermineAttackFailure);
             checkAttackFailed();
-            calleffects(player, target, "DetermineAttackFailure");
+            calleffects(player, target, EffectHook::DetermineAttackFailure);
             checkAttackFailed();
 
             /* Protean is supposed to change type even if move is protected against -- bulbapedia */
-            callaeffects(player, target, "ActivateProtean");
+            callaeffects(player, target, EffectHook::ActivateProtean);
 
             //Moved after failure check to allow Sucker punch to work correctly.
             /* In gen 6, this check is after the "no effect" check. Since king's shield
              * on aegislash on a physical normal/fighting/poison attack doesn't reduce the opponent's
              * attack by two stages. Gen 7 reverses this so we "reintroduce the bug" and move this block of code higher again*/
             if (gen() < 7) {
-                calleffects(target, player, "DetermineProtectedAgainstAttackKS");
+                calleffects(target, player, EffectHook::DetermineProtectedAgainstAttackKS);
                 checkAttackFailed();
             }
             /* Protect, ... */
-            calleffects(target, player, "DetermineProtectedAgainstAttack");
+            calleffects(target, player, EffectHook::DetermineProtectedAgainstAttack);
             checkAttackFailed();
-            callzeffects(this->player(target), player, "DetermineProtectedAgainstAttack");
+            callzeffects(this->player(target), player, EffectHook::DetermineProtectedAgainstAttack);
             checkAttackFailed();
 
             if (oppBlockFailure(target, player)) {
@@ -1994,7 +1945,7 @@ ppfunction:
                 }
 
                 if (tmove(player).power > 1 || tmove(player).attack == Move::GyroBall) {
-                    calleffects(player, target, "BeforeHitting");
+                    calleffects(player, target, EffectHook::BeforeHitting);
                     if (turnMemory(player).contains("HitCancelled")) {
                         turnMemory(player).remove("HitCancelled");
                         continue;
@@ -2005,25 +1956,25 @@ ppfunction:
                         inflictDamage(target, damage, player, true);
                     } else {
                         // Contact effects and Life Orb still work when Disguise is up
-                        callieffects(player, target, "UponHittingDisguise");
+                        callieffects(player, target, EffectHook::UponHittingDisguise);
                         if (makesContact(player)) {
-                            callieffects(target, player, "UponPhysicalAssault");
+                            callieffects(target, player, EffectHook::UponPhysicalAssault);
                         }
                     }
                     hitcount += 1;
                     hitting = true;
                 } else {
                     turnMemory(player).remove("CustomDamage");
-                    calleffects(player, target, "CustomAttackingDamage");
+                    calleffects(player, target, EffectHook::CustomAttackingDamage);
 
                     if (turnMemory(player).contains("CustomDamage")) {
                         if (!noDamage) {
                             int damage = turnMemory(player).value("CustomDamage").toInt();
                             inflictDamage(target, damage, player, true);
                         } else {
-                            callieffects(player, target, "UponHittingDisguise");
+                            callieffects(player, target, EffectHook::UponHittingDisguise);
                             if (makesContact(player) && tmove(player).type != Type::Curse) {
-                                callieffects(target, player, "UponPhysicalAssault");
+                                callieffects(target, player, EffectHook::UponPhysicalAssault);
                             }
                         }
                         hitcount += 1;
@@ -2031,29 +1982,29 @@ ppfunction:
                     }
                 }
 
-                calleffects(player, target, "UponAttackSuccessful");
+                calleffects(player, target, EffectHook::UponAttackSuccessful);
                 if (!sub)
-                    calleffects(player, target, "OnFoeOnAttack");
+                    calleffects(player, target, EffectHook::OnFoeOnAttack);
 
                 healDamage(player, target);
 
                 //heatOfAttack() = false;
                 if (hitting) {
-                    callieffects(target, player, "UponBeingHit");
+                    callieffects(target, player, EffectHook::UponBeingHit);
                     if (!sub) {
-                        callaeffects(target, player, "UponBeingHit");
-                        callaeffects(player, target, "OnHitting");
+                        callaeffects(target, player, EffectHook::UponBeingHit);
+                        callaeffects(player, target, EffectHook::OnHitting);
                     }
-                    callaeffects(target, player, "UponOffensiveDamageReceived");
+                    callaeffects(target, player, EffectHook::UponOffensiveDamageReceived);
                     /*Absorb Bulb should be after abilities*/
-                    callieffects(target, player, "UponBeingHit2");
+                    callieffects(target, player, EffectHook::UponBeingHit2);
                     /*This allows Knock off to work*/
-                    calleffects(player, target, "KnockOff");
-                    callieffects(target, player, "AfterKnockOff");
+                    calleffects(player, target, EffectHook::KnockOff);
+                    callieffects(target, player, EffectHook::AfterKnockOff);
                 }
 
                 if (koed(target))
-                    callaeffects(player, target, "AfterKoing");
+                    callaeffects(player, target, EffectHook::AfterKoing);
 
                 /* Secondary effect of an attack: like ancient power, acid, thunderbolt, ... */
                 /* In Gen 2, KOing a pokemon won't provide any beneficial boosts*/
@@ -2062,8 +2013,8 @@ ppfunction:
                 }
 
                 /* For berries that activate after taking damage */
-                callaeffects(target, target, "TestPinch");
-                callieffects(target, target, "TestPinch");
+                callaeffects(target, target, EffectHook::TestPinch);
+                callieffects(target, target, EffectHook::TestPinch);
 
                 if (!sub && !koed(target)) testFlinch(player, target);
 
@@ -2081,8 +2032,8 @@ ppfunction:
             }
 
             if (gen() >= 5 && !koed(target) && !sub) {
-                callaeffects(target, player, "AfterBeingPlumetted");
-                calleffects(target, player, "AfterBeingPlummeted");
+                callaeffects(target, player, EffectHook::AfterBeingPlumetted);
+                calleffects(target, player, EffectHook::AfterBeingPlummeted);
             }
 
             if (gen() <= 4 && koed(target)) {
@@ -2090,22 +2041,22 @@ ppfunction:
             }
 
             if (!koed(player)) {
-                callieffects(player, target, "AfterAttackSuccessful");
-                calleffects(player, target, "AfterAttackSuccessful");
+                callieffects(player, target, EffectHook::AfterAttackSuccessful);
+                calleffects(player, target, EffectHook::AfterAttackSuccessful);
             }
 
             fpoke(target).remove(BasicPokeInfo::HadSubstitute);
         } else {
             /* Protect, ... */
             if (target != player) {
-                calleffects(target, player, "DetermineProtectedAgainstAttack");
+                calleffects(target, player, EffectHook::DetermineProtectedAgainstAttack);
                 checkAttackFailed();
-                callzeffects(this->player(target), player, "DetermineProtectedAgainstAttack");
+                callzeffects(this->player(target), player, EffectHook::DetermineProtectedAgainstAttack);
                 checkAttackFailed();
             }
 
             /* Magic Coat, Magic Bounce */
-            callbeffects(player, target, "DetermineGeneralAttackFailure2", true);
+            callbeffects(player, target, EffectHook::DetermineGeneralAttackFailure2, true);
             checkAttackFailed();
 
             /* Abilities have priority over type mods in gen 7 */
@@ -2131,14 +2082,14 @@ ppfunction:
                 notify(All, Failed, player);
                 continue;
             }
-            callpeffects(player, target, "DetermineAttackFailure");
+            callpeffects(player, target, EffectHook::DetermineAttackFailure);
             if (testFail(player)) continue;
 
             //Type changing moves activate protean. We force it to check here so the actual move can fail if needed.
             if (attack == Move::Camouflage || attack == Move::Conversion || attack == Move::Conversion2) {
-                callaeffects(player, target, "ActivateProtean");
+                callaeffects(player, target, EffectHook::ActivateProtean);
             }
-            calleffects(player, target, "DetermineAttackFailure");
+            calleffects(player, target, EffectHook::DetermineAttackFailure);
             if (testFail(player)) continue;
 
             if (target != player && hasSubstitute(target) && !canBypassSub(player)) {
@@ -2146,20 +2097,20 @@ ppfunction:
                 continue;
             }
 
-            calleffects(player, target, "BeforeHitting");
-            callaeffects(player, target, "ActivateProtean");
+            calleffects(player, target, EffectHook::BeforeHitting);
+            callaeffects(player, target, EffectHook::ActivateProtean);
 
             applyMoveStatMods(player, target);
-            calleffects(player, target, "UponAttackSuccessful");
+            calleffects(player, target, EffectHook::UponAttackSuccessful);
             /* Side change may switch player & target */
             if (attacker() != player) {
                 player = attacker();
                 target = attacked();
             }
-            calleffects(player, target, "OnFoeOnAttack");
+            calleffects(player, target, EffectHook::OnFoeOnAttack);
             healDamage(player, target);
 
-            calleffects(player, target, "AfterAttackSuccessful");
+            calleffects(player, target, EffectHook::AfterAttackSuccessful);
         }
         //Will-O-Wisp shouldn't thaw target. Scald thaws target in Gen 6. Hidden Power doesn't thaw before Gen 4
         if (poke(target).status() == Pokemon::Frozen) {
@@ -2171,7 +2122,7 @@ ppfunction:
     }
 end:
     /* In gen 4, choice items are there - they lock even if the move had no target possible.  */
-    callieffects(player, player, "AfterTargetList");
+    callieffects(player, player, EffectHook::AfterTargetList);
 trueend:
     heatOfAttack() = false;
 
@@ -2183,15 +2134,15 @@ trueend:
     attacked() = oldAttacked;
 
     /* For U-TURN, so that none of the variables of the switchin are afflicted, it's put at the utmost end */
-    calleffects(player, player, "AfterAttackFinished");
+    calleffects(player, player, EffectHook::AfterAttackFinished);
     foreach(int target, targetList) {
-        callaeffects(target, target, "AfterAttackFinished"); //Immunity & such
+        callaeffects(target, target, EffectHook::AfterAttackFinished); //Immunity & such
         turnMemory(target)["HadSubstitute"] = false;
     }
     if (!special) {
         foreach(int target, sortedBySpeed()) {
             if (target != player) {
-                callaeffects(target, target, "DanceInvite");
+                callaeffects(target, target, EffectHook::DanceInvite);
             }
         }
     }
@@ -2342,7 +2293,7 @@ void BattleSituation::useItem(int player, int item, int target, int attack)
         QVariant tempItemStorage = pokeMemory(player).take("ItemArg");
 
         ItemEffect::setup(item, player, *this);
-        ItemEffect::activate("TrainerItem", item, player, target, *this);
+        ItemEffect::activate(EffectHook::TrainerItem, item, player, target, *this);
 
         /* Restoring initial conditions */
         pokeMemory(player)["ItemArg"] = tempItemStorage;
@@ -2505,7 +2456,7 @@ void BattleSituation::acquireAbility(int play, int ab, bool firstTime) {
 
 void BattleSituation::loseAbility(int slot)
 {
-    callaeffects(slot, slot, "OnLoss");
+    callaeffects(slot, slot, EffectHook::OnLoss);
 }
 
 int BattleSituation::ability(int player) const {
@@ -2698,11 +2649,11 @@ void BattleSituation::applyMoveStatMods(int player, int target)
     }
 
     if (statChange == true) {
-        callieffects(target, player, "AfterStatChange");
-        callaeffects(target, player, "AfterStatChange");
+        callieffects(target, player, EffectHook::AfterStatChange);
+        callaeffects(target, player, EffectHook::AfterStatChange);
         //Done Elsewhere
         /*if (target != player && negativeStatChange && gen() >= 5) {
-            callaeffects(target, player, "AfterNegativeStatChange");
+            callaeffects(target, player, EffectHook::AfterNegativeStatChange);
         }*/
     }
 
@@ -2870,11 +2821,11 @@ bool BattleSituation::loseStatMod(int player, int stat, int malus, int attacker,
         turnMemory(player)["StatModType"] = QString("Stat");
         turnMemory(player)["StatModded"] = stat;
         turnMemory(player)["StatModification"] = -malus;
-        callaeffects(player, attacker, "PreventStatChange");
+        callaeffects(player, attacker, EffectHook::PreventStatChange);
         if (turnMemory(player).contains(q)) {
             return false;
         }
-        callbeffects(player, attacker, "PreventStatChange");
+        callbeffects(player, attacker, EffectHook::PreventStatChange);
         if (turnMemory(player).contains(q)) {
             return false;
         }
@@ -2893,11 +2844,11 @@ bool BattleSituation::loseStatMod(int player, int stat, int malus, int attacker,
         changeStatMod(player, stat, std::max(boost-malus, -6));
 
         if (!applyingMoveStatMods) {
-            callieffects(player, attacker, "AfterStatChange");
-            callaeffects(player, attacker, "AfterStatChange");
+            callieffects(player, attacker, EffectHook::AfterStatChange);
+            callaeffects(player, attacker, EffectHook::AfterStatChange);
         }
         if (player != attacker) {
-            callaeffects(player, attacker, "AfterNegativeStatChange");
+            callaeffects(player, attacker, EffectHook::AfterNegativeStatChange);
         }
     } else {
         notify(All, CappedStat, player, qint8(stat), false);
@@ -2931,7 +2882,7 @@ void BattleSituation::inflictStatus(int player, int status, int attacker, int mi
         turnMemory(player).remove(q);
         turnMemory(player)["StatModType"] = QString("Status");
         turnMemory(player)["StatusInflicted"] = status;
-        callaeffects(player, attacker, "PreventStatChange");
+        callaeffects(player, attacker, EffectHook::PreventStatChange);
         if (turnMemory(player).contains(q)) {
             return;
         }
@@ -3006,7 +2957,7 @@ void BattleSituation::inflictConfused(int player, int attacker, bool tell)
         turnMemory(player).remove(q);
         turnMemory(player)["StatModType"] = QString("Status");
         turnMemory(player)["StatusInflicted"] = Pokemon::Confused;
-        callaeffects(player, attacker, "PreventStatChange");
+        callaeffects(player, attacker, EffectHook::PreventStatChange);
         if (turnMemory(player).contains(q)) {
             return;
         }
@@ -3029,7 +2980,7 @@ void BattleSituation::inflictConfused(int player, int attacker, bool tell)
 
     notify(All, StatusChange, player, qint8(Pokemon::Confused), true, !tell);
 
-    callieffects(player, player,"AfterStatusChange");
+    callieffects(player, player,EffectHook::AfterStatusChange);
 }
 
 void BattleSituation::callForth(int weather, int turns)
@@ -3038,7 +2989,7 @@ void BattleSituation::callForth(int weather, int turns)
     if (weather != this->weather) {
         this->weather = weather;
         foreach (int i, sortedBySpeed()) {
-            callaeffects(i,i,"WeatherChange");
+            callaeffects(i,i,EffectHook::WeatherChange);
         }
     }
 }
@@ -3049,7 +3000,7 @@ void BattleSituation::coverField(int terrain, int turns)
     if (terrain != this->terrain) {
         this->terrain = terrain;
         foreach (int i, sortedBySpeed()) {
-            callieffects(i,i,"TerrainChange");
+            callieffects(i,i,EffectHook::TerrainChange);
         }
     }
 }
@@ -3078,8 +3029,8 @@ void BattleSituation::endTurnWeather()
                 immuneTypes << Pokemon::Rock << Pokemon::Ground << Pokemon::Steel;
             }
             foreach (int i, sortedBySpeed()) {
-                callaeffects(i,i,"WeatherSpecial");
-                callieffects(i,i,"WeatherSpecial");
+                callaeffects(i,i,EffectHook::WeatherSpecial);
+                callieffects(i,i,EffectHook::WeatherSpecial);
                 if (!turnMemory(i).contains("WeatherSpecialed") && (weather == Hail || weather == SandStorm) && getTypes(i).toList().toSet().intersect(immuneTypes).isEmpty()
                         && !hasWorkingAbility(i, Ability::MagicGuard)) {
                     notify(All, WeatherMessage, i, qint8(HurtWeather),qint8(weather));
@@ -3344,8 +3295,8 @@ void BattleSituation::changeStatus(int player, int status, bool tell, int turns)
     else {
         poke(player).statusCount() = 0;
     }
-    callpeffects(player, player,"AfterStatusChange");
-    callieffects(player, player,"AfterStatusChange");
+    callpeffects(player, player,EffectHook::AfterStatusChange);
+    callieffects(player, player,EffectHook::AfterStatusChange);
 }
 
 bool BattleSituation::hasMinimalStatMod(int player, int stat)
@@ -3366,7 +3317,7 @@ void BattleSituation::preventStatMod(int player, int attacker)
 
 void BattleSituation::debug(const QString &message)
 {
-    battleChat(conf.ids[0], message);
+    notify(All, BattleChat, Player1, message);
 }
 
 bool BattleSituation::canSendPreventMessage(int defender, int attacker) {
@@ -3450,7 +3401,7 @@ int BattleSituation::calculateDamage(int p, int t)
         randnum = 100;
     }
     if (gen().num == 2) {
-        calleffects(p, t, "DamageFormulaStart");
+        calleffects(p, t, EffectHook::DamageFormulaStart);
 
         QString qA, qD;
         if (cat == Move::Physical) {
@@ -3506,8 +3457,8 @@ int BattleSituation::calculateDamage(int p, int t)
             def *= 2;
         }
 
-        callieffects(p, p, "StatModifier");
-        callieffects(t, t, "StatModifier");
+        callieffects(p, p, EffectHook::StatModifier);
+        callieffects(t, t, EffectHook::StatModifier);
 
         // Thick Club and Light Ball
         attack = attack * (20 + turnMemory(p).value(qA+"ItemModifier").toInt()) / 20;
@@ -3547,8 +3498,8 @@ int BattleSituation::calculateDamage(int p, int t)
             }
         }
 
-        calleffects(p, t, "BasePowerModifier");
-        callieffects(p, t, "BasePowerModifier");
+        calleffects(p, t, EffectHook::BasePowerModifier);
+        callieffects(p, t, EffectHook::BasePowerModifier);
 
         int power = tmove(p).power;
         int type = tmove(p).type;
@@ -3580,7 +3531,7 @@ int BattleSituation::calculateDamage(int p, int t)
             damage *= 2;
         }
 
-        callieffects(p, t, "Mod2Modifier");
+        callieffects(p, t, EffectHook::Mod2Modifier);
         damage = damage * (turnMemory(p).value("ItemMod2Modifier").toInt() + 10) / 10; // item boosts for damage
         turnMemory(p).remove("ItemMod2Modifier");
 
@@ -3637,9 +3588,9 @@ int BattleSituation::calculateDamage(int p, int t)
     }
 
     /*This stuff is the same between gens 3, 4, and 5+ */
-    callaeffects(p,t,"DamageFormulaStart");
-    callaeffects(t,p,"FoeDamageFormulaStart");
-    calleffects(p,t,"DamageFormulaStart");
+    callaeffects(p,t,EffectHook::DamageFormulaStart);
+    callaeffects(t,p,EffectHook::FoeDamageFormulaStart);
+    calleffects(p,t,EffectHook::DamageFormulaStart);
 
     context &move = turnMemory(p);
     if (cat == Move::Physical) {
@@ -3684,15 +3635,15 @@ int BattleSituation::calculateDamage(int p, int t)
         }
 
         /* Move *///Moves: Facade, Brine
-        calleffects(p,t,"BasePowerModifier");
+        calleffects(p,t,EffectHook::BasePowerModifier);
         power = floorMod(power);
 
         /* Item *///Items: Muscle Band, Wise Glasses, Type boosting items, Adamant/Lustrous/Griseous Orb
-        callieffects(p,t,"BasePowerModifier");
+        callieffects(p,t,EffectHook::BasePowerModifier);
         power = floorMod(power);
 
         /* Charge */// Can't be called via ChainBP else it will be out of order
-        callpeffects(p, t, "BasePowerModifier");
+        callpeffects(p, t, EffectHook::BasePowerModifier);
         if (move.contains("Charged")) {
             power *= 2;
         }
@@ -3704,11 +3655,11 @@ int BattleSituation::calculateDamage(int p, int t)
         }
 
         /* User Ability *///Abilities: Rivalry, Reckless, Iron Fist, Blaze/et al., Technician
-        callaeffects(p,t,"BasePowerModifier");
+        callaeffects(p,t,EffectHook::BasePowerModifier);
         power = floorMod(power);
 
         /* Foe Ability *///Foe Abilities: Thick Fat, Heatproof, Dry Skin
-        callaeffects(t,p,"BasePowerFoeModifier");
+        callaeffects(t,p,EffectHook::BasePowerFoeModifier);
         power = floorMod(power);
 
         int damage;
@@ -3774,7 +3725,7 @@ int BattleSituation::calculateDamage(int p, int t)
         /*** MOD 2 ***/ //Aka: Gen 4
         /* Life Orb, Metronome */
         move.remove("ItemMod2Modifier");
-        callieffects(p,t,"Mod2Modifier");
+        callieffects(p,t,EffectHook::Mod2Modifier);
         int itemmod = move["ItemMod2Modifier"].toInt();
         if (itemmod != 0) {
             damage = damage * (20 + itemmod) / 20;
@@ -3818,7 +3769,7 @@ int BattleSituation::calculateDamage(int p, int t)
         }
         /* Damage reducing Berries */
         move.remove("Mod3Berry");
-        callieffects(t, p, "Mod3Items");
+        callieffects(t, p, EffectHook::Mod3Items);
         int berrymod = turnMemory(p).value("Mod3Berry").toInt();
         if (berrymod != 0) {
             damage = damage * (20 + berrymod) / 20;
@@ -3848,8 +3799,8 @@ int BattleSituation::calculateDamage(int p, int t)
         /* The peculiar order here is caused by the fact that helping hand applies before item boosts,
           but item boosts are decided (not applied) before acrobat, and acrobat needs to modify
           move power (not just power variable) because of technician which relies on it */
-        calleffects(p,t,"BasePowerModifier");
-        callieffects(p,t,"BasePowerModifier");
+        calleffects(p,t,EffectHook::BasePowerModifier);
+        callieffects(p,t,EffectHook::BasePowerModifier);
         /* Gems */
         if (turnMemory(p).value("GemActivated").toBool()) {
             gen() < 6 ? chainBp(p, 0x1800) : chainBp(p, 0x14CD);
@@ -3859,8 +3810,8 @@ int BattleSituation::calculateDamage(int p, int t)
             tmove(p).power *= 2;
         }
         int power = tmove(p).power;
-        callaeffects(p,t,"BasePowerModifier");
-        callaeffects(t,p,"BasePowerFoeModifier");
+        callaeffects(p,t,EffectHook::BasePowerModifier);
+        callaeffects(t,p,EffectHook::BasePowerFoeModifier);
 
         /* Helping Hand */
         if (move.contains("HelpingHanded")) {
@@ -3884,7 +3835,7 @@ int BattleSituation::calculateDamage(int p, int t)
          * Item: Adamant Orb, Grseous Orb, Lustrous Orb, Type boosting items
          * Move: Knock Off, Brine, Me First, Charge, Solarbeam, SmellingSalts/Venoshock, Retaliate, Facade
          */
-        callpeffects(p, t, "BasePowerModifier"); //for charge
+        callpeffects(p, t, EffectHook::BasePowerModifier); //for charge
         chainedMods = 0x1000;
         for (int i = 0; i < bpmodifiers.size(); i++) {
             chainedMods = chainMod(chainedMods, bpmodifiers[i]);
@@ -4020,14 +3971,14 @@ int BattleSituation::calculateDamage(int p, int t)
         }
         /* Metronome, Life Orb */
         move.remove("ItemMod2Modifier");
-        callieffects(p,t,"Mod2Modifier");
+        callieffects(p,t,EffectHook::Mod2Modifier);
         int itemmod = move["ItemMod2Modifier"].toInt();
         if (itemmod != 0) {
             finalmod = chainMod(finalmod, itemmod);
         }
         /* Damage reducing Berries */
         move.remove("Mod3Berry");
-        callieffects(t, p, "Mod3Items");
+        callieffects(t, p, EffectHook::Mod3Items);
         int berrymod = turnMemory(p).value("Mod3Berry").toInt();
         if (berrymod != 0) {
             finalmod = chainMod(finalmod, berrymod);
@@ -4106,8 +4057,8 @@ void BattleSituation::inflictDamage(int player, int damage, int source, bool str
 
     if (straightattack && player != source) {
         //Sturdy in gen 5
-        callaeffects(player, source, "BeforeTakingDamage");
-        callieffects(player, source, "BeforeTakingDamage");
+        callaeffects(player, source, EffectHook::BeforeTakingDamage);
+        callieffects(player, source, EffectHook::BeforeTakingDamage);
     }
 
     //Damage can only be 0 if there is a final modifier in play. So like gen 5+
@@ -4146,27 +4097,27 @@ void BattleSituation::inflictDamage(int player, int damage, int source, bool str
             if (survivalFactor) {
                 //Sturdy
                 if (turnMemory(player).contains("CannotBeKoedAt") && turnMemory(player)["CannotBeKoedAt"].toInt() == attackCount())
-                    callaeffects(player, source, "UponSelfSurvival");
+                    callaeffects(player, source, EffectHook::UponSelfSurvival);
 
                 if (turnMemory(player).contains("SurviveReason"))
                     goto end;
 
                 //False Swipe/Hold Back
                 if (turnMemory(player).contains("CannotBeKoedBy") && turnMemory(player)["CannotBeKoedBy"].toInt() == source)
-                    calleffects(player, source, "UponSelfSurvival");
+                    calleffects(player, source, EffectHook::UponSelfSurvival);
 
                 if (turnMemory(player).contains("SurviveReason"))
                     goto end;
 
                 //Endure
                 if (turnMemory(player).value("CannotBeKoed").toBool() && source != player)
-                    calleffects(player, source, "UponSelfSurvival");
+                    calleffects(player, source, EffectHook::UponSelfSurvival);
 
                 if (turnMemory(player).contains("SurviveReason"))
                     goto end;
 
                 //Focus Items
-                callieffects(player, source, "UponSelfSurvival");
+                callieffects(player, source, EffectHook::UponSelfSurvival);
 
 end:
                 turnMemory(player).remove("SurviveReason");
@@ -4197,20 +4148,20 @@ end:
 
         if (straightattack) {
             if (player != source && !sub) {
-                callpeffects(player, source, "UponOffensiveDamageReceived");
-                callieffects(player, source, "UponOffensiveDamageReceived");
+                callpeffects(player, source, EffectHook::UponOffensiveDamageReceived);
+                callieffects(player, source, EffectHook::UponOffensiveDamageReceived);
             }
 
             if (makesContact(source) && player != source) {
                 if (!sub) {
-                    callieffects(player, source, "UponPhysicalAssault");
-                    callaeffects(player,source,"UponPhysicalAssault");
-                    calleffects(player, source, "UponPhysicalAssault");
+                    callieffects(player, source, EffectHook::UponPhysicalAssault);
+                    callaeffects(player,source,EffectHook::UponPhysicalAssault);
+                    calleffects(player, source, EffectHook::UponPhysicalAssault);
                     if (pokeMemory(player).value("HotBeak").toBool()) {
                         inflictStatus(source, Pokemon::Burnt, player);
                     }
                 }
-                callaeffects(source,player,"OnPhysicalAssault");
+                callaeffects(source,player,EffectHook::OnPhysicalAssault);
             }
         }
 
@@ -4235,15 +4186,15 @@ end:
             if(tmove(source).recoil < 0) {
                 inflictRecoil(source, player);
             }
-            callieffects(source,player, "UponDamageInflicted");
-            calleffects(source, player, "UponDamageInflicted");
+            callieffects(source,player, EffectHook::UponDamageInflicted);
+            calleffects(source, player, EffectHook::UponDamageInflicted);
         }
         if (!sub) {
-            calleffects(player, source, "UponOffensiveDamageReceived");
+            calleffects(player, source, EffectHook::UponOffensiveDamageReceived);
 
             // Otherwise Stamina boosts twice and this is only for Berserk anyway
             if (pokeMemory(source).value("Berserked").toBool() == true) {
-                callaeffects(player, source, "UponOffensiveDamageReceived");
+                callaeffects(player, source, EffectHook::UponOffensiveDamageReceived);
             }        }
     }
 
@@ -4332,7 +4283,12 @@ void BattleSituation::devourBerry(int p, int berry, int s)
         if (!ItemEffect::mechanics.contains(e.num)) {
             continue;
         }
-        foreach (Mechanics::function f, ItemEffect::mechanics[e.num].functions) {
+        const ItemMechanics &m = ItemEffect::mechanics[e.num];
+        for (int hook = 0; hook < m.functions.size(); hook++) {
+            Mechanics::function f = m.functions.value(hook);
+            if (!f) {
+                continue;
+            }
             //Some berries have 2 functions for pinch testing... so quitting after one used up the berry
             if (poke(s).item() == 0) {
                 break;
@@ -4366,7 +4322,7 @@ void BattleSituation::acqItem(int player, int item) {
 
     if (slotNum(player) < numberPerSide()) {
         ItemEffect::setup(poke(player).item(),player,*this);
-        callieffects(player, player, "UponSetup");
+        callieffects(player, player, EffectHook::UponSetup);
     }
 }
 
@@ -4426,7 +4382,7 @@ bool BattleSituation::canLoseItem(int player, int attacker)
 
 void BattleSituation::loseItem(int player, bool real)
 {
-    callieffects(player, player, "UponLoseItem");
+    callieffects(player, player, EffectHook::UponLoseItem);
     poke(player).item() = 0;
     notify(this->player(player), ChangeTempPoke, player, quint8(TempItem), quint8(slotNum(player)), 0);
     if (real && slotNum(player) < numberPerSide() && hasWorkingAbility(player, Ability::Unburden)) {
@@ -4541,8 +4497,8 @@ void BattleSituation::changeHp(int player, int newHp)
         return;
     }
 
-    callieffects(player, player, "AfterHPChange");
-    callaeffects(player, player, "AfterHPChange");
+    callieffects(player, player, EffectHook::AfterHPChange);
+    callaeffects(player, player, EffectHook::AfterHPChange);
 }
 
 void BattleSituation::koPoke(int player, int source, bool straightattack)
@@ -4569,23 +4525,23 @@ void BattleSituation::koPoke(int player, int source, bool straightattack)
             continue;
         }
         if (arePartners(player, i)) {
-            callaeffects(i, player, "OnPartnerKO"); //receiver, soul heart
+            callaeffects(i, player, EffectHook::OnPartnerKO); //receiver, soul heart
         } else {
-            callaeffects(i, player, "OnOpponentKO"); //soul heart
+            callaeffects(i, player, EffectHook::OnOpponentKO); //soul heart
         }
     }
     //useful for third gen
     turnMem(player).add(TM::WasKoed);
 
     if (straightattack && player!=source) {
-        callpeffects(player, source, "AfterKoedByStraightAttack");
-        callaeffects(player, source, "AfterBeingKoed");
+        callpeffects(player, source, EffectHook::AfterKoedByStraightAttack);
+        callaeffects(player, source, EffectHook::AfterBeingKoed);
     }
 
     /* For free fall */
     if (gen() >= 5)
-        callpeffects(player, player, "AfterBeingKoed");
-    callaeffects(player, player, "UponKoed");
+        callpeffects(player, player, EffectHook::AfterBeingKoed);
+    callaeffects(player, player, EffectHook::UponKoed);
     //for Strong Weather
 }
 
@@ -4819,15 +4775,15 @@ int BattleSituation::getStat(int player, int stat, int purityLevel)
 
     /* If the stat is a bit pure, we remove the item effect */
     if (purityLevel == 0)
-        callieffects(player, player, "StatModifier");
+        callieffects(player, player, EffectHook::StatModifier);
 
-    callaeffects(player, player, "StatModifier");
+    callaeffects(player, player, EffectHook::StatModifier);
 
     if (multiples()) {
         for (int partner = 0; partner < numberOfSlots(); partner++) {
             if (partner == player || !arePartners(partner, player) || koed(partner))
                 continue;
-            callaeffects(partner, player, "PartnerStatModifier");
+            callaeffects(partner, player, EffectHook::PartnerStatModifier);
         }
     }
     int ret = baseStat;
@@ -5148,7 +5104,7 @@ void BattleSituation::symbiosisPass(int s)
 {
     foreach (int p, sortedBySpeed()) {
         if (player(p) == player(s)) {
-            callaeffects(p, s, "AllyItemUse");
+            callaeffects(p, s, EffectHook::AllyItemUse);
         }
     }
 }
@@ -5327,16 +5283,16 @@ bool BattleSituation::oppBlockFailure (int target, int player)
 {
     if (target != player) {
         if (blockPriority(player, target)) {
-            calleffects(player,target,"AttackSomehowFailed");
+            calleffects(player,target,EffectHook::AttackSomehowFailed);
             return true;
         }
 
         if (!testFail(player))
-            callaeffects(target,player,"OpponentBlock");
-        callieffects(target,player,"OpponentBlock"); //Safety Goggles
+            callaeffects(target,player,EffectHook::OpponentBlock);
+        callieffects(target,player,EffectHook::OpponentBlock); //Safety Goggles
 
         if (turnMemory(target).contains(QString("Block%1").arg(attackCount()))) {
-            calleffects(player,target,"AttackSomehowFailed");
+            calleffects(player,target,EffectHook::AttackSomehowFailed);
             return true;
         }
     }
@@ -19,7 +19,6 @@ class BattleSituation : public BattleBase
 {
     Q_OBJECT
 public:
-    typedef QVariantHash context;
     typedef std::map<int, std::vector<int>, std::greater<int> > priority_order;
 
     BattleSituation(const BattlePlayer &p1, const BattlePlayer &p2, const ChallengeInfo &additionnalData, int id, const TeamBattle &t1, const TeamBattle &t2, BattleServerPluginManager *p);
@@ -235,19 +234,19 @@ private:
 public:
     std::vector<int> targetList;
     /* Calls the effects of source reacting to name */
-    void calleffects(int source, int target, const QString &name);
+    void calleffects(int source, int target, int hook);
     /* This time the pokelong effects */
-    void callpeffects(int source, int target, const QString &name);
+    void callpeffects(int source, int target, int hook);
     /* this time the general battle effects (imprison, ..) */
-    void callbeffects(int source, int target, const QString &name, bool stopOnFail = false);
+    void callbeffects(int source, int target, int hook, bool stopOnFail = false);
     /* The team zone effects */
-    void callzeffects(int source, int target, const QString &name);
+    void callzeffects(int source, int target, int hook);
     /* The slot effects */
-    void callseffects(int source, int target, const QString &name);
+    void callseffects(int source, int target, int hook);
     /* item effects */
-    void callieffects(int source, int target, const QString &name);
+    void callieffects(int source, int target, int hook);
     /* Ability effects */
-    void callaeffects(int source, int target, const QString &name);
+    void callaeffects(int source, int target, int hook);
 
 public:
     unsigned int currentSlot;
@@ -332,7 +331,8 @@ private:
     QHash<QString, priorityBracket> effectToBracket;
     QHash<priorityBracket, int> bracketCount;
     QHash<priorityBracket, int> bracketType;
-    QHash<priorityBracket, QString> bracketToEffect;
+    /* The end turn hook (see EffectHook) of each bracket */
+    QHash<priorityBracket, int> bracketToEffect;
     QVector<int> bpmodifiers;
     QVector<int> atkmodifiers;
 
@@ -12,6 +12,9 @@ typedef BattleBase::TurnMemory TM;
 BattleBase::BattleBase()
 {
     timer = NULL;
+    randSeed = 0;
+    seeded = false;
+    scripted = false;
 }
 
 void BattleBase::init(const BattlePlayer &p1, const BattlePlayer &p2, const ChallengeInfo &c, int id, const TeamBattle &t1, const TeamBattle &t2, BattleServerPluginManager *pluginManager)
@@ -180,7 +183,7 @@ void BattleBase::beginTurn()
     }
 
     for (int i = 0; i < numberOfSlots(); i++) {
-        callpeffects(i, i, "TurnSettings");
+        callpeffects(i, i, EffectHook::TurnSettings);
     }
     attackCount() = 0;
 
@@ -233,14 +236,14 @@ void BattleBase::run()
     for (int i = 0; i < 10; i++)
         rand();
 #endif
-    unsigned long array[10];
-    for (int i = 0; i < 10; i++) {
-        array[i] = rand();
-        array[i] |= (rand() << 16);
+    if (!seeded) {
+        randSeed = quint32(rand()) ^ (quint32(rand()) << 16);
+        seeded = true;
     }
-    rand_generator.seed(array, 10);
+    rand_generator.seed(randSeed);
 
-    if (clauses() & ChallengeInfo::RearrangeTeams) {
+    /* A scripted battle has its teams in the order they were rearranged in */
+    if ((clauses() & ChallengeInfo::RearrangeTeams) && !scripted) {
         rearrangeTeams();
     }
 
@@ -272,6 +275,10 @@ void BattleBase::onDestroy()
 
 void BattleBase::buildPlugins(BattleServerPluginManager *p)
 {
+    if (!p) {
+        return;
+    }
+
     plugins = p->getBattlePlugins(this);
 
     foreach(BattlePlugin *pl, plugins) {
@@ -499,15 +506,128 @@ bool BattleBase::areAdjacent(int attacker, int defender) const
 
 void BattleBase::yield()
 {
+    /* Spectators and chat that came during the turn. Choices aren't expected yet, so are dropped */
+    drainInbox();
+
     blocked() = true;
-    ContextCallee::yield();
+
+    /* Slots for which a choice is awaited, to record what was chosen */
+    QList<int> awaited;
+    if (!rearrangeTime()) {
+        for (int i = 0; i < numberOfSlots(); i++) {
+            if (hasChoice[i]) {
+                awaited.push_back(i);
+            }
+        }
+    }
+
+    if (scripted) {
+        playScriptedChoices();
+    } else {
+        try {
+            while (!waitOver()) {
+                park();
+                drainInbox();
+            }
+        } catch (const ContextQuitEx &) {
+            /* Terminated, most likely right after the server told us of a forfeit */
+            drainInbox();
+            throw;
+        }
+    }
+
+    blocked() = false;
+
+    foreach(int slot, awaited) {
+        if (!hasChoice[slot]) {
+            choiceLog.push_back(choice(slot));
+        }
+    }
+
     testWin();
 }
 
-void BattleBase::schedule()
+bool BattleBase::waitOver()
 {
-    blocked() = false;
-    ContextCallee::schedule();
+    return allChoicesSet() || drawer() == -2 || forfeiter() != -1 || timeLeft(Player1) <= 0 || timeLeft(Player2) <= 0;
+}
+
+void BattleBase::post(const InboxMessage &m)
+{
+    inbox.push(m);
+    wake();
+}
+
+void BattleBase::wake()
+{
+    /* Only the one to unpark the battle reschedules it */
+    if (parked.testAndSetOrdered(1, 0)) {
+        ContextCallee::schedule();
+    }
+}
+
+void BattleBase::park()
+{
+    parked.fetchAndStoreOrdered(1);
+
+    /* Something was posted before we were parked. If a producer already unparked
+       us, the battle is rescheduled and we have to yield to consume that */
+    if (!inbox.empty() && parked.testAndSetOrdered(1, 0)) {
+        return;
+    }
+
+    ContextCallee::yield();
+}
+
+void BattleBase::drainInbox()
+{
+    InboxMessage m;
+
+    while (inbox.pop(m)) {
+        switch (m.type) {
+        case InboxMessage::Choice: receiveChoice(m.id, m.choice); break;
+        case InboxMessage::Chat: notify(All, BattleChat, spot(m.id), m.text); break;
+        case InboxMessage::SpectatorChat: notify(All, SpectatorChat, m.id, qint32(m.id), m.text); break;
+        case InboxMessage::SpectatorJoin: joinSpectator(QPair<int, QString>(m.id, m.text)); break;
+        case InboxMessage::SpectatorLeave: leaveSpectator(m.id); break;
+        case InboxMessage::Forfeit: forfeit(m.id); break;
+        }
+    }
+}
+
+void BattleBase::script(quint32 seed, const QList<BattleChoice> &choices, quint32 clauses)
+{
+    randSeed = seed;
+    seeded = true;
+    scripted = true;
+    scriptedChoices = choices;
+    conf.clauses = clauses;
+}
+
+void BattleBase::playScriptedChoices()
+{
+    while (!allChoicesSet()) {
+        if (scriptedChoices.empty() || !validChoice(scriptedChoices.front())) {
+            /* The recording stops there (forfeit, disconnection), or it doesn't match the battle anymore */
+            emit battleFinished(publicId(), Close, id(Player1), id(Player2));
+            exit();
+        }
+        storeChoice(scriptedChoices.takeFirst());
+    }
+
+    for (int i = 0; i < numberOfSlots(); i++) {
+        couldMove[i] = false;
+    }
+}
+
+quint32 BattleBase::seed() const
+{
+    return randSeed;
+}
+
+const QList<BattleChoice> &BattleBase::recordedChoices() const
+{
+    return choiceLog;
 }
 
 /*****************************************
@@ -566,7 +686,7 @@ int BattleBase::timeLeft(int player)
 void BattleBase::timerEvent(QTimerEvent *)
 {
     if (timeLeft(Player1) <= 0 || timeLeft(Player2) <= 0) {
-        schedule(); // the battle is finished, isn't it?
+        wake(); // the battle is finished, isn't it?
     } else {
         /* If a player takes too long - more than 30 secs - tell the other player the time remaining */
         if (timeStopped[Player1] && !timeStopped[Player2] && (time(NULL) - startedAt[Player2].load()) > 30) {
@@ -689,26 +809,12 @@ void BattleBase::notifyMiss(bool multiTar, int player, int target)
 
 void BattleBase::emitCommand(int slot, int players, const QByteArray &toSend)
 {
+    /* The server knows who is spectating, so the command is only sent once
+       whatever the number of spectators */
     if (players == All) {
-        emit battleInfo(publicId(), qint32(id(Player1)), toSend);
-        emit battleInfo(publicId(), qint32(id(Player2)), toSend);
-
-        spectatorMutex.lock();
-
-        QHashIterator<int, QPair<int, QString> > it(spectators);
-        while(it.hasNext()) {
-            emit battleInfo(publicId(), qint32(it.next().value().first), toSend);
-        }
-        spectatorMutex.unlock();
+        emit battleBroadcast(publicId(), 0, toSend);
     } else if (players == AllButPlayer) {
-        emit battleInfo(publicId(), qint32(id(opponent(player(slot)))), toSend);
-
-        spectatorMutex.lock();
-        QHashIterator<int, QPair<int, QString> >  it(spectators);
-        while(it.hasNext()) {
-            emit battleInfo(publicId(), qint32(it.next().value().first), toSend);
-        }
-        spectatorMutex.unlock();
+        emit battleBroadcast(publicId(), qint32(id(player(slot))), toSend);
     } else {
         emit battleInfo(publicId(), qint32(id(players)), toSend);
     }
@@ -731,7 +837,6 @@ void BattleBase::changeStatus(int team, int poke, int status)
 
 bool BattleBase::acceptSpectator(int id, bool authed) const
 {
-    QMutexLocker m(&spectatorMutex);
     if (spectators.contains(spectatorKey(id)) || this->id(0) == id || this->id(1) == id)
         return false;
     if (authed)
@@ -757,14 +862,13 @@ void BattleBase::notifyChoices(int p)
 
 void BattleBase::addSpectator(QPair<int, QString> p)
 {
-    /* Simple guard to avoid multithreading problems -- would need to be improved :s */
-    if (!blocked() && !finished()) {
-        pendingSpectators.append(p);
-        QTimer::singleShot(100, this, SLOT(clearSpectatorQueue()));
-
-        return;
-    }
+    InboxMessage m(InboxMessage::SpectatorJoin, p.first);
+    m.text = p.second;
+    post(m);
+}
 
+void BattleBase::joinSpectator(const QPair<int, QString> &p)
+{
     int id = p.first;
 
     int key;
@@ -809,15 +913,23 @@ void BattleBase::addSpectator(QPair<int, QString> p)
 
 void BattleBase::removeSpectator(int id)
 {
-    spectatorMutex.lock();
+    post(InboxMessage(InboxMessage::SpectatorLeave, id));
+}
+
+void BattleBase::leaveSpectator(int id)
+{
     spectators.remove(spectatorKey(id));
-    spectatorMutex.unlock();
 
     notify(All, Spectating, 0, false, qint32(id));
 }
 
 
 void BattleBase::playerForfeit(int forfeiterId)
+{
+    post(InboxMessage(InboxMessage::Forfeit, forfeiterId));
+}
+
+void BattleBase::forfeit(int forfeiterId)
 {
     if (finished()) {
         return;
@@ -903,7 +1015,6 @@ void BattleBase::addDraw(int player)
     }
     if (drawer() != player) {
         drawer() = -2;
-        schedule();
     }
 }
 
@@ -1115,39 +1226,22 @@ bool BattleBase::allChoicesSet()
     return true;
 }
 
-void BattleBase::clearSpectatorQueue()
+void BattleBase::battleChoiceReceived(int id, const BattleChoice &b)
 {
-    if (!blocked() && !finished()) {
-        QTimer::singleShot(100, this, SLOT(clearSpectatorQueue()));
-        return;
-    }
-    if (pendingSpectators.size() > 0) {
-        auto copy = pendingSpectators;
-
-        pendingSpectators.clear();
-
-        foreach (auto p, copy) {
-            addSpectator(p);
-        }
-    }
+    InboxMessage m(InboxMessage::Choice, id);
+    m.choice = b;
+    post(m);
 }
 
-void BattleBase::battleChoiceReceived(int id, const BattleChoice &b)
+void BattleBase::receiveChoice(int id, const BattleChoice &b)
 {
     int player = spot(id);
 
-    /* Simple guard to avoid multithreading problems */
+    /* Not waiting for choices */
     if (!blocked()) {
         return;
     }
 
-    if (finished()) {
-        return;
-    }
-
-    /* Clear the queue of pending spectators */
-    clearSpectatorQueue();
-
     if (b.slot() < 0 || b.slot() >= numberOfSlots()) {
         return;
     }
@@ -1191,18 +1285,21 @@ void BattleBase::battleChoiceReceived(int id, const BattleChoice &b)
                 stopClock(this->player(i), true);
             }
         }
-        schedule();
     }
 }
 
 void BattleBase::battleChat(int id, const QString &str)
 {
-    notify(All, BattleChat, spot(id), str);
+    InboxMessage m(InboxMessage::Chat, id);
+    m.text = str;
+    post(m);
 }
 
 void BattleBase::spectatingChat(int id, const QString &str)
 {
-    notify(All, SpectatorChat, id, qint32(id), str);
+    InboxMessage m(InboxMessage::SpectatorChat, id);
+    m.text = str;
+    post(m);
 }
 
 void BattleBase::sendMessage(int id, const QString &type, const QString &content)
@@ -1321,8 +1418,9 @@ std::vector<int> BattleBase::sortedBySpeed(std::vector<std::pair<int,int>> speed
             }
         }
 
-        if (j != i +1) {
-            std::random_shuffle(speeds.begin() + i, speeds.begin() + j);
+        /* Shuffled with the battle's generator, so ties break the same way when the battle is played again */
+        for (unsigned k = j - 1; k > i; k--) {
+            std::swap(speeds[k], speeds[i + randint(k - i + 1)]);
         }
 
         i = j;
@@ -1762,7 +1860,7 @@ void BattleBase::requestEndOfTurnSwitchIns()
 void BattleBase::analyzeChoice(int slot)
 {
     attackCount() += 1;
-    /* It's already verified that the choice is valid, by battleChoiceReceived, called in a different thread */
+    /* It's already verified that the choice is valid, by receiveChoice */
     if (choice(slot).attackingChoice()) {
         if (!wasKoed(slot)) {
             if (turnMem(slot).contains(TM::NoChoice) || turnMem(slot).contains(TM::KeepAttack))
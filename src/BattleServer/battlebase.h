@@ -6,7 +6,9 @@
 #include <PokemonInfo/battlestructs.h>
 #include <Utilities/mtrand.h>
 #include <Utilities/contextswitch.h>
+#include <Utilities/mpscqueue.h>
 #include "battlepluginstruct.h"
+#include "effecthooks.h"
 
 #include <algorithm>
 
@@ -36,7 +38,7 @@ public:
     BattleBase();
     ~BattleBase();
 
-    typedef QVariantHash context;
+    typedef EffectContext context;
 
     void init(const BattlePlayer &p1, const BattlePlayer &p2, const ChallengeInfo &additionnalData, int id, const TeamBattle &t1, const TeamBattle &t2, BattleServerPluginManager *p);
 
@@ -45,6 +47,11 @@ public:
 
     /* Starts the battle -- use the time before to connect signals / slots */
     void start(ContextSwitcher &ctx);
+
+    /* Plays the battle with the given seed and choices instead of waiting for the players, to play
+       a recorded battle again. The clauses replace the ones given at init, as some of them (challenge cup)
+       only matter to build teams that are already built. Call before start() */
+    void script(quint32 seed, const QList<BattleChoice> &choices, quint32 clauses);
 protected:
     void onDestroy(); //call in the sub class destructor
 
@@ -65,6 +72,8 @@ public:
     int id(int spot) const;
     /* Return the configuration of the players (1 refer to that player, 0 to that one... */
     const BattleConfiguration &configuration() const;
+    quint32 seed() const;
+    const QList<BattleChoice> &recordedChoices() const;
     /* Returns the rating of the beginning of a battle, of a player */
     int rating(int spot) const;
     bool rated() const;
@@ -149,6 +158,7 @@ public:
 
     void emitCommand(int player, int players, const QByteArray &data);
 
+    /* Thread safe, handled by the battle the next time it waits for choices */
     void battleChoiceReceived(int id, const BattleChoice &b);
     void battleChat(int id, const QString &str);
     void spectatingChat(int id, const QString &str);
@@ -157,8 +167,6 @@ public:
     virtual int getStat(int poke, int stat) = 0;
     virtual void sendPoke(int player, int poke, bool silent = false) = 0;
     virtual void sendBack(int player, bool silent = false);
-protected slots:
-    void clearSpectatorQueue();
 signals:
     /* Due to threading issue, and the signal not being direct,
        The battle might already be deleted when the signal is received.
@@ -166,12 +174,14 @@ signals:
        So the parameter "publicId" is for the server to not to have to use
        sender(); */
     void battleInfo(int publicId, int id, const QByteArray &info);
+    /* Sent once for the whole audience (both players and spectators), the server
+       fans it out. except is the id of the player not to send it to, or 0. */
+    void battleBroadcast(int publicId, int except, const QByteArray &info);
     void battleFinished(int battleid, int result, int winner, int loser);
     void sendBattleInfos(int,int,int,const TeamBattle&,const BattleConfiguration&, const QString&);
 protected:
+    /* Only touched by the battle itself, spectators join and leave through the inbox */
     QHash<int,QPair<int, QString> > spectators;
-    mutable QMutex spectatorMutex;
-    QList<QPair<int,QString> > pendingSpectators;
 
     int spectatorKey(int id) const {
         return 10000 + id;
@@ -211,8 +221,44 @@ protected:
     void stopClock(int player, bool broadCoast = false);
     int timeLeft(int player);
 
+    /* Waits for the choices, handling what the server sends in the meantime */
     void yield();
-    void schedule();
+
+    /* What the server sends to the battle, from its own thread */
+    struct InboxMessage {
+        enum Type {
+            Choice,
+            Chat,
+            SpectatorChat,
+            SpectatorJoin,
+            SpectatorLeave,
+            Forfeit
+        };
+
+        InboxMessage(int type = Choice, int id = 0) : type(type), id(id) {}
+
+        int type;
+        int id;
+        BattleChoice choice;
+        QString text;
+    };
+    MpscQueue<InboxMessage> inbox;
+    /* Set while the battle is suspended until something arrives in the inbox */
+    QAtomicInt parked;
+
+    void post(const InboxMessage &m);
+    /* Reschedules the battle if it's parked. Thread safe */
+    void wake();
+    /* Suspends the battle until the inbox has something */
+    void park();
+    void drainInbox();
+    /* True when the battle can go on after waiting for choices */
+    bool waitOver();
+
+    void receiveChoice(int id, const BattleChoice &b);
+    void joinSpectator(const QPair<int, QString> &p);
+    void leaveSpectator(int id);
+    void forfeit(int forfeiterId);
 
     /* if battle ends, stop the battle thread */
     void testWin();
@@ -230,27 +276,23 @@ protected:
     virtual BattleChoice &choice (int p) = 0;
 public:
     /* This time the pokelong effects */
-    virtual void callpeffects(int source, int target, const QString &name) = 0;
+    virtual void callpeffects(int source, int target, int hook) = 0;
 
     /* The players ordered by speed are stored there */
     std::vector<int> speedsVector;
     bool applyingMoveStatMods;
 
+    /* From the battle's thread only */
     const QHash<int, QPair<int, QString> > &getSpectators() const {
-        QMutexLocker m(&spectatorMutex);
         return spectators;
     }
 
-    const QList<QPair<int, QString> > &getPendingSpectators() const {
-        return pendingSpectators;
-    }
-
     bool acceptSpectator(int id, bool authed=false) const;
-    /* In case it's one of the battler, resends the current info to the battler */
+    /* In case it's one of the battler, resends the current info to the battler. Thread safe */
     void addSpectator(QPair<int, QString>);
     void removeSpectator(int id);
 
-    /* Server tells a player forfeited */
+    /* Server tells a player forfeited. Thread safe */
     void playerForfeit(int forfeiterId);
 
     struct QuitException {};
@@ -288,7 +330,18 @@ protected:
         //qDebug() << "Ending callp for " << this;
     }
 
+    /* The only source of randomness of the battle, so it can be played again from its seed */
     mutable MTRand_int32 rand_generator;
+    quint32 randSeed;
+    bool seeded;
+
+    /* Choices of the players, in the order they were made */
+    QList<BattleChoice> choiceLog;
+    /* When scripted, choices to make in place of the players */
+    bool scripted;
+    QList<BattleChoice> scriptedChoices;
+    /* Makes the choices the battle waits for when scripted. Can be overridden to choose on the fly */
+    virtual void playScriptedChoices();
 
     BattleConfiguration conf;
 
@@ -8,6 +8,7 @@
 class TeamBattle;
 class PokeBattle;
 class BattleConfiguration;
+struct BattleChoice;
 
 /* Fixme: needs some sort of cache to avoid revs() creating a list
    each time */
@@ -57,6 +58,10 @@ public:
     virtual int rating(int spot) const = 0;
     /* Return the configuration of the players (1 refer to that player, 0 to that one...) */
     virtual const BattleConfiguration &configuration() const = 0;
+    /* Seed of the random generator. With the teams and the choices made, the battle can be played again */
+    virtual quint32 seed() const = 0;
+    /* Choices the players made so far, in order */
+    virtual const QList<BattleChoice> &recordedChoices() const = 0;
 
 //    virtual bool acceptSpectator(int id, bool authed=false) const = 0;
 //    virtual void addSpectator(Player *p) = 0;
@@ -20,7 +20,7 @@ BattleRBY::~BattleRBY()
 
 void BattleRBY::debug(const QString &message)
 {
-    battleChat(conf.ids[0], message);
+    notify(All, BattleChat, Player1, message);
 }
 
 void BattleRBY::endTurn()
@@ -146,7 +146,7 @@ BattleChoices BattleRBY::createChoice(int slot)
     BattleChoices ret;
     ret.numSlot = slot;
 
-    callpeffects(slot, slot, "MovesPossible");
+    callpeffects(slot, slot, EffectHook::MovesPossible);
 
     for (int i = 0; i < 4; i++) {
         if (!isMovePossible(slot,i)) {
@@ -307,7 +307,7 @@ void BattleRBY::inflictDamage(int player, int damage, int source, bool straighta
         if (!sub) {
             /* If there's a sub its already taken care of */
             turnMem(player).damageTaken = damage;
-            callpeffects(player, source, "UponOffensiveDamageReceived");
+            callpeffects(player, source, EffectHook::UponOffensiveDamageReceived);
         }
 
         if (damage > 0) {
@@ -335,7 +335,7 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
 
     turnMem(player).add(TurnMemory::HasMoved);
 
-    calleffects(player,player,"EvenWhenCantMove");
+    calleffects(player,player,EffectHook::EvenWhenCantMove);
 
     if (!testStatus(player)) {
         goto trueend;
@@ -345,13 +345,13 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
     //turnMemory(player)["MoveChosen"] = attack;
 
     if (!specialOccurence) {
-        callpeffects(player, target, "MovePossible");
+        callpeffects(player, target, EffectHook::MovePossible);
         if (turnMemory(player).contains("ImpossibleToMove")) {
             goto trueend;
         }
     }
 
-    calleffects(player, target, "MoveSettings");
+    calleffects(player, target, EffectHook::MoveSettings);
 
     if (!turnMem(player).contains(TM::BuildUp) && attack != 0 && attack != Move::Struggle) {
         fpoke(player).lastMoveUsed = attack;
@@ -391,7 +391,7 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
     // Miss
     if (target != player && !testAccuracy(player, target)) {
         pokeMemory(player).remove("DamageInflicted");
-        calleffects(player,target,"AttackSomehowFailed");
+        calleffects(player,target,EffectHook::AttackSomehowFailed);
         battleMemory()["LastDamageTakenByAny"] = 0; //Counter fails if last move used missed
         goto trueend;
     }
@@ -411,13 +411,13 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
         if (typemod < -50 && ((tmove(player).power > 1 && attack != Move::Bind && attack != Move::Wrap) || (MoveInfo::isOHKO(attack, gen())))) {
             /* If it's ineffective we just say it */
             notify(All, Effective, target, quint8(0));
-            calleffects(player,target,"AttackSomehowFailed");
+            calleffects(player,target,EffectHook::AttackSomehowFailed);
             goto trueend;
         }
 
-        calleffects(player, target, "DetermineAttackFailure");
+        calleffects(player, target, EffectHook::DetermineAttackFailure);
         if (testFail(player)){
-            calleffects(player,target,"AttackSomehowFailed");
+            calleffects(player,target,EffectHook::AttackSomehowFailed);
             goto trueend;
         }
 
@@ -428,7 +428,7 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
             testCritical(player, target);
         }
 
-        calleffects(player, target, "CustomAttackingDamage");
+        calleffects(player, target, EffectHook::CustomAttackingDamage);
 
         int damage;
         if (turnMemory(player).contains("CustomDamage")) {
@@ -458,7 +458,7 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
             }
             hitcount += 1;
 
-            calleffects(player, target, "UponAttackSuccessful");
+            calleffects(player, target, EffectHook::UponAttackSuccessful);
 
             /* A broken sub stops a multi-hit attack and draining moves don't heal */
             if (hadSubstitute(target)) {
@@ -504,14 +504,14 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
         }
 
 
-        calleffects(player, target, "DetermineAttackFailure");
+        calleffects(player, target, EffectHook::DetermineAttackFailure);
         if (testFail(player)){
-            calleffects(player,target,"AttackSomehowFailed");
+            calleffects(player,target,EffectHook::AttackSomehowFailed);
             goto trueend;
         }
 
         applyMoveStatMods(player, target);
-        calleffects(player, target, "UponAttackSuccessful");
+        calleffects(player, target, EffectHook::UponAttackSuccessful);
 
         /* Side change may switch player & target */
         if (attacker() != player) {
@@ -526,7 +526,7 @@ void BattleRBY::useAttack(int player, int move, bool specialOccurence, bool tell
 
     trueend:
 
-    calleffects(player,player,"TrueEnd");
+    calleffects(player,player,EffectHook::TrueEnd);
 
     if (koed(player) && tmove(player).power > 0) {
         notifyKO(player);
@@ -722,40 +722,14 @@ bool BattleRBY::testStatus(int player) {
     return true;
 }
 
-void BattleRBY::callpeffects(int source, int target, const QString &name)
+void BattleRBY::callpeffects(int source, int target, int hook)
 {
-    if (pokeMemory(source).contains("Effect_" + name)) {
-        turnMemory(source)["PokeEffectCall"] = true;
-        QSet<QString> &effects = *pokeMemory(source).value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = pokeMemory(source).value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            /* If a pokemons dies from leechseed,its status changes, and so nightmare function would be removed
-               but still be in the foreach, causing a crash */
-            if(f)
-                f(source, target, *this);
-        }
-        turnMemory(source)["PokeEffectCall"] = false;
-    }
+    RBYMechanics::callFunctions(pokeMemory(source), hook, source, target, *this);
 }
 
-void BattleRBY::calleffects(int source, int target, const QString &name)
+void BattleRBY::calleffects(int source, int target, int hook)
 {
-    context &turn = turnMemory(source);
-    if (turn.contains("Effect_" + name)) {
-        turn["TurnEffectCall"] = true;
-        turn["TurnEffectCalled"] = name;
-        QSet<QString> &effects = *turn.value("Effect_" + name).value<QSharedPointer<QSet<QString> > >();
-
-        foreach(QString effect, effects) {
-            MechanicsFunction f = turn.value("Effect_" + name + "_" + effect).value<MechanicsFunction>();
-
-            if (f)
-                f(source, target, *this);
-        }
-        turn["TurnEffectCall"] = false;
-    }
+    RBYMechanics::callFunctions(turnMemory(source), hook, source, target, *this);
 }
 
 void BattleRBY::setupMove(int i, int move, bool)
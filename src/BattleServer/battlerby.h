@@ -80,9 +80,9 @@ public:
     const context & battleMemory() const {return battlelongs;}
 
     /* Calls the effects of source reacting to name */
-    void calleffects(int source, int target, const QString &name);
+    void calleffects(int source, int target, int hook);
     /* This time the pokelong effects */
-    void callpeffects(int source, int target, const QString &name);
+    void callpeffects(int source, int target, int hook);
 };
 
 Q_DECLARE_METATYPE(BattleRBY::MechanicsFunction)
@@ -13,16 +13,15 @@
 #include "serverconnection.h"
 #include "battleserver.h"
 #include "pluginmanager.h"
+#include "resimulation.h"
 
 BattleServer::BattleServer(QObject *parent) :
-    QObject(parent), servercounter(0), closeOnDc(false)
+    QObject(parent), servercounter(0), closeOnDc(false), resimulationFailures(0)
 {
 }
 
-void BattleServer::start(int port, bool closeOnDc)
+void BattleServer::loadDatabase()
 {
-    print("Starting Battle Server...");
-
     print("Initialising Pokemon & Battle database");
 
     PokemonInfoConfig::setFillMode(FillMode::Server);
@@ -35,6 +34,13 @@ void BattleServer::start(int port, bool closeOnDc)
     AbilityEffect::init();
 
     print("...Done!");
+}
+
+void BattleServer::start(int port, bool closeOnDc, int workers)
+{
+    print("Starting Battle Server...");
+
+    loadDatabase();
 
     pluginManager = new BattleServerPluginManager();
 
@@ -63,8 +69,61 @@ void BattleServer::start(int port, bool closeOnDc)
     manager.start();
 #endif
 
-    battleThread.start();
-    print("Battle thread started");
+    battleThread.start(workers);
+    print(QString("Battle threads started (%1 worker(s))").arg(battleThread.workerCount()));
+
+    /*
+      Reports how much of the battle stacks are really used, every hour
+     */
+    QTimer *t = new QTimer(this);
+    connect(t, SIGNAL(timeout()), this, SLOT(printStackUsage()));
+    t->start(3600*1000);
+}
+
+void BattleServer::resimulate(const QStringList &files, int workers)
+{
+    loadDatabase();
+
+    battleThread.start(workers);
+
+    resimulations = files;
+    resimulationFailures = 0;
+
+    /* Once the event loop runs, to be able to quit it */
+    QTimer::singleShot(0, this, SLOT(resimulateNext()));
+}
+
+void BattleServer::resimulateNext(bool identical)
+{
+    if (!identical) {
+        resimulationFailures += 1;
+    }
+
+    while (!resimulations.empty()) {
+        QString file = resimulations.takeFirst();
+
+        Resimulation *r = new Resimulation(this);
+
+        if (!r->load(file)) {
+            print(QString("%1: %2").arg(file, r->errorString()));
+            resimulationFailures += 1;
+            delete r;
+            continue;
+        }
+
+        connect(r, SIGNAL(finished(bool)), r, SLOT(deleteLater()));
+        connect(r, SIGNAL(finished(bool)), SLOT(resimulateNext(bool)));
+        r->start(battleThread);
+        return;
+    }
+
+    print(QString("Resimulation done, %1 failure(s)").arg(resimulationFailures));
+    QCoreApplication::exit(resimulationFailures > 0 ? 1 : 0);
+}
+
+void BattleServer::printStackUsage()
+{
+    print(ContextStackPool::report());
 }
 
 void BattleServer::changeDbMod(const QString &mod)
@@ -161,6 +220,7 @@ void BattleServer::newBattle(int sid, int battleid, const BattlePlayer &pb1, con
     conn->battles.insert(battleid, battle);
     connect(battle, SIGNAL(sendBattleInfos(int,int,int,TeamBattle,BattleConfiguration,QString)), conn, SLOT(notifyBattle(int,int,int,TeamBattle,BattleConfiguration,QString)));
     connect(battle, SIGNAL(battleInfo(int,int,QByteArray)), conn, SLOT(notifyInfo(int,int,QByteArray)));
+    connect(battle, SIGNAL(battleBroadcast(int,int,QByteArray)), conn, SLOT(notifyBroadcast(int,int,QByteArray)));
     connect(battle, SIGNAL(battleFinished(int,int,int,int)), conn, SLOT(notifyFinished(int,int,int,int)));
     connect(conn, SIGNAL(destroyed()), battle, SLOT(deleteLater()));
 
@@ -21,12 +21,16 @@ class BattleServer : public QObject
 public:
     explicit BattleServer(QObject *parent = 0);
     
-    void start(int port, bool closeOnDc);
+    /* workers: number of threads running the battles, 0 to use one per core */
+    void start(int port, bool closeOnDc, int workers = 1);
+    /* Plays the battles of the replays again instead of listening, then quits */
+    void resimulate(const QStringList &files, int workers = 1);
     void changeDbMod(const QString &mod);
 signals:
     
 public slots:
     void print(const QString &s);
+    void printStackUsage();
     void newConnection();
 
     void newBattle(int sid, int battleid, const BattlePlayer &pb1, const BattlePlayer &pb2, const ChallengeInfo &c, const TeamBattle &t1, const TeamBattle &t2);
@@ -35,8 +39,11 @@ public slots:
     void modChanged(const QString &);
     void loadPlugin(const QString &path);
     void unloadPlugin(const QString &name);
+
+    void resimulateNext(bool identical = true);
 private:
     int freeid() const;
+    void loadDatabase();
 
 #ifndef BOOST_SOCKETS
     QTcpServer * server;
@@ -51,6 +58,9 @@ private:
 
     QHash<int, ServerConnection*> connections;
     bool closeOnDc;
+
+    QStringList resimulations;
+    int resimulationFailures;
 };
 
 #endif // BATTLESERVER_H
@@ -332,12 +332,12 @@ struct BMCriticalPinch : public BMPinch
     /* ripped off from focus energy */
     static void uas(int, int s, BS &b) {
         if (b.isOut(s)) {
-            addFunction(poke(b,s), "TurnSettings", "FocusEnergy", &ts);
+            addFunction(poke(b,s), EffectHook::TurnSettings, "FocusEnergy", &ts);
             b.sendMoveMessage(46,0,s);
         }
     }
     static void ts(int s, int, BS &b) {
-        addFunction(turn(b,s), "BeforeTargetList", "FocusEnergy", &btl);
+        addFunction(turn(b,s), EffectHook::BeforeTargetList, "FocusEnergy", &btl);
     }
     static void btl(int s, int, BS &b) {
         if (tmove(b,b.attacker()).power > 0) {
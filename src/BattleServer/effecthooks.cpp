@@ -0,0 +1,148 @@
+#include "effecthooks.h"
+
+namespace {
+    /* Gives dense ids to strings. Only used when registering effects, the battles
+       themselves deal with the ids */
+    class Interner
+    {
+    public:
+        Interner(const char * const *known = NULL, int count = 0) {
+            for (int i = 0; i < count; i++) {
+                ids.insert(known[i], i);
+                strings.push_back(known[i]);
+            }
+        }
+
+        int id(const QString &s, int max = -1) {
+            {
+                QReadLocker l(&lock);
+                QHash<QString, int>::const_iterator it = ids.constFind(s);
+                if (it != ids.constEnd()) {
+                    return it.value();
+                }
+            }
+            QWriteLocker l(&lock);
+            if (ids.contains(s)) {
+                return ids.value(s);
+            }
+            if (max != -1 && strings.size() >= max) {
+                qFatal("Too many effect hooks, raise EffectHook::MaxHooks (registering %s)", qPrintable(s));
+            }
+            int id = strings.size();
+            ids.insert(s, id);
+            strings.push_back(s);
+            return id;
+        }
+
+        QString string(int id) {
+            QReadLocker l(&lock);
+            return strings.value(id);
+        }
+    private:
+        QReadWriteLock lock;
+        QHash<QString, int> ids;
+        QVector<QString> strings;
+    };
+
+    const char * const knownHooks[] = {
+#define EFFECT_HOOK_NAME(hook) #hook,
+        EFFECT_HOOKS(EFFECT_HOOK_NAME)
+#undef EFFECT_HOOK_NAME
+    };
+
+    Interner &hooks() {
+        static Interner interner(knownHooks, EffectHook::KnownHooks);
+        return interner;
+    }
+
+    Interner &effects() {
+        static Interner interner;
+        return interner;
+    }
+}
+
+int EffectHook::id(const QString &name)
+{
+    return hooks().id(name, MaxHooks);
+}
+
+QString EffectHook::name(int id)
+{
+    return hooks().string(id);
+}
+
+int EffectHook::effect(const QString &name)
+{
+    return effects().id(name);
+}
+
+void EffectTable::add(int hook, int name, Function f)
+{
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].hook == hook && entries[i].name == name) {
+            entries[i].f = f;
+            return;
+        }
+    }
+
+    Entry e = {hook, name, f};
+    entries.append(e);
+    mask[hook >> 6] |= quint64(1) << (hook & 63);
+}
+
+void EffectTable::remove(int hook, int name)
+{
+    if (!contains(hook)) {
+        return;
+    }
+
+    bool remaining = false;
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].hook != hook) {
+            continue;
+        }
+        if (entries[i].name == name) {
+            entries.remove(i);
+            i -= 1;
+        } else {
+            remaining = true;
+        }
+    }
+
+    if (!remaining) {
+        mask[hook >> 6] &= ~(quint64(1) << (hook & 63));
+    }
+}
+
+void EffectTable::merge(const EffectTable &other)
+{
+    for (int i = 0; i < other.entries.size(); i++) {
+        add(other.entries[i].hook, other.entries[i].name, other.entries[i].f);
+    }
+}
+
+EffectTable::Function EffectTable::function(int hook, int name) const
+{
+    if (!contains(hook)) {
+        return NULL;
+    }
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].hook == hook && entries[i].name == name) {
+            return entries[i].f;
+        }
+    }
+    return NULL;
+}
+
+void EffectTable::names(int hook, QVarLengthArray<int, 8> &names) const
+{
+    names.clear();
+    if (!contains(hook)) {
+        return;
+    }
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].hook == hook) {
+            names.append(entries[i].name);
+        }
+    }
+}
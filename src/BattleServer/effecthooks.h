@@ -0,0 +1,178 @@
+#ifndef EFFECTHOOKS_H
+#define EFFECTHOOKS_H
+
+#include <QtCore>
+#include <cstring>
+
+/* The hooks the move, item and ability mechanics can react to.
+
+   Every hook has a fixed id so that calling the effects of a context is just
+   a matter of testing a bit and going through a small array, instead of building
+   "Effect_" + name strings and looking them up in the QVariantHash.
+   The end turn hooks ("EndTurn6.4", ...) are built from the brackets and get
+   their ids the first time they are seen, after the fixed ones. */
+#define EFFECT_HOOKS(X) \
+    X(ActivateProtean) \
+    X(AfterAttackFinished) \
+    X(AfterAttackSuccessful) \
+    X(AfterBeingKoed) \
+    X(AfterBeingPlumetted) \
+    X(AfterBeingPlummeted) \
+    X(AfterHPChange) \
+    X(AfterKnockOff) \
+    X(AfterKoedByStraightAttack) \
+    X(AfterKoing) \
+    X(AfterNegativeStatChange) \
+    X(AfterPPLoss) \
+    X(AfterStatChange) \
+    X(AfterStatusChange) \
+    X(AfterStatusDamage) \
+    X(AfterSwitchIn) \
+    X(AfterTargetList) \
+    X(AfterTellingPlayers) \
+    X(AllyItemUse) \
+    X(AttackSomehowFailed) \
+    X(BasePowerFoeModifier) \
+    X(BasePowerModifier) \
+    X(BeforeBeingKoed) \
+    X(BeforeCalculatingDamage) \
+    X(BeforeHitting) \
+    X(BeforeTakingDamage) \
+    X(BeforeTargetList) \
+    X(BlockTurnEffects) \
+    X(CustomAttackingDamage) \
+    X(DamageFormulaStart) \
+    X(DanceInvite) \
+    X(DetermineAttackFailure) \
+    X(DetermineAttackPossible) \
+    X(DetermineGeneralAttackFailure2) \
+    X(DetermineProtectedAgainstAttack) \
+    X(DetermineProtectedAgainstAttackKS) \
+    X(Disguise) \
+    X(EvenWhenCantMove) \
+    X(FoeDamageFormulaStart) \
+    X(GeneralTargetChange) \
+    X(IsItTrapped) \
+    X(KnockOff) \
+    X(MissAttack) \
+    X(Mod2Modifier) \
+    X(Mod3Items) \
+    X(MoveClassModifier) \
+    X(MovePossible) \
+    X(MoveSettings) \
+    X(MovesPossible) \
+    X(OnFoeOnAttack) \
+    X(OnHitting) \
+    X(OnLoss) \
+    X(OnOpponentKO) \
+    X(OnPartnerKO) \
+    X(OnPhysicalAssault) \
+    X(OnSetup) \
+    X(OpponentBlock) \
+    X(PartnerStatModifier) \
+    X(PreventStatChange) \
+    X(PriorityChoice) \
+    X(StatModifier) \
+    X(TerrainChange) \
+    X(TestEvasion) \
+    X(TestPinch) \
+    X(TrainerItem) \
+    X(TrueEnd) \
+    X(TurnOrder) \
+    X(TurnSettings) \
+    X(UponAttackSuccessful) \
+    X(UponBeingHit) \
+    X(UponBeingHit2) \
+    X(UponDamageInflicted) \
+    X(UponHittingDisguise) \
+    X(UponKoed) \
+    X(UponLoseItem) \
+    X(UponOffensiveDamageReceived) \
+    X(UponOpponentSwitchIn) \
+    X(UponPhysicalAssault) \
+    X(UponReactivation) \
+    X(UponSelfSurvival) \
+    X(UponSetup) \
+    X(UponSwitchIn) \
+    X(UponSwitchOut) \
+    X(WeatherChange) \
+    X(WeatherSpecial) \
+    X(ZMove)
+
+namespace EffectHook {
+    enum Id {
+#define EFFECT_HOOK_ID(hook) hook,
+        EFFECT_HOOKS(EFFECT_HOOK_ID)
+#undef EFFECT_HOOK_ID
+        KnownHooks,
+        MaxHooks = 256
+    };
+
+    /* Returns the id of the hook, registering it if it's an end turn hook not seen yet */
+    int id(const QString &name);
+    QString name(int id);
+    /* Returns the id of the name of an effect ("Taunt", "BatonPass", ...) */
+    int effect(const QString &name);
+}
+
+/* The effects registered in a context, by hook.
+
+   There are rarely more than a handful of them in a context, so they are kept
+   in a flat array, with a bitmask telling which hooks have something to call. */
+class EffectTable
+{
+public:
+    typedef void (*Function)();
+
+    EffectTable() {
+        clearMask();
+    }
+
+    bool contains(int hook) const {
+        return (mask[hook >> 6] >> (hook & 63)) & 1;
+    }
+
+    /* Replaces the previous function with the same name if any */
+    void add(int hook, int name, Function f);
+    void remove(int hook, int name);
+    Function function(int hook, int name) const;
+    /* Adds the effects of the other table, replacing the ones with the same name */
+    void merge(const EffectTable &other);
+    /* The names of the effects registered for the hook, in the order they were added */
+    void names(int hook, QVarLengthArray<int, 8> &names) const;
+
+    void clear() {
+        entries.clear();
+        clearMask();
+    }
+private:
+    struct Entry {
+        int hook;
+        int name;
+        Function f;
+    };
+
+    QVarLengthArray<Entry, 8> entries;
+    quint64 mask[EffectHook::MaxHooks/64];
+
+    void clearMask() {
+        memset(mask, 0, sizeof(mask));
+    }
+};
+
+/* The contexts of a battle (turn memory, poke memory, ...) along with
+   the effects registered in them */
+struct EffectContext : public QVariantHash
+{
+    EffectTable effects;
+
+    void clear() {
+        QVariantHash::clear();
+        effects.clear();
+    }
+};
+
+/* Baton Pass carries the pokelong effects in a QVariant */
+Q_DECLARE_METATYPE(EffectContext)
+
+#endif // EFFECTHOOKS_H
@@ -12,15 +12,17 @@ QHash<int, ItemMechanics> ItemEffect::mechanics;
 QHash<int, QString> ItemEffect::names;
 QHash<QString, int> ItemEffect::nums;
 
-void ItemEffect::activate(const QString &effect, int num, int source, int target, BattleSituation &b)
+void ItemEffect::activate(int hook, int num, int source, int target, BattleSituation &b)
 {
     QList<ItemInfo::Effect> l = ItemInfo::Effects(num, b.gen());
 
     foreach(ItemInfo::Effect e, l) {
-        if (!mechanics.contains(e.num) || !mechanics[e.num].functions.contains(effect)) {
+        QHash<int, ItemMechanics>::const_iterator it = mechanics.constFind(e.num);
+
+        if (it == mechanics.constEnd() || !it->functions.contains(hook)) {
             continue;
         }
-        mechanics[e.num].functions[effect](source, target, b);
+        it->functions.value(hook)(source, target, b);
     }
 }
 
@@ -559,45 +561,45 @@ struct IMMentalHerb : public IM
         if (poke(b,s).contains("AttractedTo")) {
             int seducer = poke(b,s)["AttractedTo"].toInt();
             if (poke(b,seducer).contains("Attracted") && poke(b,seducer)["Attracted"].toInt() == s) {
-                removeFunction(poke(b,s), "DetermineAttackPossible", "Attract");
+                removeFunction(poke(b,s), EffectHook::DetermineAttackPossible, "Attract");
                 poke(b,s).remove("AttractedTo");
                 used = true;
             }
         }
         if (b.gen() >= 5) {
             if (poke(b,s).contains("Tormented")) {
-                removeFunction(poke(b,s), "MovesPossible", "Torment");
+                removeFunction(poke(b,s), EffectHook::MovesPossible, "Torment");
                 poke(b,s).remove("Tormented");
                 used = true;
             }
             if (b.counters(s).hasCounter(BC::Taunt)) {
-                removeFunction(poke(b,s), "MovesPossible", "Taunt");
-                removeFunction(poke(b,s), "MovePossible", "Taunt");
+                removeFunction(poke(b,s), EffectHook::MovesPossible, "Taunt");
+                removeFunction(poke(b,s), EffectHook::MovePossible, "Taunt");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "Taunt");
                 used = true;
             }
             if (b.counters(s).hasCounter(BC::Encore)) {
-                removeFunction(poke(b,s), "MovesPossible", "Encore");
+                removeFunction(poke(b,s), EffectHook::MovesPossible, "Encore");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "Encore");
                 used = true;
             }
             if (b.counters(s).hasCounter(BC::Disable)) {
-                removeFunction(poke(b,s), "MovesPossible", "Disable");
-                removeFunction(poke(b,s), "MovePossible", "Disable");
+                removeFunction(poke(b,s), EffectHook::MovesPossible, "Disable");
+                removeFunction(poke(b,s), EffectHook::MovePossible, "Disable");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "Disable");
                 used = true;
             }
             if (poke(b,s).contains("HealBlocked")) {
-                removeFunction(poke(b,s), "MovesPossible", "HealBlock");
-                removeFunction(poke(b,s), "MovePossible", "HealBlock");
+                removeFunction(poke(b,s), EffectHook::MovesPossible, "HealBlock");
+                removeFunction(poke(b,s), EffectHook::MovePossible, "HealBlock");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "HealBlock");
                 poke(b,s).remove("HealBlocked");
                 used = true;
             }
             //Unconfirmed
             if (b.counters(s).hasCounter(BC::ThroatChop)) {
-                removeFunction(poke(b,s), "MovesPossible", "ThroatChop");
-                removeFunction(poke(b,s), "MovePossible", "ThroatChop");
+                removeFunction(poke(b,s), EffectHook::MovesPossible, "ThroatChop");
+                removeFunction(poke(b,s), EffectHook::MovePossible, "ThroatChop");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "ThroatChop");
                 used = true;
             }
@@ -782,7 +784,7 @@ struct IMRedCard : public IM
         //Red Card does not trigger if the Pokemon is phazed with Dragon Tail/Circle Throw
         if (b.koed(s) || (b.hasWorkingAbility(t, Ability::SheerForce) && turn(b,t).contains("EncourageBug")) || tmove(b,t).attack == Move::DragonTail || tmove(b,t).attack == Move::CircleThrow || (b.hasSubstitute(s) && !b.canBypassSub(t)))
             return;
-        addFunction(turn(b,t), "AfterAttackFinished", "RedCard", &aaf);
+        addFunction(turn(b,t), EffectHook::AfterAttackFinished, "RedCard", &aaf);
         turn(b,t)["RedCardUser"] = s;
         turn(b,t)["RedCardCount"] = slot(b,t)["SwitchCount"];
         turn(b,t)["RedCardGiverCount"] = slot(b,s)["SwitchCount"];
@@ -848,7 +850,7 @@ struct IMEscapeButton : public IM
         turn(b,s)["EscapeButtonActivated"] = true;
         turn(b,s)["EscapeButtonCount"] = slot(b,s)["SwitchCount"];
 
-        addFunction(turn(b,t), "AfterAttackFinished", "EscapeButton", &aaf);
+        addFunction(turn(b,t), EffectHook::AfterAttackFinished, "EscapeButton", &aaf);
     }
 
     static void aaf(int, int, BS &b) {
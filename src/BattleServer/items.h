@@ -13,7 +13,7 @@ struct ItemEffect : public QVariantHash
     ItemEffect(int num);
 
     static void setup(int num, int source, BattleSituation &b);
-    static void activate(const QString &effect, int num, int source, int target, BattleSituation &b);
+    static void activate(int hook, int num, int source, int target, BattleSituation &b);
 
     /* Beware, that data is used by BugBite so don't modify it directly */
     static QHash<int, ItemMechanics> mechanics;
@@ -1,5 +1,6 @@
 #include <QtCore/QCoreApplication>
 #include <QDir>
+#include <QFileInfo>
 
 #include "battleserver.h"
 #include "consolereader.h"
@@ -10,6 +11,8 @@ int main(int argc, char *argv[])
 {
     int port = 5096;
     bool closeOnDc = false;
+    int workers = 1;
+    QStringList replays;
 
     //parse commandline arguments
     for(int i = 0; i < argc; i++){
@@ -21,6 +24,8 @@ int main(int argc, char *argv[])
             fprintf(stdout, "Options:\n");
             PRINTOPT("-h, --help", "Displays this help.");
             PRINTOPT("-c, --close-on-dc", "Makes this battle server close itself when connection to a server has been lost.");
+            PRINTOPT("-w, --workers [N]", "Number of threads running the battles, 0 for one per core (default: 1).");
+            PRINTOPT("-r, --resimulate [FILE]", "Plays the battle of the .poreplay file again and checks it goes the same way, then quits. Can be repeated.");
             //PRINTOPT("-p, --port [PORT]", "Sets the server port.");
             fprintf(stdout, "\n");
             return 0;   //exit app
@@ -32,6 +37,19 @@ int main(int argc, char *argv[])
             port = atoi(argv[i]);
         } else if(strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--close-on-dc") == 0){
             closeOnDc = true;
+        } else if(strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--workers") == 0){
+            if (++i == argc){
+                fprintf(stderr, "No number of workers provided.\n");
+                return 1;
+            }
+            workers = atoi(argv[i]);
+        } else if(strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--resimulate") == 0){
+            if (++i == argc){
+                fprintf(stderr, "No replay file provided.\n");
+                return 1;
+            }
+            /* Before changing the current directory */
+            replays.push_back(QFileInfo(QString::fromLocal8Bit(argv[i])).absoluteFilePath());
         }
     }
 
@@ -58,7 +76,11 @@ int main(int argc, char *argv[])
     QCoreApplication a(argc, argv);
     
     BattleServer server;
-    server.start(port, closeOnDc);
+    if (!replays.empty()) {
+        server.resimulate(replays, workers);
+        return a.exec();
+    }
+    server.start(port, closeOnDc, workers);
 
 //    ConsoleReader reader(&server);
 //    QSocketNotifier notifier(fileno(stdin), QSocketNotifier::Read);
@@ -2,6 +2,7 @@
 #define MECHANICSBASE_H
 
 #include "battlebase.h"
+#include "effecthooks.h"
 
 struct PureMechanicsBase {
     static BattleBase::context & turn(BattleBase &b, int player);
@@ -15,42 +16,108 @@ struct PureMechanicsBase {
     static void initMove(int num, Pokemon::gen gen, BattleBase::BasicMoveInfo &bmi);
 };
 
+/* The functions of a mechanic, by hook. They are registered by name
+   (functions["UponAttackSuccessful"] = &uas;) and then accessed by hook id */
+template <class function>
+class HookFunctions
+{
+public:
+    function &operator[](const QString &hook) {
+        return (*this)[EffectHook::id(hook)];
+    }
+
+    function &operator[](int hook) {
+        while (functions.size() <= hook) {
+            functions.push_back(NULL);
+        }
+        return functions[hook];
+    }
+
+    bool contains(int hook) const {
+        return hook < functions.size() && functions[hook];
+    }
+
+    function value(int hook) const {
+        return hook < functions.size() ? functions[hook] : NULL;
+    }
+
+    /* All the hook ids with a function are below that */
+    int size() const {
+        return functions.size();
+    }
+private:
+    QVector<function> functions;
+};
+
 template <class function>
 struct MechanicsBase : public PureMechanicsBase
 {
-    QHash<QString, function> functions;
+    MechanicsBase() : effectId(-1) {}
+
+    HookFunctions<function> functions;
+    /* The name of the mechanic as given by EffectHook::effect, for the moves */
+    int effectId;
+
+    static void addFunction(BattleBase::context &c, int hook, const QString &name, function f);
+    static void addFunction(BattleBase::context &c, int hook, int name, function f);
+    static void removeFunction(BattleBase::context &c, int hook, const QString &name);
+    static void removeFunction(BattleBase::context &c, int hook, int name);
 
-    static void addFunction(BattleBase::context &c, const QString &effect, const QString &name, function f);
-    static void removeFunction(BattleBase::context &c, const QString &effect, const QString &name);
+    /* Calls the functions registered for that hook in the context */
+    template <class Battle>
+    static void callFunctions(BattleBase::context &c, int hook, int source, int target, Battle &b, bool stopOnFail = false);
 };
 
 template <class function>
-void MechanicsBase<function>::addFunction(BattleBase::context &c, const QString &effect, const QString &name, function f)
+void MechanicsBase<function>::addFunction(BattleBase::context &c, int hook, const QString &name, function f)
 {
-    if (!c.contains("Effect_" + effect)) {
-        QVariant v = QVariant::fromValue(QSharedPointer<QSet<QString> >(new QSet<QString>()));
-        c.insert("Effect_" + effect, v);
-    }
-    c["Effect_"+effect].value<QSharedPointer<QSet<QString> > >()->insert(name);
+    addFunction(c, hook, EffectHook::effect(name), f);
+}
 
-    QVariant v;
-    v.setValue(f);
-    c.insert("Effect_" + effect + "_" + name,v);
+template <class function>
+void MechanicsBase<function>::addFunction(BattleBase::context &c, int hook, int name, function f)
+{
+    c.effects.add(hook, name, reinterpret_cast<EffectTable::Function>(f));
 }
 
 template <class function>
-void MechanicsBase<function>::removeFunction(BattleBase::context &c, const QString &effect, const QString &name)
+void MechanicsBase<function>::removeFunction(BattleBase::context &c, int hook, const QString &name)
 {
-    if (!c.contains("Effect_" + effect)) {
-    return;
+    if (!c.effects.contains(hook)) {
+        return;
     }
-    c["Effect_" + effect].value<QSharedPointer<QSet<QString> > >()->remove(name);
-    c.remove("Effect_" + effect + "_" + name);
+    removeFunction(c, hook, EffectHook::effect(name));
 }
 
+template <class function>
+void MechanicsBase<function>::removeFunction(BattleBase::context &c, int hook, int name)
+{
+    c.effects.remove(hook, name);
+}
 
-/* For use with QVariants */
-Q_DECLARE_METATYPE(QSharedPointer<QSet<QString> >)
+template <class function>
+template <class Battle>
+void MechanicsBase<function>::callFunctions(BattleBase::context &c, int hook, int source, int target, Battle &b, bool stopOnFail)
+{
+    if (!c.effects.contains(hook)) {
+        return;
+    }
+
+    /* If a pokemon dies from leech seed, its status changes and so the nightmare
+       function is removed while we are going through the effects. So we go through
+       a copy of the names and fetch each function right before calling it */
+    QVarLengthArray<int, 8> names;
+    c.effects.names(hook, names);
+
+    for (int i = 0; i < names.size(); i++) {
+        function f = reinterpret_cast<function>(c.effects.function(hook, names[i]));
 
+        if (f)
+            f(source, target, b);
+
+        if (stopOnFail && b.testFail(source))
+            return;
+    }
+}
 
 #endif // MECHANICSBASE_H
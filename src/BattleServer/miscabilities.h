@@ -34,7 +34,7 @@ struct AMMagicBounce : public AM
     }
 
     static void uas (int, int, BS &b) {
-        addFunction(b.battleMemory(), "DetermineGeneralAttackFailure2", "MagicBounce", &dgaf);
+        addFunction(b.battleMemory(), EffectHook::DetermineGeneralAttackFailure2, "MagicBounce", &dgaf);
     }
 
     static void dgaf(int s, int t, BS &b) {
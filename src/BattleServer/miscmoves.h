@@ -106,8 +106,8 @@ struct MMDisable : public MM
         } else {
             b.counters(t).addCounter(BC::Disable, 3 + (b.randint(4)));
             poke(b,t)["DisabledMove"] = mv;
-            addFunction(poke(b,t), "MovesPossible", "Disable", &msp);
-            addFunction(poke(b,t), "MovePossible", "Disable", &mp);
+            addFunction(poke(b,t), EffectHook::MovesPossible, "Disable", &msp);
+            addFunction(poke(b,t), EffectHook::MovePossible, "Disable", &mp);
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), t, "Disable", &et);
         }
     }
@@ -115,8 +115,8 @@ struct MMDisable : public MM
     static void et (int s, int, BS &b)
     {
         if (b.counters(s).count(BC::Disable) < 0) {
-            removeFunction(poke(b,s), "MovesPossible", "Disable");
-            removeFunction(poke(b,s), "MovePossible", "Disable");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "Disable");
+            removeFunction(poke(b,s), EffectHook::MovePossible, "Disable");
             b.removeEndTurnEffect(BS::PokeEffect, s, "Disable");
             b.sendMoveMessage(28,2,s);
             b.counters(s).removeCounter(BC::Disable);
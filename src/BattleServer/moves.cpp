@@ -47,18 +47,21 @@ void MoveEffect::setup(int num, int source, int target, BattleBase &b)
             MoveMechanics &m = mechanics[specialEffect];
             QString &n = names[specialEffect];
 
-            QHash<QString, MoveMechanics::function>::iterator i;
-
             size_t pos = s.find('-');
             if (pos != std::string::npos) {
                 MM::turn(b,source)[n+"_Arg"] = specialEffectS.mid(pos+1);
             }
 
-            for(i = m.functions.begin(); i != m.functions.end(); ++i) {
-                if (i.key() == "OnSetup") {
-                    i.value()(source,target,b);
+            for (int hook = 0; hook < m.functions.size(); hook++) {
+                MoveMechanics::function f = m.functions.value(hook);
+
+                if (!f) {
+                    continue;
+                }
+                if (hook == EffectHook::OnSetup) {
+                    f(source,target,b);
                 } else {
-                    Mechanics::addFunction(MM::turn(b,source), i.key(), n, i.value());
+                    Mechanics::addFunction(MM::turn(b,source), hook, m.effectId, f);
                 }
             }
         }
@@ -88,15 +91,10 @@ void MoveEffect::unsetup(int num, int source, BattleBase &b)
             }
 
             MoveMechanics &m = mechanics[specialEffect];
-            QString &n = names[specialEffect];
-
-            QHash<QString, MoveMechanics::function>::iterator i;
 
-            for(i = m.functions.begin(); i != m.functions.end(); ++i) {
-                if (i.key() == "OnSetup") {
-                    ;
-                } else {
-                    Mechanics::removeFunction(MM::turn(b,source), i.key(), n);
+            for (int hook = 0; hook < m.functions.size(); hook++) {
+                if (hook != EffectHook::OnSetup && m.functions.contains(hook)) {
+                    Mechanics::removeFunction(MM::turn(b,source), hook, m.effectId);
                 }
             }
         }
@@ -273,10 +271,10 @@ struct MMBatonPass : public MM
             if on both the passed & the passer */
         c.remove("ChoiceMemory");
 
-        turn(b,s)["BatonPassData"] = c;
+        turn(b,s)["BatonPassData"] = QVariant::fromValue(c);
         turn(b,s)["BatonPassed"] = true;
 
-        addFunction(turn(b,s), "UponSwitchIn", "BatonPass", &usi);
+        addFunction(turn(b,s), EffectHook::UponSwitchIn, "BatonPass", &usi);
         b.requestSwitch(s);
     }
 
@@ -285,7 +283,9 @@ struct MMBatonPass : public MM
             return;
         }
         turn(b,s)["BatonPassed"] = false;
-        merge(poke(b,s), turn(b,s)["BatonPassData"].value<BS::context>());
+        BS::context data = turn(b,s)["BatonPassData"].value<BS::context>();
+        merge(poke(b,s), data);
+        poke(b,s).effects.merge(data.effects);
 
         /* If the poke before is confused, carry on that status */
         if (turn(b,s)["BatonPassConfusion"].toInt() > 0) {
@@ -385,12 +385,12 @@ struct MMBlastBurn : public MM
         if (b.gen() >= 2) {
             return;
         }
-        addFunction(poke(b, s), "TurnSettings", "BlastBurn", &ts);
+        addFunction(poke(b, s), EffectHook::TurnSettings, "BlastBurn", &ts);
         poke(b, s)["BlastBurnTurn"] = b.turn();
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(poke(b, s), "TurnSettings", "BlastBurn", &ts);
+        addFunction(poke(b, s), EffectHook::TurnSettings, "BlastBurn", &ts);
         poke(b, s)["BlastBurnTurn"] = b.turn();
     }
 
@@ -402,13 +402,13 @@ struct MMBlastBurn : public MM
         fturn(b, s).add(TM::NoChoice);
         turn(b,s)["AutomaticMove"] = 0;//So that confusion won't be inflicted on recharge
 
-        addFunction(turn(b,s), "MoveSettings", "BlastBurn", &ms);
+        addFunction(turn(b,s), EffectHook::MoveSettings, "BlastBurn", &ms);
     }
 
     static void ms(int s, int, BS &b) {
         turn(b, s)["TellPlayers"] = false;
         tmove(b, s).targets = Move::User;
-        addFunction(turn(b,s), "UponAttackSuccessful", "BlastBurn", &aas);
+        addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "BlastBurn", &aas);
     }
 
     static void aas(int s, int, BS &b) {
@@ -445,7 +445,7 @@ struct MMCharge : public MM
 
     static void uas(int s, int, BS &b) {
         poke(b, s)["ChargedTurn"] = b.turn();
-        addFunction(poke(b,s), "BasePowerModifier", "Charge", &bcd);
+        addFunction(poke(b,s), EffectHook::BasePowerModifier, "Charge", &bcd);
         b.sendMoveMessage(18, 0, s, type(b,s));
         if (b.gen().num == 4) {
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), s, "Charge", &et);
@@ -672,7 +672,7 @@ struct MMDestinyBond : public MM
 
     static void uas(int s, int, BS &b) {
         poke(b,s)["DestinyBondTurn"] = b.turn();
-        addFunction(poke(b,s), "AfterKoedByStraightAttack", "DestinyBond", &akbsa);
+        addFunction(poke(b,s), EffectHook::AfterKoedByStraightAttack, "DestinyBond", &akbsa);
         b.sendMoveMessage(26, 1, s, Pokemon::Ghost);
     }
 
@@ -762,7 +762,7 @@ struct MMDetect : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.turnMemory(s), "DetermineProtectedAgainstAttack", "Detect", &dgaf);
+        addFunction(b.turnMemory(s), EffectHook::DetermineProtectedAgainstAttack, "Detect", &dgaf);
         turn(b,s)["DetectUsed"] = true;
         b.sendMoveMessage(27, 0, s, Pokemon::Normal);
     }
@@ -1187,8 +1187,8 @@ struct MMCopycat : public MM
     }
 
     static void uas(int s, int t, BS &b) {
-        removeFunction(turn(b,s), "UponAttackSuccessful", "Copycat");
-        removeFunction(turn(b,s), "DetermineAttackFailure", "Copycat");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Copycat");
+        removeFunction(turn(b,s), EffectHook::DetermineAttackFailure, "Copycat");
         int attack = turn(b,s)["CopycatMove"].toInt();
         BS::BasicMoveInfo info = tmove(b,s);
         MoveEffect::reuseMove(attack, s, t, b);
@@ -1233,8 +1233,8 @@ struct MMAssist : public MM
 
     static void uas(int s, int, BS &b)
     {
-        removeFunction(turn(b,s), "UponAttackSuccessful", "Assist");
-        removeFunction(turn(b,s), "DetermineAttackFailure", "Assist");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Assist");
+        removeFunction(turn(b,s), EffectHook::DetermineAttackFailure, "Assist");
         int attack = turn(b,s)["AssistMove"].toInt();
         BS::BasicMoveInfo info = tmove(b,s);
         MoveEffect::setup(attack, s, s, b);
@@ -1277,8 +1277,8 @@ struct MMBide : public MM
     }
 
     static void uas(int s, int , BS &b) {
-        addFunction(poke(b,s), "TurnSettings", "Bide", &ts);
-        addFunction(turn(b,s), "UponOffensiveDamageReceived", "Bide", &udi);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "Bide", &ts);
+        addFunction(turn(b,s), EffectHook::UponOffensiveDamageReceived, "Bide", &udi);
         poke(b,s)["BideDamageCount"] = 0;
         poke(b,s)["BideTurn"] = b.turn();
     }
@@ -1313,16 +1313,16 @@ struct MMBide : public MM
         if (_turn +1 == b.turn()) {
             tmove(b, s).targets = Move::User;
             tmove(b, s).power = 0;
-            addFunction(turn(b,s), "UponAttackSuccessful", "Bide", &uas2);
+            addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bide", &uas2);
         } else {
             tmove(b, s).targets = Move::ChosenTarget;
             tmove(b, s).power = 1;
             tmove(b, s).type = Pokemon::Curse;
-            addFunction(turn(b,s), "BeforeTargetList", "Bide", &btl);
-            addFunction(turn(b,s), "CustomAttackingDamage", "Bide", &ccd);
-            addFunction(turn(b,s), "DetermineAttackFailure", "Bide",&daf);
-            removeFunction(poke(b,s), "TurnSettings", "Bide");
-            removeFunction(turn(b,s), "UponAttackSuccessful", "Bide");
+            addFunction(turn(b,s), EffectHook::BeforeTargetList, "Bide", &btl);
+            addFunction(turn(b,s), EffectHook::CustomAttackingDamage, "Bide", &ccd);
+            addFunction(turn(b,s), EffectHook::DetermineAttackFailure, "Bide",&daf);
+            removeFunction(poke(b,s), EffectHook::TurnSettings, "Bide");
+            removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bide");
         }
     }
 
@@ -1332,7 +1332,7 @@ struct MMBide : public MM
             return;
         }
 
-        addFunction(turn(b,s),"UponOffensiveDamageReceived", "Bide", &udi);
+        addFunction(turn(b,s),EffectHook::UponOffensiveDamageReceived, "Bide", &udi);
         MoveEffect::setup(Move::Bide, s, s, b);
         fturn(b, s).add(TM::NoChoice);
     }
@@ -1376,13 +1376,13 @@ struct MMBind : public MM
             if (!b.linked(s, "Trapped")) {
                 poke(b,s).remove("TrappedBy");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "Bind");
-                removeFunction(poke(b,s), "TurnSettings", "Bind");
+                removeFunction(poke(b,s), EffectHook::TurnSettings, "Bind");
                 return;
             }
             if (count <= 0) {
                 poke(b,s).remove("TrappedBy");
                 b.removeEndTurnEffect(BS::PokeEffect, s, "Bind");
-                removeFunction(poke(b,s), "TurnSettings", "Bind");
+                removeFunction(poke(b,s), EffectHook::TurnSettings, "Bind");
                 if (count == 0)
                     b.sendMoveMessage(10,1,s,MoveInfo::Type(move, b.gen()),s,move);
             } else {
@@ -1462,9 +1462,9 @@ struct MMBounce : public MM
             b.sendItemMessage(11,s);
             b.disposeItem(s);
 
-            removeFunction(turn(b,s), "UponAttackSuccessful", "Bounce");
+            removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bounce");
             if (move(b,s) == ShadowForce || move(b,s) == PhantomForce) {
-                addFunction(turn(b,s), "UponAttackSuccessful", "Bounce", &MMFeint::daf);
+                addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bounce", &MMFeint::daf);
                 if (b.targetList.size() > 0) {
                     if (poke(b, b.targetList.front()).value("Minimize").toBool()) {
                         tmove(b, s).accuracy = 0;
@@ -1493,12 +1493,12 @@ struct MMBounce : public MM
             int move = poke(b,s)["2TurnMove"].toInt();
 
             initMove(move, b.gen(),tmove(b,s));
-            addFunction(turn(b,s), "EvenWhenCantMove", "Bounce", &ewc);
+            addFunction(turn(b,s), EffectHook::EvenWhenCantMove, "Bounce", &ewc);
 
             if (move == ShadowForce || move == PhantomForce) {
-                addFunction(turn(b,s), "BeforeTargetList", "Bounce", &MMStomp::btl);
-                addFunction(turn(b,s), "BeforeCalculatingDamage", "Bounce", &MMStomp::bcd);
-                addFunction(turn(b,s), "UponAttackSuccessful", "Bounce", &MMFeint::daf);
+                addFunction(turn(b,s), EffectHook::BeforeTargetList, "Bounce", &MMStomp::btl);
+                addFunction(turn(b,s), EffectHook::BeforeCalculatingDamage, "Bounce", &MMStomp::bcd);
+                addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bounce", &MMFeint::daf);
             } else if (move == SkyDrop) {
                 if (!b.linked(s, "FreeFalledPokemon")) {
                     /* Force it to fail if the target is no longer alive */
@@ -1507,11 +1507,11 @@ struct MMBounce : public MM
                     /* FreeFall sure-hits the foe once it caught it... */
                     tmove(b,s).accuracy = 0;
                 }
-                addFunction(turn(b,s), "BeforeCalculatingDamage", "Bounce", &bcd);
+                addFunction(turn(b,s), EffectHook::BeforeCalculatingDamage, "Bounce", &bcd);
             }
         }
         //In ADV, the turn can end if for exemple the foe explodes, in which case TurnSettings will be needed next turn too
-        //removeFunction(poke(b,s), "TurnSettings", "Bounce");
+        //removeFunction(poke(b,s), EffectHook::TurnSettings, "Bounce");
     }
 
     /* Called with freefall */
@@ -1569,8 +1569,8 @@ struct MMBounce : public MM
         poke(b,s)["VulnerableMoves"].setValue(vuln_moves);
         poke(b,s)["VulnerableMults"].setValue(vuln_mult);
         b.changeSprite(s, -1);
-        addFunction(poke(b,s), "TestEvasion", "Bounce", &dgaf);
-        addFunction(poke(b,s), "TurnSettings", "Bounce", &ts);
+        addFunction(poke(b,s), EffectHook::TestEvasion, "Bounce", &dgaf);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "Bounce", &ts);
 
         int att = move(b,s);
         /* Those moves protect from weather when in the invulnerable state */
@@ -1580,9 +1580,9 @@ struct MMBounce : public MM
             b.link(s, t, "FreeFalled");
             b.link(t, s, "FreeFalledPokemon");
             b.changeSprite(t, -1);
-            addFunction(poke(b,t), "TestEvasion", "Bounce", &dgaf);
-            addFunction(poke(b,t), "DetermineAttackPossible", "Bounce", &dap);
-            addFunction(poke(b,s), "AfterBeingKoed", "Bounce", &ewc);
+            addFunction(poke(b,t), EffectHook::TestEvasion, "Bounce", &dgaf);
+            addFunction(poke(b,t), EffectHook::DetermineAttackPossible, "Bounce", &dap);
+            addFunction(poke(b,s), EffectHook::AfterBeingKoed, "Bounce", &ewc);
             poke(b,t)["VulnerableMoves"].setValue(vuln_moves);
             poke(b,t)["VulnerableMults"].setValue(vuln_mult);
         }
@@ -1789,7 +1789,7 @@ struct MMDoomDesire : public MM
                     b.notify(BS::All, BattleCommands::Effective, s, quint8(typemod > 0 ? 8 : (typemod < 0 ? 2 : 4)));
                     b.inflictDamage(s, damage, doomuser, true, true);
                     slot(b,s)["DoomDesireDamagingNow"] = false;
-                    b.callaeffects(s, doomuser, "AfterBeingPlumetted");
+                    b.callaeffects(s, doomuser, EffectHook::AfterBeingPlumetted);
                 }
             }
         }
@@ -1827,7 +1827,7 @@ struct MMEmbargo : public MM
             b.sendMoveMessage(32,1,s,0);
             poke(b,s)["Embargoed"] = false;
             b.removeEndTurnEffect(BS::PokeEffect, s, "Embargo");
-            b.callieffects(s, s, "UponReactivation");
+            b.callieffects(s, s, EffectHook::UponReactivation);
         }
     }
 };
@@ -1936,7 +1936,7 @@ struct MMEncore : public MM
                     }
                 }
             }
-            addFunction(poke(b,t), "MovesPossible", "Encore", &msp);
+            addFunction(poke(b,t), EffectHook::MovesPossible, "Encore", &msp);
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), t, "Encore", &et);
         }
     }
@@ -1959,7 +1959,7 @@ struct MMEncore : public MM
             }
         }
         if (b.counters(s).count(BC::Encore) < 0) {
-            removeFunction(poke(b,s), "MovesPossible", "Encore");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "Encore");
             b.removeEndTurnEffect(BS::PokeEffect, s, "Encore");
 
             if (b.counters(s).hasCounter(BC::Encore)) {
@@ -2009,7 +2009,7 @@ struct MMEndure : public MM
 
     static void uas(int s, int, BS &b) {
         turn(b,s)["CannotBeKoed"] = true;
-        addFunction(turn(b,s), "UponSelfSurvival", "Endure", &uodr);
+        addFunction(turn(b,s), EffectHook::UponSelfSurvival, "Endure", &uodr);
         b.sendMoveMessage(35,1,s);
     }
 
@@ -2027,7 +2027,7 @@ struct MMFalseSwipe : public MM
 
     static void bcd(int s, int t, BS &b) {
         turn(b,t)["CannotBeKoedBy"] = s;
-        addFunction(turn(b,t), "UponSelfSurvival", "FalseSwipe", &uss);
+        addFunction(turn(b,t), EffectHook::UponSelfSurvival, "FalseSwipe", &uss);
     }
 
     static void uss(int s, int, BS &b) {
@@ -2042,11 +2042,11 @@ struct MMFocusEnergy : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(poke(b,s), "TurnSettings", "FocusEnergy", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "FocusEnergy", &ts);
         b.sendMoveMessage(46,0,s);
     }
     static void ts(int s, int, BS &b) {
-        addFunction(turn(b,s), "BeforeTargetList", "FocusEnergy", &btl);
+        addFunction(turn(b,s), EffectHook::BeforeTargetList, "FocusEnergy", &btl);
     }
     static void btl(int s, int, BS &b) {
         if (tmove(b,s).power > 0) {
@@ -2248,7 +2248,7 @@ struct MMFling : public MM
                     //Gen 4 doesn't allow Embargoed Targets to use the flung item
                     if (b.gen() > 4 || !isEmbargoed) {
                         int oppitem = b.poke(t).item();
-                        ItemEffect::activate("UponSetup", item, t,s,b);
+                        ItemEffect::activate(EffectHook::UponSetup, item, t,s,b);
                         b.poke(t).item() = oppitem; /* the effect of mental herb / white herb may have disposed of the foes item */
                     }
                 } else if (item == Item::RazorFang || item == Item::KingsRock) {
@@ -2302,7 +2302,7 @@ struct MMFollowMe : public MM
             why we need a switch count, or that */
         poke(b,s)["FollowMe"] = true;
 
-        addFunction(b.battleMemory(), "GeneralTargetChange", "FollowMe", &gtc);
+        addFunction(b.battleMemory(), EffectHook::GeneralTargetChange, "FollowMe", &gtc);
     }
 
     struct FM : public QSet<int> {
@@ -2403,8 +2403,8 @@ struct MMGravity : public MM
         }
 
         b.addEndTurnEffect(BS::FieldEffect, bracket(b.gen()), 0, "Gravity", &et);
-        addFunction(b.battleMemory(), "MovesPossible", "Gravity", &msp);
-        addFunction(b.battleMemory(), "MovePossible", "Gravity", &mp);
+        addFunction(b.battleMemory(), EffectHook::MovesPossible, "Gravity", &msp);
+        addFunction(b.battleMemory(), EffectHook::MovePossible, "Gravity", &mp);
     }
 
     static void et(int s, int, BS &b) {
@@ -2413,7 +2413,7 @@ struct MMGravity : public MM
             if (count <= 0) {
                 b.sendMoveMessage(53,1,s,Pokemon::Psychic);
                 b.removeEndTurnEffect(BS::FieldEffect, 0, "Gravity");
-                removeFunction(b.battleMemory(), "MovesPossible", "Gravity");
+                removeFunction(b.battleMemory(), EffectHook::MovesPossible, "Gravity");
                 b.battleMemory()["Gravity"] = false;
             } else {
                 b.battleMemory()["GravityCount"] = count;
@@ -2489,7 +2489,7 @@ struct MMMetronome : public MM
     }
 
     static void uas(int s, int t, BS &b) {
-        removeFunction(turn(b,s), "UponAttackSuccessful", "Metronome");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Metronome");
 
         while (1) {
             int move = b.randint(MoveInfo::NumberOfMoves()-1)+1;
@@ -2546,7 +2546,7 @@ struct MMWideGuard : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.teamMemory(b.player(s)), "DetermineProtectedAgainstAttack", "WideGuard", &dgaf);
+        addFunction(b.teamMemory(b.player(s)), EffectHook::DetermineProtectedAgainstAttack, "WideGuard", &dgaf);
         team(b,b.player(s))["WideGuardUsed"] = b.turn();
         b.sendMoveMessage(169, 0, s, Pokemon::Normal);
     }
@@ -2585,7 +2585,7 @@ struct MMQuickGuard : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.teamMemory(b.player(s)), "DetermineProtectedAgainstAttack", "FastGuard", &dgaf);
+        addFunction(b.teamMemory(b.player(s)), EffectHook::DetermineProtectedAgainstAttack, "FastGuard", &dgaf);
         team(b,b.player(s))["QuickGuardUsed"] = b.turn();
         b.sendMoveMessage(170, 0, s, Pokemon::Normal);
     }
@@ -2776,7 +2776,7 @@ struct MMPerishSong : public MM
                 continue;
             }
             //Soundproof, Liquid Voice + Storm Drain/Water Absorb, etc.
-            b.callaeffects(t, s, "OpponentBlock");
+            b.callaeffects(t, s, EffectHook::OpponentBlock);
             //Second check is for Prankster blocks (Dazzling, Prankster on Dark type, etc.). Inherently checks for gen 7 anyway
             if (turn(b,t).contains(QString("Block%1").arg(b.attackCount())) || b.blockPriority(s, t)) {
                 continue;
@@ -3137,7 +3137,7 @@ struct MMSpikes : public MM
     static void uas(int s, int, BS &b) {
         int t = b.opponent(b.player(s));
         team(b,t)["Spikes"] = std::min(3, team(b,t).value("Spikes").toInt()+1);
-        addFunction(team(b,t), "UponSwitchIn", "Spikes", &usi);
+        addFunction(team(b,t), EffectHook::UponSwitchIn, "Spikes", &usi);
         b.sendMoveMessage(121, 0, s, 0, t);
     }
 
@@ -3182,7 +3182,7 @@ struct MMStealthRock : public MM
     static void uas(int s, int, BS &b) {
         int t = b.opponent(b.player(s));
         team(b,t)["StealthRock"] = true;
-        addFunction(team(b,t), "UponSwitchIn", "StealthRock", &usi);
+        addFunction(team(b,t), EffectHook::UponSwitchIn, "StealthRock", &usi);
         b.sendMoveMessage(124,0,s,Pokemon::Rock,t);
     }
 
@@ -3214,13 +3214,13 @@ struct MMToxicSpikes : public MM
         int t = b.opponent(b.player(s));
         team(b,t)["ToxicSpikes"] = team(b,t)["ToxicSpikes"].toInt()+1;
         b.sendMoveMessage(136, 0, s, Pokemon::Poison, t);
-        addFunction(team(b,t), "UponSwitchIn", "ToxicSpikes", &usi);
+        addFunction(team(b,t), EffectHook::UponSwitchIn, "ToxicSpikes", &usi);
     }
 
     static void usi(int source, int s, BS &b) {
         if (!b.koed(s) && b.hasType(s, Pokemon::Poison) && !b.isFlying(s) && team(b,source).value("ToxicSpikes").toInt() > 0) {
             team(b,source).remove("ToxicSpikes");
-            removeFunction(team(b,source), "UponSwitchIn", "ToxicSpikes");
+            removeFunction(team(b,source), EffectHook::UponSwitchIn, "ToxicSpikes");
             b.sendMoveMessage(136, 1, s, Pokemon::Poison);
             return;
         }
@@ -3320,7 +3320,7 @@ struct MMSubstitute : public MM
         fpoke(b,s).substituteLife = b.poke(s).totalLifePoints()/4;
         b.sendMoveMessage(128,4,s);
         b.notifySub(s,true);
-        //addFunction(poke(b,s), "BlockTurnEffects", "Substitute", &bte);
+        //addFunction(poke(b,s), EffectHook::BlockTurnEffects, "Substitute", &bte);
     }
 };
 
@@ -3359,11 +3359,11 @@ struct MMAttract : public MM
             b.disposeItem(t);
         } else {
             b.link(s, t, "Attract");
-            addFunction(poke(b,t), "DetermineAttackPossible", "Attract", &pda);
+            addFunction(poke(b,t), EffectHook::DetermineAttackPossible, "Attract", &pda);
 
             if (b.hasWorkingItem(t, Item::DestinyKnot) && b.isSeductionPossible(t, s) && !b.linked(s, "Attract")) {
                 b.link(t, s, "Attract");
-                addFunction(poke(b,s), "DetermineAttackPossible", "Attract", &pda);
+                addFunction(poke(b,s), EffectHook::DetermineAttackPossible, "Attract", &pda);
                 b.sendItemMessage(41,t,0,s);
             }
         }
@@ -3519,8 +3519,8 @@ struct MMTaunt : public MM
             b.sendItemMessage(7,t);
             b.disposeItem(t);
         } else {
-            addFunction(poke(b,t), "MovesPossible", "Taunt", &msp);
-            addFunction(poke(b,t), "MovePossible", "Taunt", &mp);
+            addFunction(poke(b,t), EffectHook::MovesPossible, "Taunt", &msp);
+            addFunction(poke(b,t), EffectHook::MovePossible, "Taunt", &mp);
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), t, "Taunt", &et);
 
             if (b.gen() <= 3) {
@@ -3539,8 +3539,8 @@ struct MMTaunt : public MM
             return;
 
         if (b.counters(s).count(BC::Taunt) < 0) {
-            removeFunction(poke(b,s), "MovesPossible", "Taunt");
-            removeFunction(poke(b,s), "MovePossible", "Taunt");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "Taunt");
+            removeFunction(poke(b,s), EffectHook::MovePossible, "Taunt");
             b.removeEndTurnEffect(BS::PokeEffect, s, "Taunt");
             if (b.gen() >= 4)
                 b.sendMoveMessage(134,2,s,Pokemon::Dark);
@@ -3633,7 +3633,7 @@ struct MMGrudge : public MM
 
     static void uas(int s, int, BS &b) {
         poke(b,s)["GrudgeTurn"] = b.turn();
-        addFunction(poke(b,s), "AfterKoedByStraightAttack", "Grudge", &akbst);
+        addFunction(poke(b,s), EffectHook::AfterKoedByStraightAttack, "Grudge", &akbst);
     }
 
     static void akbst(int s, int t, BS &b) {
@@ -3780,7 +3780,7 @@ struct MMHealingWish : public MM
         if (!turn(b,s).contains("HealingWishSuccess"))
             return;
         /* In gen 5, it triggers before entry hazards */
-        addFunction(turn(b,s), b.gen().num == 4 ? "AfterSwitchIn" : "UponSwitchIn", "HealingWish", &asi);
+        addFunction(turn(b,s), b.gen().num == 4 ? EffectHook::AfterSwitchIn : EffectHook::UponSwitchIn, "HealingWish", &asi);
 
         /* On gen 5 and further, the pokemon is switched at the end of the turn! */
         if (b.gen() <= 4)
@@ -3800,7 +3800,7 @@ struct MMHealingWish : public MM
                     b.gainPP(s, i, 100);
                 }
             }
-            removeFunction(turn(b,s), "AfterSwitchIn", "HealingWish");
+            removeFunction(turn(b,s), EffectHook::AfterSwitchIn, "HealingWish");
         }
     }
 };
@@ -3856,8 +3856,8 @@ struct MMHealBlock: public MM
             poke(b,t)["HealBlockCount"] = 5;
             poke(b,t)["HealBlocked"] = true;
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), t, "HealBlock", &et);
-            addFunction(poke(b,t), "MovePossible", "HealBlock", &mp);
-            addFunction(poke(b,t), "MovesPossible", "HealBlock", &msp);
+            addFunction(poke(b,t), EffectHook::MovePossible, "HealBlock", &mp);
+            addFunction(poke(b,t), EffectHook::MovesPossible, "HealBlock", &msp);
         }
     }
     static void et(int s, int , BS &b) {
@@ -3867,8 +3867,8 @@ struct MMHealBlock: public MM
         if (count == 0) {
             b.sendMoveMessage(59,1,s,Type::Psychic);
             b.removeEndTurnEffect(BS::PokeEffect, s, "HealBlock");
-            removeFunction(poke(b,s), "MovesPossible", "HealBlock");
-            removeFunction(poke(b,s), "MovePossible", "HealBlock");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "HealBlock");
+            removeFunction(poke(b,s), EffectHook::MovePossible, "HealBlock");
             poke(b,s).remove("HealBlocked");
         }
     }
@@ -3978,7 +3978,7 @@ struct MMIceBall : public MM
             poke(b,s)["IceBallCount"] = count*2+1;
         }
         poke(b,s)["LastBallTurn"] = b.turn();
-        addFunction(poke(b,s), "TurnSettings", "IceBall", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "IceBall", &ts);
     }
 
     static void ts(int s, int t, BS &b) {
@@ -4019,8 +4019,8 @@ struct MMImprison : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.battleMemory(), "MovePossible", "Imprison", &mp);
-        addFunction(b.battleMemory(), "MovesPossible", "Imprison", &msp);
+        addFunction(b.battleMemory(), EffectHook::MovePossible, "Imprison", &mp);
+        addFunction(b.battleMemory(), EffectHook::MovesPossible, "Imprison", &msp);
         poke(b,s)["Imprisoner"] = true;
         b.sendMoveMessage(67,0,s,type(b,s));
     }
@@ -4243,7 +4243,7 @@ struct MMMagicCoat : public MM
     }
 
     static void uas (int s, int, BS &b) {
-        addFunction(b.battleMemory(), "DetermineGeneralAttackFailure2", "MagicCoat", &dgaf);
+        addFunction(b.battleMemory(), EffectHook::DetermineGeneralAttackFailure2, "MagicCoat", &dgaf);
         turn(b,s)["MagicCoated"] = true;
         b.sendMoveMessage(76,0,s,Pokemon::Psychic);
     }
@@ -4423,10 +4423,10 @@ struct MMMeFirst : public MM
     }
 
     static void uas(int s, int t, BS &b) {
-        removeFunction(turn(b,s), "DetermineAttackFailure", "MeFirst");
-        removeFunction(turn(b,s), "UponAttackSuccessful", "MeFirst");
-        removeFunction(turn(b,s), "MoveSettings", "MeFirst");
-        addFunction(turn(b,s), "BasePowerModifier", "MeFirst", &bpm);
+        removeFunction(turn(b,s), EffectHook::DetermineAttackFailure, "MeFirst");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "MeFirst");
+        removeFunction(turn(b,s), EffectHook::MoveSettings, "MeFirst");
+        addFunction(turn(b,s), EffectHook::BasePowerModifier, "MeFirst", &bpm);
         int move = turn(b,s)["MeFirstAttack"].toInt();
         MoveEffect::reuseMove(move, s, t, b);
     }
@@ -4535,8 +4535,8 @@ struct MMMirrorMove : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        removeFunction(turn(b,s), "DetermineAttackFailure", "MirrorMove");
-        removeFunction(turn(b,s), "UponAttackSuccessful", "MirrorMove");
+        removeFunction(turn(b,s), EffectHook::DetermineAttackFailure, "MirrorMove");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "MirrorMove");
 
         int move = poke(b,s)["MirrorMoveMemory"].toInt();
         BS::BasicMoveInfo info = tmove(b,s);
@@ -4654,13 +4654,13 @@ struct MMNightMare : public MM
     static void uas(int, int t, BS &b) {
         b.sendMoveMessage(92, 0, t, Pokemon::Ghost);
         poke(b,t)["HavingNightmares"] = true;
-        addFunction(poke(b,t),"AfterStatusChange", "NightMare", &asc);
+        addFunction(poke(b,t),EffectHook::AfterStatusChange, "NightMare", &asc);
         b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), t, "NightMare", &et);
     }
 
     static void asc(int s, int, BS &b) {
         if (b.poke(s).status() != Pokemon::Asleep) {
-            removeFunction(poke(b,s),"AfterStatusChange", "NightMare");
+            removeFunction(poke(b,s),EffectHook::AfterStatusChange, "NightMare");
             b.removeEndTurnEffect(BS::PokeEffect, s, "NightMare");
         }
     }
@@ -4780,13 +4780,13 @@ struct MMRazorWind : public MM
                 tmove(b, s).statAffected = 0;
                 tmove(b, s).status = Pokemon::Fine;
                 tmove(b, s).targets = Move::User;
-                addFunction(poke(b,s), "TurnSettings", "RazorWind", &ts);
+                addFunction(poke(b,s), EffectHook::TurnSettings, "RazorWind", &ts);
             }
         }
     }
 
     static void ts(int s, int, BS &b) {
-        removeFunction(poke(b,s), "TurnSettings", "RazorWind");
+        removeFunction(poke(b,s), EffectHook::TurnSettings, "RazorWind");
         fturn(b,s).add(TM::NoChoice);
         int mv = poke(b,s)["ChargingMove"].toInt();
         MoveEffect::setup(mv,s,s,b);
@@ -4851,7 +4851,7 @@ struct MMRage : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(poke(b,s), "UponOffensiveDamageReceived", "Rage", &uodr);
+        addFunction(poke(b,s), EffectHook::UponOffensiveDamageReceived, "Rage", &uodr);
 
         if (poke(b,s).contains("RageBuilt") && poke(b,s)["AnyLastMoveUsed"] == Move::Rage) {
             poke(b,s).remove("AttractBy");
@@ -4999,7 +4999,7 @@ struct MMSleepTalk : public MM
 
     static void daf(int s, int, BS &b) {
         poke(b,s)["SleepTalking"] = true;
-        b.callpeffects(s, s, "MovesPossible");
+        b.callpeffects(s, s, EffectHook::MovesPossible);
         QList<int> mp;
 
         for (int i = 0; i < 4; i++) {
@@ -5023,8 +5023,8 @@ struct MMSleepTalk : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        removeFunction(turn(b,s), "DetermineAttackFailure", "SleepTalk");
-        removeFunction(turn(b,s), "UponAttackSuccessful", "SleepTalk");
+        removeFunction(turn(b,s), EffectHook::DetermineAttackFailure, "SleepTalk");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "SleepTalk");
         int mv = turn(b,s)["SleepTalkedMove"].toInt();
         BS::BasicMoveInfo info = tmove(b,s);
         MoveEffect::unsetup(Move::SleepTalk, s, b);
@@ -5081,7 +5081,7 @@ struct MMSnatch : public MM
     }
 
     static void uas (int s, int, BS &b) {
-        addFunction(b.battleMemory(), "BeforeTargetList", "Snatch", &dgaf);
+        addFunction(b.battleMemory(), EffectHook::BeforeTargetList, "Snatch", &dgaf);
         b.battleMemory()["Snatcher"] = s;
         turn(b,s)["Snatcher"] = true;
         b.sendMoveMessage(118,1,s,type(b,s));
@@ -5102,7 +5102,7 @@ struct MMSnatch : public MM
             if (snatched) {
                 b.fail(s,118,0,type(b,snatcher), snatcher);
                 /* Now Snatching ... */
-                removeFunction(turn(b,snatcher), "UponAttackSuccessful", "Snatch");
+                removeFunction(turn(b,snatcher), EffectHook::UponAttackSuccessful, "Snatch");
                 turn(b,snatcher).remove("Snatcher");
                 b.battleMemory().remove("Snatcher");                
                 turn(b,snatcher)["StealingAttack"] = true; //The snatched move won't activate Protean. The user stays Dark
@@ -5149,7 +5149,7 @@ struct MMSpite : public MM
             pploss = 1 + b.randint(5);
 
         b.losePP(t, slot, pploss);
-        b.callieffects(t,t,"AfterPPLoss");
+        b.callieffects(t,t,EffectHook::AfterPPLoss);
         b.sendMoveMessage(123,0,s,Pokemon::Ghost,t,b.move(t,slot),QString::number(pploss));
     }
 };
@@ -5232,7 +5232,7 @@ struct MMTorment : public MM {
             b.disposeItem(t);
         } else {
             poke(b,t)["Tormented"] = true;
-            addFunction(poke(b,t), "MovesPossible", "Torment", &msp);
+            addFunction(poke(b,t), EffectHook::MovesPossible, "Torment", &msp);
         }
     }
 
@@ -5416,7 +5416,7 @@ struct MMNaturePower : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        removeFunction(turn(b,s), "UponAttackSuccessful", "NaturePower");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "NaturePower");
 
         int type = Type::Normal;
         if (b.gen().num == 5) {
@@ -5561,8 +5561,8 @@ struct MMOutrage : public MM
         if ( (!turn(b,s)["OutrageBefore"].toBool() || poke(b,s).value("OutrageUntil").toInt() < b.turn())
              && !oneTurn) {
             poke(b,s)["OutrageUntil"] = b.turn() +  1 + b.randint(2);
-            addFunction(poke(b,s), "TurnSettings", "Outrage", &ts);
-            addFunction(poke(b,s), "MoveSettings", "Outrage", &ms);
+            addFunction(poke(b,s), EffectHook::TurnSettings, "Outrage", &ts);
+            addFunction(poke(b,s), EffectHook::MoveSettings, "Outrage", &ms);
 
             if (b.gen() <= 4) {
                 b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), s, "Outrage", &aas);
@@ -5583,7 +5583,7 @@ struct MMOutrage : public MM
                 b.sendMoveMessage(93,0,s,type(b,s));
                 b.inflictConfused(s, s, b.gen() >= 2);
             }
-            removeFunction(poke(b,s), "TurnSettings", "Outrage");
+            removeFunction(poke(b,s), EffectHook::TurnSettings, "Outrage");
             b.removeEndTurnEffect(BS::PokeEffect, s, "Outrage");
             poke(b,s).remove("OutrageUntil");
             poke(b,s).remove("OutrageMove");
@@ -5597,7 +5597,7 @@ struct MMOutrage : public MM
             MoveEffect::setup(poke(b,s)["OutrageMove"].toInt(),s,s,b);
 
             if (b.gen() >= 5) {
-                addFunction(turn(b, s), "AfterAttackFinished", "Outrage", &aas);
+                addFunction(turn(b, s), EffectHook::AfterAttackFinished, "Outrage", &aas);
             }
         }
     }
@@ -5634,7 +5634,7 @@ struct MMUproar : public MM {
             }
             b.addUproarer(s);
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), s, "Uproar", &et);
-            addFunction(poke(b,s), "TurnSettings", "Uproar", &ts);
+            addFunction(poke(b,s), EffectHook::TurnSettings, "Uproar", &ts);
             poke(b,s)["UproarMove"] = move(b,s);
         }
         poke(b,s)["LastUproar"] = b.turn();
@@ -5660,7 +5660,7 @@ struct MMUproar : public MM {
                 }
             }
         } else {
-            removeFunction(poke(b,s), "TurnSettings", "Uproar");
+            removeFunction(poke(b,s), EffectHook::TurnSettings, "Uproar");
             b.removeEndTurnEffect(BS::PokeEffect, s, "Uproar");
             poke(b,s).remove("UproarUntil");
             poke(b,s).remove("LastUproar");
@@ -6002,7 +6002,7 @@ struct MMMagicRoom : public MM {
 
     static void reactivate (BS &b) {
         foreach (int p, b.sortedBySpeed()) {
-            b.callieffects(p, p, "UponReactivation");
+            b.callieffects(p, p, EffectHook::UponReactivation);
         }
     }
 };
@@ -6072,7 +6072,7 @@ struct MMShellSmash : public MM {
         b.inflictStatMod(s, SpAttack, 2, s);
         b.inflictStatMod(s, Speed, 2, s);
         b.applyingMoveStatMods = false;
-        b.callieffects(s, s, "AfterStatChange");
+        b.callieffects(s, s, EffectHook::AfterStatChange);
     }
 };
 
@@ -6193,7 +6193,7 @@ struct MMMemento : public MM {
         b.inflictStatMod(t, Attack, -2, s);
         b.inflictStatMod(t, SpAttack, -2, s);
         b.applyingMoveStatMods = false;
-        b.callieffects(t, t, "AfterStatChange");
+        b.callieffects(t, t, EffectHook::AfterStatChange);
     }
 };
 
@@ -6953,7 +6953,7 @@ struct MMCraftyShield: public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.teamMemory(s), "DetermineProtectedAgainstAttack", "CraftyShield", &dgaf);
+        addFunction(b.teamMemory(s), EffectHook::DetermineProtectedAgainstAttack, "CraftyShield", &dgaf);
         team(b,b.player(s))["CraftyShieldUsed"] = b.turn();
         b.sendMoveMessage(199, 0, s, Pokemon::Fairy);
     }
@@ -7020,7 +7020,7 @@ struct MMElectrify : public MM {
     }
 
     static void uas(int s, int t, BS &b) {
-        addFunction(turn(b,t), "MoveSettings", "Electrify", &ms);
+        addFunction(turn(b,t), EffectHook::MoveSettings, "Electrify", &ms);
         b.sendMoveMessage(202,0,s,Pokemon::Electric,t);
     }
 };
@@ -7125,7 +7125,7 @@ struct MMKingsShield: public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.turnMemory(s), "DetermineProtectedAgainstAttackKS", "KingsShield", &dgaf);
+        addFunction(b.turnMemory(s), EffectHook::DetermineProtectedAgainstAttackKS, "KingsShield", &dgaf);
         turn(b,s)["KingsShieldUsed"] = true;
         b.sendMoveMessage(206, 0, s, type(b,s));
     }
@@ -7179,7 +7179,7 @@ struct MMMatBlock : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.teamMemory(b.player(s)), "DetermineProtectedAgainstAttack", "MatBlock", &dgaf);
+        addFunction(b.teamMemory(b.player(s)), EffectHook::DetermineProtectedAgainstAttack, "MatBlock", &dgaf);
         team(b,b.player(s))["MatBlockUsed"] = b.turn();
         b.sendMoveMessage(207, 0, s, type(b,s));
     }
@@ -7258,7 +7258,7 @@ struct MMSpikyShield : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.turnMemory(s), "DetermineProtectedAgainstAttack", "SpikyShield", &dgaf);
+        addFunction(b.turnMemory(s), EffectHook::DetermineProtectedAgainstAttack, "SpikyShield", &dgaf);
         turn(b,s)["SpikyShieldUsed"] = true;
         b.sendMoveMessage(27, 0, s, Pokemon::Grass);
     }
@@ -7313,7 +7313,7 @@ struct MMStickyWeb : public MM
     static void uas(int s, int, BS &b) {
         int t = b.opponent(b.player(s));
         team(b,t)["StickyWeb"] = true;
-        addFunction(team(b,t), "UponSwitchIn", "StickyWeb", &usi);
+        addFunction(team(b,t), EffectHook::UponSwitchIn, "StickyWeb", &usi);
         b.sendMoveMessage(210,0,s,Pokemon::Bug,t);
     }
 
@@ -7432,13 +7432,13 @@ struct MMPowder : public MM
     static void uas (int s, int t, BS &b) {
         b.sendMoveMessage(215,0,s,type(b,s),t);
 
-        addFunction(poke(b,t), "MovePossible", "Powder", &mp);
+        addFunction(poke(b,t), EffectHook::MovePossible, "Powder", &mp);
         poke(b,t)["Powdered"] = true;
     }
 
     static void mp(int s, int, BS &b)
     {
-        addFunction(turn(b,s), "AfterTellingPlayers", "Powder", &atp);
+        addFunction(turn(b,s), EffectHook::AfterTellingPlayers, "Powder", &atp);
     }
 
     static void atp(int s, int, BS &b)
@@ -7446,7 +7446,7 @@ struct MMPowder : public MM
         if (poke(b,s).value("Powdered").toBool()) {
             if (type(b,s) == Type::Fire) {
                 b.sendMoveMessage(215, 1, s, Pokemon::Fire);
-                removeFunction(poke(b,s), "MovePossible", "Powder");
+                removeFunction(poke(b,s), EffectHook::MovePossible, "Powder");
                 b.inflictDamage(s, b.poke(s).totalLifePoints()/4, s);
                 turn(b,s)["PowderExploded"] = true;
             }
@@ -7482,14 +7482,14 @@ struct MMIonDeluge : public MM {
 
     static void uas(int s, int, BS &b) {
         b.sendMoveMessage(217, 0, s, Type::Electric);
-        addFunction(b.battleMemory(), "MovePossible", "IonDeluge", &mp);
+        addFunction(b.battleMemory(), EffectHook::MovePossible, "IonDeluge", &mp);
         b.battleMemory()["IonDelugeTurn"] = b.turn();
     }
 
     static void mp(int s, int, BS &b) {
         if (b.battleMemory().value("IonDelugeTurn").toInt() != b.turn()) {
             b.battleMemory().remove("IonDelugeTurn");
-            removeFunction(b.battleMemory(), "MovePossible", "IonDeluge");
+            removeFunction(b.battleMemory(), EffectHook::MovePossible, "IonDeluge");
             return;
         }
         if (tmove(b,s).type == Type::Normal) {
@@ -7653,8 +7653,8 @@ struct MMThroatChop : public MM //copied from taunt
             b.sendItemMessage(7,t);
             b.disposeItem(t);
         } else {
-            addFunction(poke(b,t), "MovesPossible", "ThroatChop", &msp);
-            addFunction(poke(b,t), "MovePossible", "ThroatChop", &mp);
+            addFunction(poke(b,t), EffectHook::MovesPossible, "ThroatChop", &msp);
+            addFunction(poke(b,t), EffectHook::MovePossible, "ThroatChop", &mp);
             b.addEndTurnEffect(BS::PokeEffect, bracket(b.gen()), t, "ThroatChop", &et);
 
             b.counters(t).addCounter(BC::ThroatChop, 1); //does the turn the move is used count?
@@ -7667,8 +7667,8 @@ struct MMThroatChop : public MM //copied from taunt
             return;
 
         if (b.counters(s).count(BC::ThroatChop) < 0) {
-            removeFunction(poke(b,s), "MovesPossible", "ThroatChop");
-            removeFunction(poke(b,s), "MovePossible", "ThroatChop");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "ThroatChop");
+            removeFunction(poke(b,s), EffectHook::MovePossible, "ThroatChop");
             b.removeEndTurnEffect(BS::PokeEffect, s, "ThroatChop");
             b.sendMoveMessage(223,2,s,Pokemon::Dark);
             b.counters(s).removeCounter(BC::ThroatChop);
@@ -7736,7 +7736,7 @@ struct MMBanefulBunker: public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(b.turnMemory(s), "DetermineProtectedAgainstAttack", "BanefulBunker", &dgaf);
+        addFunction(b.turnMemory(s), EffectHook::DetermineProtectedAgainstAttack, "BanefulBunker", &dgaf);
         turn(b,s)["BanefulBunkerUsed"] = true;
         b.sendMoveMessage(27, 0, s, type(b,s));
     }
@@ -8018,7 +8018,7 @@ struct MMSpotlight : public MM
             why we need a switch count, or that */
         poke(b,t)["FollowMe"] = true;
 
-        addFunction(b.battleMemory(), "GeneralTargetChange", "Spotlight", &gtc);
+        addFunction(b.battleMemory(), EffectHook::GeneralTargetChange, "Spotlight", &gtc);
     }
 
     static void gtc(int s, int, BS &b) {
@@ -8223,7 +8223,7 @@ struct MMZAttention : public MM
             why we need a switch count, or that */
         poke(b,s)["FollowMe"] = true;
 
-        addFunction(b.battleMemory(), "GeneralTargetChange", "ZAttention", &gtc);
+        addFunction(b.battleMemory(), EffectHook::GeneralTargetChange, "ZAttention", &gtc);
     }
 
     static void gtc(int s, int, BS &b) {
@@ -8238,7 +8238,7 @@ struct MMZHealSwitch : public MM
     }
 
     static void zm(int s, int, BS &b) {
-        addFunction(turn(b,s), "UponSwitchIn", "ZHealSwitch", &asi);
+        addFunction(turn(b,s), EffectHook::UponSwitchIn, "ZHealSwitch", &asi);
     }
 
     static void asi(int s, int, BS &b) {
@@ -8369,7 +8369,7 @@ struct MMPhotonGeyser : public MM
     *GeneralTargetChange
 */
 
-#define REGISTER_MOVE(num, name) mechanics[num] = MM##name(); names[num] = #name; nums[#name] = num;
+#define REGISTER_MOVE(num, name) mechanics[num] = MM##name(); mechanics[num].effectId = EffectHook::effect(#name); names[num] = #name; nums[#name] = num;
 
 void MoveEffect::init()
 {
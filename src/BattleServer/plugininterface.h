@@ -18,7 +18,7 @@ public:
         return NULL;
     }
 
-    #define battleserver_plugin_version() int version() const { return 1;}
+    #define battleserver_plugin_version() int version() const { return 2;}
 };
 
 class BattlePlugin
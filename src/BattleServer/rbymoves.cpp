@@ -42,18 +42,21 @@ void RBYMoveEffect::setup(int num, int source, int target, BattleBase &b)
             MoveMechanics &m = mechanics[specialEffect];
             QString &n = names[specialEffect];
 
-            QHash<QString, MoveMechanics::function>::iterator i;
-
             size_t pos = s.find('-');
             if (pos != std::string::npos) {
                 MM::turn(b,source)[n+"_Arg"] = specialEffectS.mid(pos+1);
             }
 
-            for(i = m.functions.begin(); i != m.functions.end(); ++i) {
-                if (i.key() == "OnSetup") {
-                    i.value()(source,target,b);
+            for (int hook = 0; hook < m.functions.size(); hook++) {
+                MoveMechanics::function f = m.functions.value(hook);
+
+                if (!f) {
+                    continue;
+                }
+                if (hook == EffectHook::OnSetup) {
+                    f(source,target,b);
                 } else {
-                    MM::addFunction(MM::turn(b,source), i.key(), n, i.value());
+                    MM::addFunction(MM::turn(b,source), hook, m.effectId, f);
                 }
             }
         }
@@ -84,15 +87,10 @@ void RBYMoveEffect::unsetup(int num, int source, BattleBase &b)
             }
 
             MoveMechanics &m = mechanics[specialEffect];
-            QString &n = names[specialEffect];
-
-            QHash<QString, MoveMechanics::function>::iterator i;
 
-            for(i = m.functions.begin(); i != m.functions.end(); ++i) {
-                if (i.key() == "OnSetup") {
-                    ;
-                } else {
-                    MM::removeFunction(MM::turn(b,source), i.key(), n);
+            for (int hook = 0; hook < m.functions.size(); hook++) {
+                if (hook != EffectHook::OnSetup && m.functions.contains(hook)) {
+                    MM::removeFunction(MM::turn(b,source), hook, m.effectId);
                 }
             }
         }
@@ -112,8 +110,8 @@ struct RBYBide : public MM
         poke(b,s)["BideCount"] = 2 + b.randint(2);
         poke(b,t).remove("DamageInflicted");
         poke(b,s)["BideDamage"] = 0;
-        addFunction(poke(b,s), "TurnSettings", "Bide", &ts);
-        addFunction(poke(b,s), "MovesPossible", "Bide", &mp);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "Bide", &ts);
+        addFunction(poke(b,s), EffectHook::MovesPossible, "Bide", &mp);
     }
 
     static void uas2(int s, int t, BS &b) {
@@ -142,14 +140,14 @@ struct RBYBide : public MM
             }
 
             poke(b,s).remove("BideCount");
-            removeFunction(poke(b,s), "TurnSettings", "Bide");
-            removeFunction(poke(b,s), "MovesPossible", "Bide");
+            removeFunction(poke(b,s), EffectHook::TurnSettings, "Bide");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "Bide");
         }
     }
 
     static void ts(int s, int, BS &b) {
         fturn(b,s).add(TM::KeepAttack);
-        addFunction(turn(b,s), "UponAttackSuccessful", "Bide", &uas2);
+        addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bide", &uas2);
 
         turn(b,s)["TellPlayers"] = false;
     }
@@ -179,8 +177,8 @@ struct RBYBind : public MM
         poke(b,s)["LastBind"] = b.turn();
         poke(b,s)["BindDamage"] = poke(b,s)["DamageInflicted"];
         poke(b,t)["Bound"] = true;
-        addFunction(poke(b,s), "TurnSettings", "Bind", &ts);
-        addFunction(poke(b,t), "MovePossible", "Bind", &mp);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "Bind", &ts);
+        addFunction(poke(b,t), EffectHook::MovePossible, "Bind", &mp);
     }
 
     static void ts(int s, int, BS &b) {
@@ -191,10 +189,10 @@ struct RBYBind : public MM
         }
         if (poke(b,s).value("LastBind").toInt() == b.turn()-1 && poke(b,s).value("BindCount").toInt() > 0) {
             fturn(b,s).add(TM::KeepAttack);
-            addFunction(turn(b,s), "UponAttackSuccessful", "Bind", &uas2);
-            addFunction(turn(b,s), "EvenWhenCantMove", "Bind", &ewcm);
+            addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Bind", &uas2);
+            addFunction(turn(b,s), EffectHook::EvenWhenCantMove, "Bind", &ewcm);
             /* Bind does the same damage every turn */
-            addFunction(turn(b,s), "CustomAttackingDamage", "Bind", &cad);
+            addFunction(turn(b,s), EffectHook::CustomAttackingDamage, "Bind", &cad);
             if (!b.isStadium()) {
                 turn(b,t) ["ForceBind"] = true;
             }
@@ -256,7 +254,7 @@ struct RBYBind : public MM
         if (count == 0) {
             poke(b,s).remove("BindCount");
             poke(b,t).remove("Bound");
-            removeFunction(poke(b,s), "TurnSettings", "Bind");
+            removeFunction(poke(b,s), EffectHook::TurnSettings, "Bind");
             //RBY doesn't notify when Wrap ends
             //b.sendMoveMessage(10, 1, t, type(b,s), s, move(b,s));
         }
@@ -336,7 +334,7 @@ struct RBYDig : public MM
 
         b.changeSprite(s, -1);
 
-        addFunction(poke(b,s), "TurnSettings", "Dig", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "Dig", &ts);
     }
 
     static void ts(int s, int, BS &b) {
@@ -348,8 +346,8 @@ struct RBYDig : public MM
         fturn(b,s).add(TM::NoChoice);
         /* To restore the RBY paralysis glitch with fly, change TrueEnd to AttackSomehowFailed
           and uncomment the line after next*/
-        addFunction(turn(b,s), "TrueEnd", "Dig", &asf);
-        //addFunction(turn(b,s), "UponAttackSuccessful", "Dig", &asf);
+        addFunction(turn(b,s), EffectHook::TrueEnd, "Dig", &asf);
+        //addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Dig", &asf);
         turn(b,s)["AutomaticMove"] = poke(b,s).value("ChargeMove");
         initMove(poke(b,s).value("ChargeMove").toInt(), b.gen(), tmove(b,s));
     }
@@ -401,16 +399,16 @@ struct RBYDisable : public MM
         poke(b,t)["DisableCount"] = count;
         poke(b,t)["DisableSlot"] = slot;
 
-        addFunction(poke(b,t), "MovePossible", "Disable", &mp);
-        addFunction(poke(b,t), "MovesPossible", "Disable", &msp);
+        addFunction(poke(b,t), EffectHook::MovePossible, "Disable", &mp);
+        addFunction(poke(b,t), EffectHook::MovesPossible, "Disable", &msp);
 
         b.sendMoveMessage(28, 0, s, 0, t, b.move(t, slot));
-        b.callpeffects(t, s, "UponOffensiveDamageReceived");
+        b.callpeffects(t, s, EffectHook::UponOffensiveDamageReceived);
     }
 
     static void asf(int s, int t, BS &b) {
         //RBY Bug: Disable builds up rage whenever
-        b.callpeffects(t, s, "UponOffensiveDamageReceived");
+        b.callpeffects(t, s, EffectHook::UponOffensiveDamageReceived);
     }
 
     static void mp(int s, int , BS &b) {
@@ -419,8 +417,8 @@ struct RBYDisable : public MM
 
         if (poke(b,s).value("DisableCount").toInt() <= 0) {
             poke(b,s).remove("DisableCount");
-            removeFunction(poke(b,s), "MovePossible", "Disable");
-            removeFunction(poke(b,s), "MovesPossible", "Disable");
+            removeFunction(poke(b,s), EffectHook::MovePossible, "Disable");
+            removeFunction(poke(b,s), EffectHook::MovesPossible, "Disable");
             b.sendMoveMessage(28, 2, s, 0, s, b.move(s, slot));
             return;
         }
@@ -501,11 +499,11 @@ struct RBYFocusEnergy : public MM
     static void uas(int s, int, BS &b) {
         b.sendMoveMessage(46, 0, s);
         poke(b,s)["Focused"] = true;
-        addFunction(poke(b,s), "TurnSettings", "FocusEnergy", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "FocusEnergy", &ts);
     }
 
     static void ts(int s, int, BS &b) {
-        addFunction(turn(b,s), "MoveSettings", "FocusEnergy", &ms);
+        addFunction(turn(b,s), EffectHook::MoveSettings, "FocusEnergy", &ms);
     }
 
     static void ms(int s, int, BS &b) {
@@ -549,10 +547,10 @@ struct RBYHaze : public MM
         b.poke(s).removeStatus(Pokemon::Seeded);
         b.poke(t).removeStatus(Pokemon::Seeded);
 
-        removeFunction(poke(b,s), "MovePossible", "Disable");
-        removeFunction(poke(b,s), "MovesPossible", "Disable");
-        removeFunction(poke(b,t), "MovePossible", "Disable");
-        removeFunction(poke(b,t), "MovesPossible", "Disable");
+        removeFunction(poke(b,s), EffectHook::MovePossible, "Disable");
+        removeFunction(poke(b,s), EffectHook::MovesPossible, "Disable");
+        removeFunction(poke(b,t), EffectHook::MovePossible, "Disable");
+        removeFunction(poke(b,t), EffectHook::MovesPossible, "Disable");
 
         //Haze clears major status that the user has in Stadium
         if (b.isStadium()) {
@@ -593,7 +591,7 @@ struct RBYHyperBeam : public MM
             return;
 
         poke(b,s)["Recharging"] = b.turn()+1;
-        addFunction(poke(b,s), "TurnSettings", "HyperBeam", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "HyperBeam", &ts);
     }
 
     static void uas(int s, int t, BS &b) {
@@ -603,7 +601,7 @@ struct RBYHyperBeam : public MM
             return;
 
         poke(b,s)["Recharging"] = b.turn()+1;
-        addFunction(poke(b,s), "TurnSettings", "HyperBeam", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "HyperBeam", &ts);
     }
 
     static void ms(int s, int, BS &b) {
@@ -615,7 +613,7 @@ struct RBYHyperBeam : public MM
             turn(b, s)["TellPlayers"] = false;
             tmove(b, s).targets = Move::User;
             poke(b,s).remove("Recharging"); //For Hyper Beam Sleep Status override
-            addFunction(turn(b,s), "UponAttackSuccessful", "HyperBeam", &aas);
+            addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "HyperBeam", &aas);
         }
     }
 
@@ -631,7 +629,7 @@ struct RBYHyperBeam : public MM
         fturn(b, s).add(TM::NoChoice);
         turn(b,s)["AutomaticMove"] = 0;//So that confusion won't be inflicted on recharge
 
-        addFunction(turn(b,s), "MoveSettings", "HyperBeam", &ms);
+        addFunction(turn(b,s), EffectHook::MoveSettings, "HyperBeam", &ms);
     }
 };
 
@@ -692,7 +690,7 @@ struct RBYMetronome : public MM
     }
 
     static void uas(int s, int t, BS &b) {
-        removeFunction(turn(b,s), "UponAttackSuccessful", "Metronome");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "Metronome");
         turn(b,s)["MetronomeCall"] = true;
 
         while (1) {
@@ -764,8 +762,8 @@ struct RBYMirrorMove : public MM
     }
 
     static void uas(int s, int t, BS &b) {
-        removeFunction(turn(b,s), "DetermineAttackFailure", "MirrorMove");
-        removeFunction(turn(b,s), "UponAttackSuccessful", "MirrorMove");
+        removeFunction(turn(b,s), EffectHook::DetermineAttackFailure, "MirrorMove");
+        removeFunction(turn(b,s), EffectHook::UponAttackSuccessful, "MirrorMove");
 
         int move = fpoke(b,t).lastMoveUsed;
         if (b.isStadium()) {
@@ -827,7 +825,7 @@ struct RBYPetalDance : public MM
 
     static void ms(int s, int, BS &b) {
         poke(b,s)["PetalDanceCount"] = 3 + b.randint(2);
-        addFunction(poke(b,s), "TurnSettings", "PetalDance", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "PetalDance", &ts);
     }
 
     static void uas(int s, int, BS &b) {
@@ -846,8 +844,8 @@ struct RBYPetalDance : public MM
             return;
         }
         RBYMoveMechanics::initMove(fpoke(b,s).lastMoveUsed, b.gen(), tmove(b,s));
-        addFunction(turn(b,s), "UponAttackSuccessful", "PetalDance", &uas);
-        addFunction(turn(b,s), "AttackSomehowFailed", "PetalDance", &uas);
+        addFunction(turn(b,s), EffectHook::UponAttackSuccessful, "PetalDance", &uas);
+        addFunction(turn(b,s), EffectHook::AttackSomehowFailed, "PetalDance", &uas);
         fturn(b,s).add(TM::NoChoice);
     }
 };
@@ -870,14 +868,14 @@ struct RBYRage : public MM
     }
 
     static void uas(int s, int, BS &b) {
-        addFunction(poke(b, s), "TurnSettings", "Rage", &ts);
-        addFunction(poke(b, s), "UponOffensiveDamageReceived", "Rage", &uodr);
+        addFunction(poke(b, s), EffectHook::TurnSettings, "Rage", &ts);
+        addFunction(poke(b, s), EffectHook::UponOffensiveDamageReceived, "Rage", &uodr);
     }
 
     static void ts(int s, int, BS &b) {
         fturn(b,s).add(TM::NoChoice);
         /*Rage Bug is a lie!*/
-        //addFunction(turn(b,s), "AttackSomehowFailed", "Rage", &asf);
+        //addFunction(turn(b,s), EffectHook::AttackSomehowFailed, "Rage", &asf);
 
         initMove(fpoke(b,s).lastMoveUsed, b.gen(), tmove(b,s));
         /*if (poke(b,s).contains("RageFailed")) {
@@ -942,7 +940,7 @@ struct RBYRazorWind : public MM
         if (b.isStadium()) {
             b.battleMemory()["LastDamageTakenByAny"] = 0;
         }
-        addFunction(poke(b,s), "TurnSettings", "RazorWind", &ts);
+        addFunction(poke(b,s), EffectHook::TurnSettings, "RazorWind", &ts);
     }
 
     static void ts(int s, int, BS &b) {
@@ -1070,7 +1068,7 @@ struct RBYTransform : public MM
     }
 };
 
-#define REGISTER_MOVE(num, name) mechanics[num] = RBY##name(); names[num] = #name; nums[#name] = num;
+#define REGISTER_MOVE(num, name) mechanics[num] = RBY##name(); mechanics[num].effectId = EffectHook::effect(#name); names[num] = #name; nums[#name] = num;
 
 void RBYMoveEffect::init()
 {
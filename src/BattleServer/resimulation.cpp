@@ -0,0 +1,160 @@
+#include <QFile>
+
+#include <Utilities/coreclasses.h>
+#include <Utilities/contextswitch.h>
+
+#include "../Shared/battlecommands.h"
+#include "battle.h"
+#include "battlerby.h"
+#include "resimulation.h"
+
+Resimulation::Resimulation(QObject *parent) : QObject(parent), seed(0), battle(nullptr)
+{
+    ratings[0] = ratings[1] = 0;
+}
+
+Resimulation::~Resimulation()
+{
+    if (battle) {
+        battle->deleteLater();
+    }
+}
+
+bool Resimulation::load(const QString &file)
+{
+    this->file = file;
+
+    QFile in(file);
+
+    if (!in.open(QIODevice::ReadOnly)) {
+        error = in.errorString();
+        return false;
+    }
+
+    if (in.readLine().trimmed() != "battle_logs_v3") {
+        error = "Not a replay, or a replay of an older version";
+        return false;
+    }
+
+    DataStream stream(&in);
+    stream >> conf;
+
+    if (!conf.isPlayer(0) || !conf.isPlayer(1)) {
+        error = "The replay doesn't have both teams";
+        return false;
+    }
+
+    forever {
+        qint32 time;
+        QByteArray command;
+
+        stream >> time >> command;
+
+        if (command.isEmpty()) {
+            break;
+        }
+        if (compared(command)) {
+            recorded.push_back(command);
+        }
+    }
+
+    if (in.atEnd()) {
+        error = "The replay was saved without the seed and choices of the battle";
+        return false;
+    }
+
+    /* Same version as BattleLogs uses */
+    DataStream resim(&in, 4);
+    resim >> seed >> ratings[0] >> ratings[1];
+    resim >> teams[0].fullSerial() >> teams[1].fullSerial();
+    resim >> choices;
+
+    if (resim.status() != QDataStream::Ok) {
+        error = "The replay is damaged";
+        return false;
+    }
+
+    teams[0].name = conf.name[0];
+    teams[1].name = conf.name[1];
+
+    return true;
+}
+
+QString Resimulation::errorString() const
+{
+    return error;
+}
+
+void Resimulation::start(ContextSwitcher &ctx)
+{
+    BattlePlayer p1(conf.name[0], conf.ids[0], ratings[0], conf.avatar[0]);
+    BattlePlayer p2(conf.name[1], conf.ids[1], ratings[1], conf.avatar[1]);
+
+    /* The teams were already generated */
+    ChallengeInfo c(0, 0, conf.clauses & ~ChallengeInfo::ChallengeCup, conf.mode, conf.rated());
+    c.gen = conf.gen;
+
+    if (c.gen <= 1) {
+        battle = (BattleBase*)new BattleRBY(p1, p2, c, 1, teams[0], teams[1], nullptr);
+    } else {
+        battle = new BattleSituation(p1, p2, c, 1, teams[0], teams[1], nullptr);
+    }
+
+    battle->script(seed, choices, conf.clauses);
+
+    connect(battle, SIGNAL(battleBroadcast(int,int,QByteArray)), SLOT(onBroadcast(int,int,QByteArray)));
+    connect(battle, SIGNAL(battleFinished(int,int,int,int)), SLOT(onFinished(int,int,int,int)));
+
+    timer.start();
+    battle->start(ctx);
+}
+
+void Resimulation::onBroadcast(int, int, const QByteArray &command)
+{
+    if (compared(command)) {
+        played.push_back(command);
+    }
+}
+
+void Resimulation::onFinished(int, int result, int, int)
+{
+    qint64 elapsed = timer.elapsed();
+
+    int same = 0;
+    while (same < recorded.size() && same < played.size() && recorded[same] == played[same]) {
+        same++;
+    }
+
+    /* When the recorded battle ended in a way the choices don't tell (timeout), the battle
+       played again stops earlier */
+    bool identical = same == played.size() && (same == recorded.size() || result == Close);
+
+    if (identical) {
+        qDebug() << QString("%1: same as recorded, %2 commands in %3 ms").arg(file).arg(played.size()).arg(elapsed);
+    } else {
+        qDebug() << QString("%1: differs from the recording at command %2 of %3").arg(file).arg(same + 1).arg(recorded.size());
+    }
+
+    emit finished(identical);
+}
+
+bool Resimulation::compared(const QByteArray &command)
+{
+    using namespace BattleCommands;
+
+    switch (command.isEmpty() ? -1 : uchar(command[0])) {
+    case ClockStart:
+    case ClockStop:
+    case BattleChat:
+    case SpectatorChat:
+    case Spectating:
+    case Notice:
+    case EndMessage:
+    case CancelMove:
+    case OfferChoice:
+    case RearrangeTeam:
+        return false;
+    default:
+        return true;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef RESIMULATION_H
+#define RESIMULATION_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+#include <PokemonInfo/battlestructs.h>
+
+class BattleBase;
+class ContextSwitcher;
+
+/* Plays a battle saved by the BattleLogs plugin again, from its seed and the choices the players made,
+   and checks that the battle goes the same way. Used to test changes of the battle code against real
+   battles, and to time them. */
+class Resimulation : public QObject
+{
+    Q_OBJECT
+public:
+    Resimulation(QObject *parent = 0);
+    ~Resimulation();
+
+    /* Returns false if the replay can't be used, errorString() then tells why */
+    bool load(const QString &file);
+    QString errorString() const;
+
+    void start(ContextSwitcher &ctx);
+signals:
+    /* identical: the battle sent the same commands as the recorded one */
+    void finished(bool identical);
+private slots:
+    void onBroadcast(int battleid, int player, const QByteArray &command);
+    void onFinished(int battleid, int result, int winner, int loser);
+private:
+    /* False for the commands that depend on the clock or on people outside of the battle */
+    static bool compared(const QByteArray &command);
+
+    QString file, error;
+
+    FullBattleConfiguration conf;
+    TeamBattle teams[2];
+    qint32 ratings[2];
+    quint32 seed;
+    QList<BattleChoice> choices;
+
+    QList<QByteArray> recorded, played;
+
+    BattleBase *battle;
+    QElapsedTimer timer;
+};
+
+#endif // RESIMULATION_H
@@ -42,6 +42,7 @@ public slots:
 
     void notifyBattle(int id, int publicId, int opponent, const TeamBattle &team, const BattleConfiguration &config, const QString &tier);
     void notifyInfo(int bid, int player, const QByteArray &info);
+    void notifyBroadcast(int bid, int except, const QByteArray &info);
     void notifyFinished(int battle,int result, int winner, int loser);
 private:
     Analyzer *relay;
@@ -12,14 +12,14 @@ void MoveGen::init(Pokemon::gen gen, Pokemon::uniqueId pokenum)
     this->gen = gen;
     this->id = pokenum;
 
-    moves[LevelMoves] = ::moves[gen][id].levelMoves;
-    moves[SpecialMoves] = ::moves[gen][id].specialMoves;
-    moves[EggMoves] = ::moves[gen][id].eggMoves;
-    moves[TutorMoves] = ::moves[gen][id].tutorMoves;
-    moves[TMMoves] = ::moves[gen][id].TMMoves;
-    moves[PreEvoMoves] = ::moves[gen][id].preEvoMoves;
+    moves[LevelMoves] = ::moves[gen][id].levelMoves.toSet();
+    moves[SpecialMoves] = ::moves[gen][id].specialMoves.toSet();
+    moves[EggMoves] = ::moves[gen][id].eggMoves.toSet();
+    moves[TutorMoves] = ::moves[gen][id].tutorMoves.toSet();
+    moves[TMMoves] = ::moves[gen][id].TMMoves.toSet();
+    moves[PreEvoMoves] = ::moves[gen][id].preEvoMoves.toSet();
     if (gen.num == 5) {
-        moves[DreamWorldMoves] = ::moves[gen][id].dreamWorldMoves;
+        moves[DreamWorldMoves] = ::moves[gen][id].dreamWorldMoves.toSet();
     }
 }
 
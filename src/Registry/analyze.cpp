@@ -106,14 +106,9 @@ void Analyzer::sendRegistryAnnouncement(const QString &announcement)
     notify(Announcement, announcement);
 }
 
-void Analyzer::sendServer(const QString &name, const QString &desc, quint16 numplayers, const QString &ip,quint16 max, quint16 port, bool passwordProtected)
+void Analyzer::sendPacket(const QByteArray &packet)
 {
-    notify(PlayersList, name, desc, numplayers, ip, max, port, passwordProtected);
-}
-
-void Analyzer::sendServerListEnd()
-{
-    notify(ServerListEnd);
+    socket().sendPacket(packet);
 }
 
 void Analyzer::sendInvalidName()
@@ -20,8 +20,8 @@ public:
 
     /* functions called by the reg */
     void sendRegistryAnnouncement(const QString &announcement);
-    void sendServer(const QString &name, const QString &desc, quint16 numplayers, const QString &ip,quint16 max, quint16 port, bool passwordProtected);
-    void sendServerListEnd(void);
+    /* Already framed by the registry */
+    void sendPacket(const QByteArray &packet);
     void sendInvalidName();
     void sendNameTaken();
     void sendAccept();
@@ -39,12 +39,18 @@ public:
 
     template <typename ...Params>
     void notify(int command, Params&&... params) {
+        emitCommand(makeCommand(command, std::forward<Params>(params)...));
+    }
+
+    /* The command as notify() would send it, without the length */
+    template <typename ...Params>
+    static QByteArray makeCommand(int command, Params&&... params) {
         QByteArray tosend;
         DataStream out(&tosend, QIODevice::WriteOnly);
 
         out.pack(uchar(command), std::forward<Params>(params)...);
 
-        emitCommand(tosend);
+        return tosend;
     }
 
 signals:
@@ -109,13 +109,30 @@ QString Network::errorString() const
         return myerrorString;
 }
 
+QByteArray Network::frame(const QByteArray &command)
+{
+    QByteArray ret(4, Qt::Uninitialized);
+
+    const int l = command.length();
+    ret[0] = l >> (3*8);
+    ret[1] = l >> (2*8);
+    ret[2] = l >> 8;
+    ret[3] = l;
+
+    ret.append(command);
+    return ret;
+}
+
 void Network::send(const QByteArray &message)
 {
-    socket()->putChar(message.length()/(65336*256));
-    socket()->putChar(message.length()/65536);
-    socket()->putChar(message.length()/256);
-    socket()->putChar(message.length()%256);
-    socket()->write(message);
+    socket()->write(frame(message));
+}
+
+void Network::sendPacket(const QByteArray &packet)
+{
+    if (socket()) {
+        socket()->write(packet);
+    }
 }
 
 QTcpSocket * Network::socket()
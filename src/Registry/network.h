@@ -20,6 +20,9 @@ public:
 
     void connectToHost(const QString & ip, quint16 port);
 
+    /* Prefixes a command with its length, as send() does */
+    static QByteArray frame(const QByteArray &command);
+
     void close();
     int id() const {return myid;}
 public slots:
@@ -27,6 +30,8 @@ public slots:
     void onDisconnect();
     void manageError(QAbstractSocket::SocketError);
     void send(const QByteArray &message);
+    /* Sends data that's already framed, possibly several commands at once */
+    void sendPacket(const QByteArray &packet);
 signals:
     void isFull(QByteArray command);
     void connected();
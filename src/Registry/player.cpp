@@ -1,4 +1,3 @@
-#include "server.h"
 #include "player.h"
 #include "analyze.h"
 
@@ -27,15 +26,7 @@ void Player::sendRegistryAnnouncement(const QString &announcement) {
     m_relay->sendRegistryAnnouncement(announcement);
 }
 
-void Player::sendServer(const Server &s)
+void Player::sendServerList(const QByteArray &packet)
 {
-    if(s.port() == 0)
-        m_relay->sendServer(s.name(), s.desc(), s.players(), s.ip(),s.maxPlayers(),5080, s.passwordProtected());
-    else
-        m_relay->sendServer(s.name(), s.desc(), s.players(), s.ip(),s.maxPlayers(),s.port(), s.passwordProtected());
-}
-
-void Player::sendServerListEnd()
-{
-  m_relay->sendServerListEnd();
+    m_relay->sendPacket(packet);
 }
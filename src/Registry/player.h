@@ -6,7 +6,6 @@
 
 class QTcpSocket;
 class Analyzer;
-class Server;
 
 class Player : public QObject
 {
@@ -18,8 +17,8 @@ public:
     Player(int id, QTcpSocket *s);
 
     void sendRegistryAnnouncement(const QString &announcement);
-    void sendServer(const Server &s);
-    void sendServerListEnd(void);
+    /* The listing of the servers, followed by ServerListEnd */
+    void sendServerList(const QByteArray &packet);
     void kick();
 public slots:
     void disconnected();
@@ -2,12 +2,22 @@
 #include "antidos.h"
 #include "server.h"
 #include "player.h"
+#include "analyze.h"
 #ifdef USE_WEBCONF
 #include "webinterface.h"
 #endif
 
 Registry::Registry() {
     linecount = 0;
+    nextId = 1;
+
+    QSettings settings;
+    /* Sends the server list as a single compressed command, the clients understand it
+       since they support compression from the servers */
+    if (settings.value("Registry/ZipServerList").isNull()) {
+        settings.setValue("Registry/ZipServerList", false);
+    }
+    zipServerList = settings.value("Registry/ZipServerList").toBool();
 
     QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
     //QTextCodec::setCodecForTr(QTextCodec::codecForName("UTF-8"));
@@ -64,11 +74,63 @@ void Registry::printLine(const QString &line)
 
 int Registry::freeid() const
 {
-    for (int i = 1; ; i++) {
-        if (!players.contains(i) && !servers.contains(i)) {
-            return i;
+    return freeIds.isEmpty() ? nextId : freeIds.last();
+}
+
+void Registry::takeId(int id)
+{
+    if (!freeIds.isEmpty() && freeIds.last() == id) {
+        freeIds.pop_back();
+    } else {
+        nextId = qMax(nextId, id + 1);
+    }
+}
+
+const QByteArray &Registry::serverList()
+{
+    if (outdatedServers.isEmpty() && !serverListPacket.isEmpty()) {
+        return serverListPacket;
+    }
+
+    foreach(int id, outdatedServers) {
+        Server *s = servers.value(id);
+
+        if (s && s->listed()) {
+            listings[id] = s->listing();
+        } else {
+            listings.remove(id);
         }
     }
+    outdatedServers.clear();
+
+    QByteArray end = Analyzer::makeCommand(NetworkReg::ServerListEnd);
+
+    if (zipServerList) {
+        /* Several commands in one ZipCommand, each as a QByteArray */
+        QByteArray commands;
+        DataStream out(&commands, QIODevice::WriteOnly);
+
+        foreach(const QByteArray &listing, listings) {
+            out << listing;
+        }
+        out << end;
+
+        QByteArray zipped(2, Qt::Uninitialized);
+        zipped[0] = uchar(NetworkReg::ZipCommand);
+        zipped[1] = 1; /* Multiple commands */
+        zipped.append(qCompress(commands));
+
+        serverListPacket = Network::frame(zipped);
+    } else {
+        serverListPacket.clear();
+
+        foreach(const QByteArray &listing, listings) {
+            serverListPacket.append(Network::frame(listing));
+        }
+        serverListPacket.append(Network::frame(end));
+    }
+
+    return serverListPacket;
 }
 
 void Registry::updateTBanList()
@@ -143,10 +205,12 @@ void Registry::incomingServer()
     }
 
     ipCounter[ip] += 1;
+    takeId(id);
     servers[id] = new Server(id, newconnection);
 
     connect(servers[id], SIGNAL(nameChangedReq(int,QString)), SLOT(nameChangedAcc(int,const QString&)));
     connect(servers[id], SIGNAL(portSet(int, int, int)), SLOT(portSet(int,int,int)));
+    connect(servers[id], SIGNAL(listingChanged(int)), SLOT(serverChanged(int)));
     connect(servers[id], SIGNAL(disconnection(int)), SLOT(disconnection(int)));
 }
 
@@ -173,6 +237,7 @@ void Registry::incomingPlayer()
         return;
     }
 
+    takeId(id);
     Player *p = players[id] = new Player(id, newconnection);
 
     connect(players[id], SIGNAL(disconnection(int)), SLOT(disconnection(int)));
@@ -184,13 +249,7 @@ void Registry::incomingPlayer()
     }
 
     printLine("Sending the server list");
-    foreach(Server *s, servers) {
-        if (s->listed()) {
-            p->sendServer(*s);
-        }
-    }
-    // Tell client that the server list has ended.
-    p->sendServerListEnd();
+    p->sendServerList(serverList());
 }
 
 void Registry::nameChangedAcc(int id, const QString &name)
@@ -204,6 +263,7 @@ void Registry::nameChangedAcc(int id, const QString &name)
         names.remove(servers[id]->name());
         names.insert(name);
         servers[id]->name() = name;
+        serverChanged(id);
     }
 }
 
@@ -220,6 +280,11 @@ void Registry::portSet(int id, int port, int oldport)
     serverAddresses.insert(s->getAddress(port));
 }
 
+void Registry::serverChanged(int id)
+{
+    outdatedServers.insert(id);
+}
+
 void Registry::disconnection(int id)
 {
     printLine(QString("Received disconnection from id %1").arg(id));
@@ -232,11 +297,16 @@ void Registry::disconnection(int id)
             ipCounter.remove(s->ip());
         serverAddresses.remove(s->getAddress(s->port()));
         servers.remove(id);
+        if (s->listed()) {
+            serverChanged(id);
+        }
+        freeIds.push_back(id);
         delete s;
     } else if (players.contains(id)) {
         Player *p = players[id];
         AntiDos::obj()->disconnect(p->ip(), id);
         players.remove(id);
+        freeIds.push_back(id);
         delete p;
     }
 }
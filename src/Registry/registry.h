@@ -24,6 +24,7 @@ private slots:
 
     void nameChangedAcc(int id, const QString &name);
     void portSet(int id, int port, int oldport);
+    void serverChanged(int id);
     void disconnection(int id);
 
     /* Called by the anti DoS */
@@ -42,6 +43,17 @@ private:
     QSet<QString> names;
     QSet<QString> serverAddresses;
 
+    /* The PlayersList commands of the listed servers, by id. The ones in outdatedServers
+       are serialized again the next time the list is sent, so that the players count
+       of a server can change many times between two clients connecting for nothing */
+    QMap<int, QByteArray> listings;
+    QSet<int> outdatedServers;
+    /* The whole list as sent to the clients, framed and followed by ServerListEnd */
+    QByteArray serverListPacket;
+    bool zipServerList;
+
+    const QByteArray &serverList();
+
     QTcpServer forPlayers[2];
     QHash<int, Player *> players;
 
@@ -56,7 +68,14 @@ private:
     QScrollDownTextBrowser *mainChat;
     int linecount;
 
+    /* Ids of the disconnected players and servers, given again first */
+    QVector<int> freeIds;
+    /* No player or server had this id or a higher one yet */
+    int nextId;
+
+    /* The id the next connection gets, takeId() when it's given */
     int freeid() const;
+    void takeId(int id);
 #ifdef USE_WEBCONF
     RegistryWebInterface *web_interface;
     friend class RegistryWebInterface;
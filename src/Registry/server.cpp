@@ -6,6 +6,10 @@ Server::Server(int _id, QTcpSocket *s)
     id() = _id;
     ip() = s->peerAddress().toString();
     listed() = false;
+    players() = 0;
+    maxPlayers() = 0;
+    port() = 0;
+    passwordProtected() = false;
 
     m_relay = new Analyzer(s, id());
     m_relay->setParent(this);
@@ -30,6 +34,9 @@ void Server::login(const QString &name, const QString &desc, quint16 num, quint1
     port() = nport;
 
     emit portSet(id(), nport, oldport);
+    if (nport != oldport) {
+        emit listingChanged(id());
+    }
 }
 
 QString Server::getAddress(int port) const
@@ -37,14 +44,28 @@ QString Server::getAddress(int port) const
     return ip() + ":" + QString::number(port);
 }
 
+QByteArray Server::listing() const
+{
+    return Analyzer::makeCommand(NetworkReg::PlayersList, name(), desc(), players(), ip(), maxPlayers(),
+                                 quint16(port() == 0 ? 5080 : port()), passwordProtected());
+}
+
 void Server::descChanged(const QString &desc)
 {
-    this->desc() = desc.left(500).trimmed();
+    QString trimmed = desc.left(500).trimmed();
+
+    if (trimmed != this->desc()) {
+        this->desc() = trimmed;
+        emit listingChanged(id());
+    }
 }
 
 void Server::numChanged(quint16 num)
 {
-    players() = num;
+    if (num != players()) {
+        players() = num;
+        emit listingChanged(id());
+    }
 }
 
 void Server::nameChanged(const QString &name)
@@ -62,11 +83,17 @@ void Server::nameChanged(const QString &name)
 
 void Server::maxChanged(const quint16 max)
 {
-    this->maxPlayers() = max;
+    if (max != maxPlayers()) {
+        this->maxPlayers() = max;
+        emit listingChanged(id());
+    }
 }
 
 void Server::passToggled(bool toggle) {
-    this->passwordProtected() = toggle;
+    if (toggle != passwordProtected()) {
+        this->passwordProtected() = toggle;
+        emit listingChanged(id());
+    }
 }
 
 void Server::refuseIP()
@@ -83,6 +110,7 @@ void Server::accept()
 {
     m_relay->sendAccept();
     listed() = true;
+    emit listingChanged(id());
 }
 
 void Server::disconnected()
@@ -28,6 +28,8 @@ public:
     void accept();
     void kick();
     QString getAddress(int port) const;
+    /* The PlayersList command for the clients, unframed */
+    QByteArray listing() const;
 public slots:
     void login(const QString &, const QString &, quint16, quint16,quint16, bool);
     void numChanged(quint16);
@@ -39,6 +41,8 @@ public slots:
 signals:
     void nameChangedReq(int id, const QString &name);
     void portSet(int id, int port, int oldport);
+    /* What listing() returns changed */
+    void listingChanged(int id);
     void disconnection(int id);
 private:
     Analyzer *m_relay;
@@ -31,7 +31,11 @@ SOURCES += main.cpp \
     registrycommunicator.cpp \
     battleanalyzer.cpp \
     sql.cpp \
-    sqlconfig.cpp
+    sqlconfig.cpp \
+    matchmaking.cpp \
+    ladderfile.cpp \
+    banfilter.cpp \
+    memberfile.cpp
 !CONFIG(nogui):SOURCES += mainwindow.cpp \
     playerswindow.cpp \
     serverwidget.cpp \
@@ -68,7 +72,11 @@ HEADERS += player.h \
     registrycommunicator.h \
     battleanalyzer.h \
     sql.h \
-    sqlconfig.h
+    sqlconfig.h \
+    matchmaking.h \
+    ladderfile.h \
+    banfilter.h \
+    memberfile.h
 !CONFIG(nogui):HEADERS += mainwindow.h \
     battlingoptions.h \
     playerswindow.h \
@@ -56,7 +56,7 @@ void Analyzer::engageBattle(int battleid, int myid, int id, const TeamBattle &te
 
     out << name1 << name2;
 
-    emit sendCommand(tosend);
+    emitCommand(tosend);
 }
 
 void Analyzer::spectateBattle(int battleid, const BattleConfiguration &conf, const QString &name1, const QString &name2)
@@ -70,7 +70,7 @@ void Analyzer::spectateBattle(int battleid, const BattleConfiguration &conf, con
 
         out << name1 << name2;
 
-        emit sendCommand(tosend);
+        emitCommand(tosend);
     } else {
         notify(SpectateBattle, Flags(1), qint32(battleid), conf, name1, name2);
     }
@@ -109,7 +109,7 @@ void Analyzer::sendLogin(const PlayerInfo &p, const QStringList &tiers, const QB
 
     out << p << tiers;
 
-    emit sendCommand(tosend);
+    emitCommand(tosend);
 }
 
 void Analyzer::sendRankings(quint32 id, const QHash<QString, quint32> &rankings, const QHash<QString, quint16> &ratings)
@@ -123,7 +123,7 @@ void Analyzer::sendRankings(quint32 id, const QHash<QString, quint32> &rankings,
         out << tier << ratings.value(tier) << rankings.value(tier) << quint32(TierMachine::obj()->tier(tier).count());
     }
 
-    emit sendCommand(tosend);
+    emitCommand(tosend);
 }
 
 void Analyzer::notifyOptionsChange(qint32 id, bool away, bool ladder)
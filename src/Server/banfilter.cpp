@@ -0,0 +1,202 @@
+#include <PokemonInfo/pokemoninfo.h>
+#include <PokemonInfo/battlestructs.h>
+#include <PokemonInfo/movesetchecker.h>
+#include "banfilter.h"
+
+BanBitmap::BanBitmap() : others(false)
+{
+}
+
+void BanBitmap::clear()
+{
+    bits.clear();
+    others = false;
+}
+
+void BanBitmap::grow(int size)
+{
+    int words = (size + 63) / 64;
+    int old = bits.size();
+
+    if (words <= old) {
+        return;
+    }
+
+    bits.resize(words);
+    /* The new words take the state of the numbers that were past the bitmap */
+    for (int i = old; i < words; i++) {
+        bits[i] = others ? ~quint64(0) : 0;
+    }
+}
+
+void BanBitmap::ban(const QSet<int> &nums)
+{
+    foreach(int num, nums) {
+        if (num < 0) {
+            continue;
+        }
+        grow(num + 1);
+        bits[num >> 6] |= quint64(1) << (num & 63);
+    }
+}
+
+void BanBitmap::banAllBut(const QSet<int> &nums, bool exceptZero)
+{
+    int max = 0;
+    foreach(int num, nums) {
+        max = std::max(max, num);
+    }
+    grow(max + 1);
+
+    QVector<quint64> allowed(bits.size(), 0);
+    foreach(int num, nums) {
+        if (num >= 0) {
+            allowed[num >> 6] |= quint64(1) << (num & 63);
+        }
+    }
+    if (exceptZero) {
+        allowed[0] |= 1;
+    }
+
+    for (int i = 0; i < bits.size(); i++) {
+        bits[i] |= ~allowed[i];
+    }
+    others = true;
+}
+
+BanFilter::BanFilter() : illegal(false)
+{
+}
+
+void BanFilter::clear()
+{
+    pokes.clear();
+    moves.clear();
+    items.clear();
+    abilities.clear();
+    restricted.clear();
+    illegal = false;
+    movesetChecks.clear();
+}
+
+QSet<int> BanFilter::pokeNums(const QSet<Pokemon::uniqueId> &pokes)
+{
+    QSet<int> ret;
+    foreach(Pokemon::uniqueId poke, pokes) {
+        ret.insert(pokeNum(poke));
+    }
+    return ret;
+}
+
+void BanFilter::addTier(bool banMode, const QSet<Pokemon::uniqueId> &pokes, const QSet<int> &moves, const QSet<int> &items,
+                        const QSet<int> &abilities)
+{
+    if (banMode) {
+        this->pokes.ban(pokeNums(pokes));
+        this->moves.ban(moves);
+        this->items.ban(items);
+        this->abilities.ban(abilities);
+        return;
+    }
+
+    /* The "restrict" mode, so instead we force the pokemons to have
+       some characteristics. An empty slot of a pokemon is always fine */
+    if (pokes.size() > 0) {
+        this->pokes.banAllBut(pokeNums(pokes), false);
+    }
+    if (moves.size() > 0) {
+        this->moves.banAllBut(moves, true);
+    }
+    if (items.size() > 0) {
+        this->items.banAllBut(items, true);
+    }
+    if (abilities.size() > 0) {
+        this->abilities.banAllBut(abilities, true);
+    }
+}
+
+void BanFilter::banIllegal()
+{
+    illegal = true;
+}
+
+void BanFilter::checkMovesets(Pokemon::gen gen, int minGen)
+{
+    QPair<Pokemon::gen, int> check(gen, minGen);
+
+    if (!movesetChecks.contains(check)) {
+        movesetChecks.push_back(check);
+    }
+}
+
+void BanFilter::setRestricted(const QSet<Pokemon::uniqueId> &pokes)
+{
+    restricted.clear();
+    restricted.ban(pokeNums(pokes));
+}
+
+bool BanFilter::isBanned(const PokeBattle &p) const
+{
+    if (pokes.contains(pokeNum(PokemonInfo::NonAestheticForme(p.num())))) {
+        return true;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (moves.contains(p.move(i).num())) {
+            return true;
+        }
+    }
+    if (items.contains(p.item()) || abilities.contains(p.ability())) {
+        return true;
+    }
+    if (illegal && p.illegal()) {
+        return true;
+    }
+
+    /* The expensive part */
+    for (int i = 0; i < movesetChecks.size(); i++) {
+        if (!MoveSetChecker::isValid(p.num(), movesetChecks[i].first, p.move(0).num(), p.move(1).num(), p.move(2).num(), p.move(3).num(),
+                                     p.ability(), p.gender(), p.level(), false, NULL, NULL, movesetChecks[i].second)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool BanFilter::isRestricted(const PokeBattle &p) const
+{
+    return restricted.contains(pokeNum(PokemonInfo::NonAestheticForme(p.num())));
+}
+
+QString BanFilter::bannedReason(const PokeBattle &p) const
+{
+    QStringList errors;
+
+    if (pokes.contains(pokeNum(PokemonInfo::NonAestheticForme(p.num())))) {
+        errors.push_back(QString("Pokemon %1 is banned").arg(PokemonInfo::Name(p.num())));
+    }
+    for (int i = 0; i < 4; i++) {
+        int move = p.move(i).num();
+        if (moves.contains(move)) {
+            QString error = QString("Move %1 is banned").arg(MoveInfo::Name(move));
+            if (!errors.contains(error)) {
+                errors.push_back(error);
+            }
+        }
+    }
+    if (items.contains(p.item())) {
+        errors.push_back(QString("Item %1 is banned").arg(ItemInfo::Name(p.item())));
+    }
+    if (abilities.contains(p.ability())) {
+        errors.push_back(QString("Ability %1 is banned").arg(AbilityInfo::Name(p.ability())));
+    }
+    if (illegal && p.illegal()) {
+        errors.push_back(QString("Pokemon %1 has an illegal set").arg(PokemonInfo::Name(p.num())));
+    }
+
+    if (errors.empty()) {
+        return QString();
+    }
+
+    return errors.join(", ") + ".";
+}
@@ -0,0 +1,73 @@
+#ifndef BANFILTER_H
+#define BANFILTER_H
+
+#include <PokemonInfo/pokemon.h>
+#include <PokemonInfo/geninfo.h>
+#include <QtCore>
+
+struct PokeBattle;
+
+/* Set of banned numbers (moves, items, ...), one bit each. Numbers past the
+   bitmap all share the same state, banned or not */
+class BanBitmap
+{
+public:
+    BanBitmap();
+
+    void clear();
+    bool contains(int num) const {
+        if (num < 0 || num >= bits.size() * 64) {
+            return others;
+        }
+        return (bits[num >> 6] >> (num & 63)) & 1;
+    }
+
+    void ban(const QSet<int> &nums);
+    /* Bans everything but the numbers given, and except 0 if exceptZero is set */
+    void banAllBut(const QSet<int> &nums, bool exceptZero);
+private:
+    void grow(int size);
+
+    QVector<quint64> bits;
+    bool others;
+};
+
+/*
+  Bans of a tier together with the ones of its ban parents, flattened in one place.
+
+  The chain of tiers is walked once when the tiers are loaded, after that checking a pokemon is
+  a bit test for each of its species, moves, item and ability. The only thing that can't be
+  precompiled is the moveset check of tiers with a minimum gen, done last.
+*/
+class BanFilter
+{
+public:
+    BanFilter();
+
+    void clear();
+    /* Adds the bans of a tier of the chain. In ban mode, what is listed is banned, otherwise
+       what isn't listed is banned (if the list isn't empty) */
+    void addTier(bool banMode, const QSet<Pokemon::uniqueId> &pokes, const QSet<int> &moves, const QSet<int> &items,
+                 const QSet<int> &abilities);
+    void banIllegal();
+    void checkMovesets(Pokemon::gen gen, int minGen);
+    void setRestricted(const QSet<Pokemon::uniqueId> &pokes);
+
+    bool isBanned(const PokeBattle &p) const;
+    bool isRestricted(const PokeBattle &p) const;
+    /* Empty if the pokemon isn't banned for one of those reasons */
+    QString bannedReason(const PokeBattle &p) const;
+
+    /* Formes have a subnum way below that */
+    static int pokeNum(const Pokemon::uniqueId &id) {
+        return id.subnum < 64 ? (id.pokenum << 6) + id.subnum : -1;
+    }
+private:
+    static QSet<int> pokeNums(const QSet<Pokemon::uniqueId> &pokes);
+
+    BanBitmap pokes, moves, items, abilities, restricted;
+    bool illegal;
+    QVector<QPair<Pokemon::gen, int> > movesetChecks;
+};
+
+#endif // BANFILTER_H
@@ -46,6 +46,15 @@ void BattleAnalyzer::dealWithCommand(const QByteArray &commandline)
         emit battleMessage(bid, p, message);
         break;
     }
+    case BattleBroadcast: {
+        qint32 bid, except;
+        QByteArray message;
+
+        in >> bid >> except >> message;
+
+        emit battleBroadcast(bid, except, message);
+        break;
+    }
     case BattleFinished: {
         qint32 bid, result, winner, loser;
 
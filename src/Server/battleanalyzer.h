@@ -21,6 +21,7 @@ public:
 signals:
     void sendBattleInfos(int bid, int p1, int p2, const TeamBattle &t, const BattleConfiguration &c, const QString &tier);
     void battleMessage(int bid, int p, const QByteArray &info);
+    void battleBroadcast(int bid, int except, const QByteArray &info);
     void battleResult(int bid, int result, int winner, int loser);
 public slots:
     void keepAlive();
@@ -122,6 +122,7 @@ void BattleCommunicator::showResult(int battleid, int result, int loser)
 void BattleCommunicator::removeBattle(int battleid)
 {
     delete mybattles.take(battleid);
+    spectatorsReady.remove(battleid);
 
     relay->notify(BattleFinished, qint32(battleid), uchar(Close));
 }
@@ -139,6 +140,9 @@ void BattleCommunicator::removeSpectator(int idOfBattle, int id)
         qFatal("Critical bug needing to be solved: BattleCommunicator::removeSpectator, player %d and non-existent battle %d", id, idOfBattle);
     } else {
         mybattles[idOfBattle]->spectators.remove(id);
+        if (spectatorsReady.contains(idOfBattle)) {
+            spectatorsReady[idOfBattle].remove(id);
+        }
 
         relay->notify(SpectateBattle, qint32(idOfBattle), false, qint32(id));
     }
@@ -152,6 +156,11 @@ FullBattleConfiguration *BattleCommunicator::battle(int battleid)
     return mybattles.value(battleid);
 }
 
+QSet<int> BattleCommunicator::liveSpectators(int battleid) const
+{
+    return spectatorsReady.value(battleid);
+}
+
 void BattleCommunicator::killServer()
 {
     if (battleServer->state() == QProcess::Running) {
@@ -210,6 +219,7 @@ void BattleCommunicator::connectToBattleServer()
 
     connect(relay, SIGNAL(sendBattleInfos(int,int,int,TeamBattle,BattleConfiguration,QString)), SLOT(filterBattleInfos(int,int,int,TeamBattle,BattleConfiguration,QString)));
     connect(relay, SIGNAL(battleMessage(int,int,QByteArray)), SLOT(filterBattleInfo(int,int,QByteArray)));
+    connect(relay, SIGNAL(battleBroadcast(int,int,QByteArray)), SLOT(filterBattleBroadcast(int,int,QByteArray)));
     connect(relay, SIGNAL(battleResult(int,int,int,int)), SLOT(filterBattleResult(int,int,int,int)));
 }
 
@@ -292,17 +302,46 @@ void BattleCommunicator::filterBattleInfo(int battleid, int player, const QByteA
     if (contains(battleid)) {
         FullBattleConfiguration *battle = mybattles[battleid];
 
-        /* Show variation here */
-        if (battle->rated() && info.length() > 0 && (battle->id(0) == player || battle->id(1) == player) && info[0] == BattleCommands::Rated) {
-            QPair<int,int> firstChange = TierMachine::obj()->pointChangeEstimate(battle->name[battle->spot(player)], battle->name[battle->opponent(battle->spot(player))], battle->tier());
-
-            emit battleInfo(battleid, player, pack(BattleCommands::PointEstimate, battle->spot(player), qint8(firstChange.first), qint8(firstChange.second)));
+        if (battle->id(0) == player || battle->id(1) == player) {
+            sendPointEstimate(battleid, player, info);
+        } else if (battle->spectators.contains(player)) {
+            /* The battle server sends the state of the battle to new spectators directly */
+            spectatorsReady[battleid].insert(player);
         }
     }
 
     emit battleInfo(battleid, player, info);
 }
 
+void BattleCommunicator::filterBattleBroadcast(int battleid, int except, const QByteArray &info)
+{
+    if (!contains(battleid)) {
+        return;
+    }
+
+    FullBattleConfiguration *battle = mybattles[battleid];
+
+    for (int i = 0; i < 2; i++) {
+        if (battle->id(i) != except) {
+            sendPointEstimate(battleid, battle->id(i), info);
+        }
+    }
+
+    emit battleBroadcast(battleid, except, info);
+}
+
+void BattleCommunicator::sendPointEstimate(int battleid, int player, const QByteArray &info)
+{
+    FullBattleConfiguration *battle = mybattles[battleid];
+
+    /* Show variation here */
+    if (battle->rated() && info.length() > 0 && info[0] == BattleCommands::Rated) {
+        QPair<int,int> firstChange = TierMachine::obj()->pointChangeEstimate(battle->name[battle->spot(player)], battle->name[battle->opponent(battle->spot(player))], battle->tier());
+
+        emit battleInfo(battleid, player, pack(BattleCommands::PointEstimate, battle->spot(player), qint8(firstChange.first), qint8(firstChange.second)));
+    }
+}
+
 void BattleCommunicator::filterBattleResult(int b, int r, int w, int l)
 {
     //qDebug() << "battle result " << b;
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QString>
 #include <QHash>
+#include <QSet>
 #include <QProcess>
 
 #include <Utilities/coreclasses.h>
@@ -41,11 +42,14 @@ public:
     void removeSpectator(int battleid, int id);
 
     FullBattleConfiguration *battle(int battleid);
+    /* The spectators the battle server started sending the battle to */
+    QSet<int> liveSpectators(int battleid) const;
 signals:
     void info(const QString &message);
     void error();
     void battleConnectionLost();
     void battleInfo(int,int,const QByteArray&);
+    void battleBroadcast(int battle, int except, const QByteArray &info);
     void battleFinished(int,int,int,int);
     void sendBattleInfos(int,int,int,const TeamBattle&,const BattleConfiguration&,const QString&);
 public slots:
@@ -63,6 +67,7 @@ public slots:
     /* Battle server -> player */
     void filterBattleInfos(int,int,int,const TeamBattle&,const BattleConfiguration&,const QString&);
     void filterBattleInfo(int battle, int player, const QByteArray &info);
+    void filterBattleBroadcast(int battle, int except, const QByteArray &info);
     void filterBattleResult(int, int, int, int);
     void removeBattles();
     /* Server -> Battle server */
@@ -77,9 +82,13 @@ private:
     bool wasConnected;
 
     QHash<int, FullBattleConfiguration*> mybattles;
+    /* Spectators are only sent the broadcasts once the battle server
+       has sent them the current state of the battle */
+    QHash<int, QSet<int> > spectatorsReady;
     QString mod;
 
     void showResult(int battle, int result, int loser);
+    void sendPointEstimate(int battleid, int player, const QByteArray &info);
 
     template <typename ...Params>
     QByteArray pack(int command, int who, Params&&... params) {
@@ -6,6 +6,7 @@
 #include "server.tpp"
 #include "analyze.h"
 #include "scriptengine.h"
+#include "networkutilities.h"
 
 QNickValidator *Channel::checker = new QNickValidator(nullptr);
 
@@ -27,27 +28,51 @@ void Channel::addBattle(int battleid, const Battle &b)
         return;
     }
 
-    battleList[battleid] = b;
+    insertBattle(battleid, b);
     foreach(int pid, players) {
         server->player(pid)->relay().sendChannelBattle(id(), battleid, b);
     }
 }
 
+void Channel::insertBattle(int battleid, const Battle &b)
+{
+    battleList.insert(battleid, b);
+    outdateBattles();
+}
+
+void Channel::removeBattle(int battleid)
+{
+    if (battleList.remove(battleid) > 0) {
+        outdateBattles();
+    }
+}
+
+void Channel::sendBattleList(Player *p) const
+{
+    p->sendPacket(battleListPacket(p->relay().protocolVersion(), p->supportsZip()));
+}
+
 void Channel::playerJoin(int pid)
 {
     Player *player = server->player(pid);
 
     notifyJoin(pid);
+    changeMembership(pid, true);
 
     disconnectedPlayers.remove(pid);
     players.insert(pid);
+    outdateMembers();
 
     player->addChannel(id());
 
     server->printLine(QString("%1 joined channel %2.").arg(player->name(), name()));
 
     foreach(int pid2, players) {
-        server->player(pid2)->relay().sendJoin(pid, id());
+        Player *p = server->player(pid2);
+        /* The player joining is told right away, it's what opens the channel on his side */
+        if (pid2 == pid || !p->supportsChannelDeltas()) {
+            p->relay().sendJoin(pid, id());
+        }
     }
 
     addBattles(player);
@@ -73,6 +98,8 @@ void Channel::leaveRequest(int pid)
         removeBattles(player);
 
         players.remove(pid);
+        bundles.remove(pid);
+        outdateMembers();
         player->removeChannel(id());
 
         //server->printLine(QString("%1 left channel %2.").arg(player->name(), name()));
@@ -91,29 +118,19 @@ void Channel::leaveRequest(int pid)
 
 void Channel::onReconnect(int playerid)
 {
-    QVector<qint32> ids;
-    ids.reserve(players.size());
-
     Player *player = server->player(playerid);
 
-    QVector<reference<PlayerInfo> > bundles;
-
-    Analyzer &relay = player->relay();
+    QSet<int> unknown;
     foreach(int pid, players) {
-        ids.push_back(pid);
-
-        Player *p = server->player(pid);
-        if (!p->isInSameChannel(player)) {
-            bundles.push_back(&p->bundle());
+        if (!server->player(pid)->isInSameChannel(player)) {
+            unknown.insert(pid);
         }
     }
 
-    player->sendPlayers(bundles);
-
-    relay.sendChannelPlayers(id(), ids);
+    sendPlayers(player, unknown);
     player->addChannel(id());
 
-    relay.sendBattleList(id(), battleList);
+    sendBattleList(player);
 }
 
 void Channel::warnAboutRemoval()
@@ -131,6 +148,8 @@ void Channel::warnAboutRemoval()
 
     players.clear();
     disconnectedPlayers.clear();
+    bundles.clear();
+    outdateMembers();
 }
 
 void Channel::onRemoval()
@@ -155,38 +174,232 @@ Channel::~Channel()
 }
 
 
+void Channel::outdatePlayer(int pid)
+{
+    if (bundles.remove(pid) > 0) {
+        playersPackets[0].clear();
+        playersPackets[1].clear();
+    }
+}
+
 void Channel::notifyJoin(int pid)
 {
     Player *player = server->player(pid);
 
-    QVector<qint32> ids;
-    ids.reserve(players.size());
-
     /* Players of this channel which don't already know the new player */
     QSet<Player*> unknown;
-    /* The info of those players, to be sent to the player to join */
-    QVector<reference<PlayerInfo> > bundles;
+    /* Their info is to be sent to the player to join */
+    QSet<int> unknownIds;
 
-    Analyzer &relay = player->relay();
     foreach(int pid2, players) {
         Player *p = server->player(pid2);
         if (!p->isInSameChannel(player)) {
             unknown.insert(p);
-            bundles.push_back(&p->bundle());
+            unknownIds.insert(pid2);
         }
-        ids.push_back(p->id());
     }
 
     server->notifyGroup(unknown, NetworkServ::PlayersList, player->bundle());
 
-    player->sendPlayers(bundles);
-    relay.sendChannelPlayers(id(), ids);
+    sendPlayers(player, unknownIds);
+}
+
+void Channel::sendPlayers(Player *p, const QSet<int> &unknown)
+{
+    bool zipped = p->supportsZip();
+
+    /* Sending the info of players already known doesn't hurt, it's cheaper than building
+       a packet just for them */
+    if (unknown.size() * 2 >= players.size()) {
+        p->sendPacket(playersPacket(zipped));
+    } else if (!unknown.empty()) {
+        QByteArray command(1, char(NetworkServ::PlayersList));
+        foreach(int pid, unknown) {
+            command.append(bundle(pid));
+        }
+        p->sendPacket(zipped ? frameZipPacket(command) : framePacket(command));
+    }
+
+    p->sendPacket(idsPacket(zipped));
+}
+
+const QByteArray &Channel::bundle(int pid) const
+{
+    QHash<int, QByteArray>::iterator it = bundles.find(pid);
+
+    if (it == bundles.end()) {
+        QByteArray data;
+        DataStream out(&data, QIODevice::WriteOnly);
+        out << server->player(pid)->bundle();
+
+        it = bundles.insert(pid, data);
+    }
+
+    return *it;
+}
+
+const QByteArray &Channel::playersPacket(bool zipped) const
+{
+    QByteArray &packet = playersPackets[zipped];
+
+    if (packet.isEmpty()) {
+        QByteArray command(1, char(NetworkServ::PlayersList));
+        foreach(int pid, players) {
+            command.append(bundle(pid));
+        }
+        packet = zipped ? frameZipPacket(command) : framePacket(command);
+    }
+
+    return packet;
+}
+
+const QByteArray &Channel::idsPacket(bool zipped) const
+{
+    QByteArray &packet = idsPackets[zipped];
+
+    if (packet.isEmpty()) {
+        QVector<qint32> ids;
+        ids.reserve(players.size());
+        foreach(int pid, players) {
+            ids.push_back(pid);
+        }
+        packet = zipped ? makeZipPacket(NetworkServ::ChannelPlayers, qint32(id()), ids) : makePacket(NetworkServ::ChannelPlayers, qint32(id()), ids);
+    }
+
+    return packet;
+}
+
+const QByteArray &Channel::battleListPacket(const ProtocolVersion &version, bool zipped) const
+{
+    /* Battles are serialized differently for older clients */
+    QHash<int, QByteArray> &packets = battleListPackets[zipped];
+    QHash<int, QByteArray>::iterator it = packets.find(version.version);
+
+    if (it == packets.end()) {
+        QByteArray command;
+        DataStream out(&command, QIODevice::WriteOnly, version.version);
+        out.pack(uchar(NetworkServ::BattleList), qint32(id()), battleList);
+
+        it = packets.insert(version.version, zipped ? frameZipPacket(command) : framePacket(command));
+    }
+
+    return *it;
+}
+
+void Channel::outdateMembers()
+{
+    playersPackets[0].clear();
+    playersPackets[1].clear();
+    idsPackets[0].clear();
+    idsPackets[1].clear();
+}
+
+void Channel::outdateBattles()
+{
+    battleListPackets[0].clear();
+    battleListPackets[1].clear();
 }
 
 void Channel::notifyLeave(int pid)
 {
+    changeMembership(pid, false);
+
     foreach(int pid2, players) {
-        server->player(pid2)->relay().notify(NetworkServ::LeaveChannel, qint32(id()), qint32(pid));
+        Player *p = server->player(pid2);
+        /* Same as when joining, the player leaving closes the channel on receipt */
+        if (pid2 == pid || !p->supportsChannelDeltas()) {
+            p->relay().notify(NetworkServ::LeaveChannel, qint32(id()), qint32(pid));
+        }
+    }
+}
+
+void Channel::changeOptions(int pid, quint8 options)
+{
+    if (server->channelDeltaWindow() <= 0) {
+        return;
+    }
+
+    MemberDelta &d = delta(pid);
+    d.hasOptions = true;
+    d.options = options;
+}
+
+void Channel::logout(int pid)
+{
+    if (server->channelDeltaWindow() <= 0) {
+        return;
+    }
+
+    delta(pid).loggedOut = true;
+}
+
+void Channel::changeMembership(int pid, bool member)
+{
+    if (server->channelDeltaWindow() <= 0) {
+        return;
+    }
+
+    MemberDelta &d = delta(pid);
+    d.member = member;
+    if (member) {
+        /* Reconnecting under the same id */
+        d.joined = true;
+        d.loggedOut = false;
+    }
+}
+
+Channel::MemberDelta &Channel::delta(int pid)
+{
+    if (deltas.empty()) {
+        QTimer::singleShot(server->channelDeltaWindow(), this, SLOT(sendDeltas()));
+    }
+
+    if (!deltas.contains(pid)) {
+        MemberDelta &d = deltas[pid];
+        d.wasMember = d.member = players.contains(pid);
+        return d;
+    }
+
+    return deltas[pid];
+}
+
+void Channel::sendDeltas()
+{
+    QVector<qint32> joined, left, optionIds, loggedOut;
+    QVector<quint8> options;
+
+    QHashIterator<int, MemberDelta> it(deltas);
+    while (it.hasNext()) {
+        it.next();
+        const MemberDelta &d = it.value();
+
+        if (d.member && !d.wasMember) {
+            joined.push_back(it.key());
+        } else if (!d.member && (d.wasMember || d.joined)) {
+            left.push_back(it.key());
+        }
+        if (d.hasOptions) {
+            optionIds.push_back(it.key());
+            options.push_back(d.options);
+        }
+        if (d.loggedOut) {
+            loggedOut.push_back(it.key());
+        }
+    }
+
+    deltas.clear();
+
+    if (joined.empty() && left.empty() && optionIds.empty() && loggedOut.empty()) {
+        return;
+    }
+
+    QByteArray packet = makePacket(NetworkServ::ChannelDelta, qint32(id()), joined, left, optionIds, options, loggedOut);
+
+    foreach(int pid, players) {
+        Player *p = server->player(pid);
+        if (p->supportsChannelDeltas()) {
+            p->sendPacket(packet);
+        }
     }
 }
 
@@ -203,7 +416,7 @@ void Channel::addBattles(Player *player)
         }
     }
 
-    player->relay().sendBattleList(id(), battleList);
+    sendBattleList(player);
 }
 
 void Channel::removeBattles(Player *player)
@@ -214,7 +427,7 @@ void Channel::removeBattles(Player *player)
             Battle b = server->ongoingBattle(battleid);
             /* We remove the battle only if only one (or less) of the players are in the channel */
             if (int(players.contains(b.id1)) + int(players.contains(b.id2)) < 2) {
-                battleList.remove(battleid);
+                removeBattle(battleid);
             }
         }
     }
@@ -19,6 +19,10 @@ public:
     ~Channel();
 
     void addBattle(int battleid, const Battle &b);
+    /* Adds / removes a battle without telling the members, the server does */
+    void insertBattle(int battleid, const Battle &b);
+    void removeBattle(int battleid);
+    void sendBattleList(Player *p) const;
     void leaveRequest(int pid);
     void playerJoin(int pid);
     void addDisconnectedPlayer(int pid);
@@ -40,14 +44,61 @@ public:
     bool isEmpty() const;
     int count() const;
 
+    /* The info of the player changed, to call before telling the other members */
+    void outdatePlayer(int pid);
+
+    /* Changes of the members that the players supporting it get batched in a ChannelDelta
+       packet, every Server::channelDeltaWindow() ms. Joins and leaves are recorded by
+       playerJoin() and leaveRequest() */
+    void changeOptions(int pid, quint8 options);
+    void logout(int pid);
+
 signals:
     void closeRequest(int id);
 
+private slots:
+    void sendDeltas();
+
 private:
+    struct MemberDelta {
+        MemberDelta() : wasMember(false), member(false), joined(false), loggedOut(false), hasOptions(false), options(0) {}
+
+        /* Member before and after the changes, only the difference is sent. Someone who joins and leaves
+           in between is still sent as leaving, as the members got their info */
+        bool wasMember, member, joined;
+        bool loggedOut;
+        bool hasOptions;
+        quint8 options;
+    };
+
+    /* Pending changes of the player, the first one starts the timer to send them */
+    MemberDelta &delta(int pid);
+    void changeMembership(int pid, bool member);
+
+    QHash<int, MemberDelta> deltas;
+
     void addBattles(Player *p);
     void removeBattles(Player *p);
     void notifyJoin(int pid);
     void notifyLeave(int pid);
+
+    /* Sends the players list and the ids of the members, only with the info of the players
+       in unknown (or of all the members, if most of them are) */
+    void sendPlayers(Player *p, const QSet<int> &unknown);
+
+    /* Packets for the players joining, built when first needed and kept until the channel changes.
+       The member list doesn't depend on the protocol version, the battle list does */
+    const QByteArray &bundle(int pid) const;
+    const QByteArray &playersPacket(bool zipped) const;
+    const QByteArray &idsPacket(bool zipped) const;
+    const QByteArray &battleListPacket(const ProtocolVersion &version, bool zipped) const;
+    void outdateMembers();
+    void outdateBattles();
+
+    /* Serialized info of each member, to put together in PlayersList packets */
+    mutable QHash<int, QByteArray> bundles;
+    mutable QByteArray playersPackets[2], idsPackets[2];
+    mutable QHash<int, QByteArray> battleListPackets[2];
 public:
     QSet<int> players;
     QSet<int> disconnectedPlayers;
@@ -4,6 +4,8 @@
 #include "server.h"
 #include "pluginmanager.h"
 #include "consolereader.h"
+#include "security.h"
+#include "tiermachine.h"
 
 ConsoleReader::ConsoleReader(Server* server) : m_Server(server), m_TextStream(stdin)
 {
@@ -27,6 +29,9 @@ void ConsoleReader::read(int)
             }
         } else if (line == "listp") {
             m_Server->forcePrint("Plugins: " + m_Server->pluginManager->getPlugins().join(", "));
+        } else if (line == "dbstats") {
+            m_Server->forcePrint("Members: " + SecurityManager::writeStats());
+            m_Server->forcePrint("Tiers: " + TierMachine::obj()->writeStats());
         }
         else {
             m_Server->sendServerMessage(line);
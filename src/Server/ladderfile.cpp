@@ -0,0 +1,366 @@
+#include "ladderfile.h"
+#include "tier.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+struct LadderFile::Header
+{
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+    /* Records written so far, used or not */
+    quint32 records;
+    quint32 reserved[11];
+};
+
+struct LadderFile::Record
+{
+    enum {
+        Used = 1
+    };
+
+    quint32 flags;
+    /* The slot with the highest one is the current one */
+    quint32 sequence;
+    qint32 matches;
+    qint32 rating;
+    qint32 displayedRating;
+    qint32 lastCheckTime;
+    qint32 bonusTime;
+    qint32 winCount;
+    quint16 nameLength;
+    quint16 checksum;
+    quint16 name[MaxNameLength];
+};
+
+struct LadderFile::Entry
+{
+    Record slots[2];
+};
+
+static const char ladderMagic[8] = {'P', 'O', 'L', 'A', 'D', 'D', 'E', 'R'};
+/* Records to start with, the file then doubles in size each time it's full */
+static const int initialCapacity = 1024;
+
+LadderFile::LadderFile() : data(nullptr), capacity(0)
+{
+}
+
+LadderFile::~LadderFile()
+{
+    close();
+}
+
+bool LadderFile::open(const QString &path)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        error = file.errorString();
+        return false;
+    }
+
+    if (file.size() == 0) {
+        if (!map(initialCapacity)) {
+            close();
+            return false;
+        }
+
+        Header *h = header();
+        memset(h, 0, sizeof(Header));
+        memcpy(h->magic, ladderMagic, sizeof(ladderMagic));
+        h->version = Version;
+        h->recordSize = sizeof(Record);
+        h->records = 0;
+
+        return true;
+    }
+
+    if (file.size() < qint64(sizeof(Header)) || !map((file.size() - sizeof(Header)) / sizeof(Entry))) {
+        if (error.isEmpty()) {
+            error = "File too small";
+        }
+        close();
+        return false;
+    }
+
+    const Header *h = header();
+    if (memcmp(h->magic, ladderMagic, sizeof(ladderMagic)) != 0 || h->version != Version || h->recordSize != sizeof(Record)) {
+        error = "Not a ladder file, or a ladder file from an incompatible version";
+        close();
+        return false;
+    }
+
+    /* The file is grown before the count is updated, so more records than the
+       file can hold means the header is damaged */
+    if (h->records > quint32(capacity)) {
+        error = "Damaged header";
+        close();
+        return false;
+    }
+
+    for (int i = 0; i < records(); i++) {
+        const Record *r = current(i);
+        if (!r) {
+            qDebug() << "Damaged record " << i << " in " << path << ", skipping it";
+            freeRecords.push_back(i);
+        } else if (!(r->flags & Record::Used)) {
+            freeRecords.push_back(i);
+        }
+    }
+
+    return true;
+}
+
+void LadderFile::close()
+{
+    if (data) {
+        sync();
+        file.unmap(data);
+        data = nullptr;
+    }
+    file.close();
+    capacity = 0;
+    freeRecords.clear();
+}
+
+bool LadderFile::isOpen() const
+{
+    return data != nullptr;
+}
+
+QString LadderFile::errorString() const
+{
+    return error;
+}
+
+int LadderFile::records() const
+{
+    return data ? int(header()->records) : 0;
+}
+
+bool LadderFile::read(int index, MemberRating &m)
+{
+    if (index < 0 || index >= records()) {
+        return false;
+    }
+
+    const Record *r = current(index);
+    if (!r || !(r->flags & Record::Used)) {
+        return false;
+    }
+
+    m.name = QString::fromUtf16(r->name, r->nameLength);
+    m.matches = r->matches;
+    m.rating = r->rating;
+    m.displayed_rating = r->displayedRating;
+    m.last_check_time = r->lastCheckTime;
+    m.bonus_time = r->bonusTime;
+    m.winCount = r->winCount;
+    m.filePos = index;
+
+    return true;
+}
+
+bool LadderFile::write(MemberRating &m)
+{
+    if (!data) {
+        return false;
+    }
+    if (m.name.length() > MaxNameLength) {
+        error = QString("Name too long: %1").arg(m.name);
+        return false;
+    }
+
+    Record r;
+    memset(&r, 0, sizeof(Record));
+    r.flags = Record::Used;
+    r.matches = m.matches;
+    r.rating = m.rating;
+    r.displayedRating = m.displayed_rating;
+    r.lastCheckTime = m.last_check_time;
+    r.bonusTime = m.bonus_time;
+    r.winCount = m.winCount;
+    r.nameLength = m.name.length();
+    memcpy(r.name, m.name.utf16(), m.name.length() * sizeof(quint16));
+
+    int index = m.filePos;
+    if (index < 0 || index >= records()) {
+        index = allocate();
+        if (index == -1) {
+            return false;
+        }
+    }
+
+    store(index, r);
+    m.filePos = index;
+
+    /* Only counted once complete */
+    if (index == records()) {
+        header()->records += 1;
+    }
+
+    return true;
+}
+
+void LadderFile::remove(int index)
+{
+    if (index < 0 || index >= records()) {
+        return;
+    }
+
+    const Record *r = current(index);
+    if (r && (r->flags & Record::Used)) {
+        Record unused;
+        memset(&unused, 0, sizeof(Record));
+        store(index, unused);
+        freeRecords.push_back(index);
+    }
+}
+
+void LadderFile::clear()
+{
+    if (!data) {
+        return;
+    }
+
+    header()->records = 0;
+    freeRecords.clear();
+
+    /* Gives the space back */
+    map(initialCapacity);
+}
+
+void LadderFile::sync()
+{
+    if (!data) {
+        return;
+    }
+
+    size_t size = sizeof(Header) + size_t(capacity) * sizeof(Entry);
+#ifdef Q_OS_WIN
+    FlushViewOfFile(data, size);
+#else
+    msync(data, size, MS_SYNC);
+#endif
+}
+
+LadderFile::Header *LadderFile::header() const
+{
+    return reinterpret_cast<Header*>(data);
+}
+
+LadderFile::Entry *LadderFile::entry(int index) const
+{
+    return reinterpret_cast<Entry*>(data + sizeof(Header)) + index;
+}
+
+LadderFile::Record *LadderFile::current(int index) const
+{
+    Record *slots = entry(index)->slots;
+    bool valid0 = valid(slots[0]), valid1 = valid(slots[1]);
+
+    if (valid0 && valid1) {
+        /* The difference is signed so that the numbers can wrap around */
+        return qint32(slots[1].sequence - slots[0].sequence) > 0 ? &slots[1] : &slots[0];
+    }
+
+    return valid0 ? &slots[0] : (valid1 ? &slots[1] : nullptr);
+}
+
+void LadderFile::store(int index, Record &r)
+{
+    Entry *e = entry(index);
+    Record *cur = current(index);
+    Record *target = cur == &e->slots[0] ? &e->slots[1] : &e->slots[0];
+
+    r.sequence = cur ? cur->sequence + 1 : 0;
+    r.checksum = checksum(r);
+    memcpy(target, &r, sizeof(Record));
+
+    /* Starts writing the page back without waiting, the other slot is there if it doesn't make it */
+#ifdef Q_OS_WIN
+    FlushViewOfFile(target, sizeof(Record));
+#else
+    uchar *begin = data + ((reinterpret_cast<uchar*>(target) - data) & ~quintptr(getpagesize() - 1));
+    msync(begin, reinterpret_cast<uchar*>(target + 1) - begin, MS_ASYNC);
+#endif
+}
+
+/* On failure (a full disk for example) the file is left as it was and stays usable. Windows
+   can't resize a file while a view of it is mapped, so there the old mapping goes first and is
+   mapped again if anything fails. Elsewhere the new size is mapped before the old mapping goes */
+bool LadderFile::map(int capacity)
+{
+    qint64 size = sizeof(Header) + qint64(capacity) * sizeof(Entry);
+    qint64 oldSize = file.size();
+    bool remap = false;
+
+#ifdef Q_OS_WIN
+    if (data) {
+        file.unmap(data);
+        data = nullptr;
+        remap = true;
+    }
+#endif
+
+    uchar *mapped = nullptr;
+    if (oldSize == size || file.resize(size)) {
+        mapped = file.map(0, size);
+    }
+
+    if (!mapped) {
+        error = file.errorString();
+        if (file.size() != oldSize) {
+            file.resize(oldSize);
+        }
+        if (remap) {
+            data = file.map(0, oldSize);
+            /* If even that fails the file is closed, isOpen() then says so */
+            if (!data) {
+                close();
+            }
+        }
+        return false;
+    }
+
+    if (data) {
+        file.unmap(data);
+    }
+    data = mapped;
+
+    this->capacity = capacity;
+    return true;
+}
+
+int LadderFile::allocate()
+{
+    if (!freeRecords.empty()) {
+        return freeRecords.takeLast();
+    }
+
+    if (records() >= capacity && !map(qMax(capacity * 2, initialCapacity))) {
+        return -1;
+    }
+
+    return records();
+}
+
+bool LadderFile::valid(const Record &r)
+{
+    return r.nameLength <= MaxNameLength && r.checksum == checksum(r);
+}
+
+quint16 LadderFile::checksum(const Record &r)
+{
+    Record copy = r;
+    copy.checksum = 0;
+
+    return qChecksum(reinterpret_cast<const char*>(&copy), sizeof(Record));
+}
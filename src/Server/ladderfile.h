@@ -0,0 +1,83 @@
+#ifndef LADDERFILE_H
+#define LADDERFILE_H
+
+#include <QtCore>
+
+struct MemberRating;
+
+/*
+  Ladder of a tier when not using SQL: serverdb/tier_<name>.dat
+
+  The file is a header followed by fixed size records, one per member, and is memory mapped.
+  A member keeps the same record for its whole life (MemberRating::filePos is the index of
+  the record), so an update only touches its own record, whatever the values. Records
+  of removed members are reused.
+
+  A record has two slots, each with a sequence number and a checksum. An update (or a removal)
+  goes in the slot that isn't the current one, with the next sequence number, so a slot half
+  written when the server went down fails its checksum and the previous values are used on the
+  next load. The record count in the header is only increased once the new record is written.
+  The written pages are handed to the system right away, the file is synced at the daily run
+  and when closing.
+
+  Values are stored in the native byte order, the file isn't meant to be moved between machines.
+*/
+class LadderFile
+{
+public:
+    enum {
+        Version = 2,
+        /* Members' names are at most 20 characters, some room left */
+        MaxNameLength = 32
+    };
+
+    LadderFile();
+    ~LadderFile();
+
+    /* Opens the file, creating it if needed. Returns false if the file is unusable, errorString()
+       then tells why */
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    /* Number of records in the file, including the unused ones */
+    int records() const;
+
+    /* Fills m with the record at the index. Returns false if the record is unused or damaged,
+       in which case it's reused later on */
+    bool read(int index, MemberRating &m);
+    /* Writes the member in place, or in a new record if m.filePos is -1, in which case m.filePos
+       is updated. Returns false if the member can't be stored */
+    bool write(MemberRating &m);
+    void remove(int index);
+    /* Removes all the members */
+    void clear();
+    /* Pushes the changes to the disk */
+    void sync();
+private:
+    struct Header;
+    struct Record;
+    struct Entry;
+
+    Header *header() const;
+    Entry *entry(int index) const;
+    /* The slot with the latest values of the record, nullptr if both are damaged */
+    Record *current(int index) const;
+    /* Writes r in the other slot of the record, with the next sequence number */
+    void store(int index, Record &r);
+    bool map(int capacity);
+    int allocate();
+
+    static bool valid(const Record &r);
+    static quint16 checksum(const Record &r);
+
+    QFile file;
+    uchar *data;
+    int capacity;
+    /* Unused records below records() */
+    QVector<int> freeRecords;
+    QString error;
+};
+
+#endif // LADDERFILE_H
@@ -13,17 +13,41 @@ class AbstractLoadInsertThread : public QThread
 public:
     virtual void run() = 0;
 
+    /* Writes waiting in the queue, and how long it took to write the last batches */
+    QString writeStats() const {
+        return QString("%1 writes queued, %2 written in %3 batches (%4 coalesced), last batch took %5 ms, longest %6 ms")
+                .arg(queuedWrites.load()).arg(writtenWrites.load()).arg(batches.load()).arg(coalescedWrites.load())
+                .arg(lastBatchTime.load()).arg(maxBatchTime.load());
+    }
+
 signals:
     void processWrite (QSqlQuery* q, void * m, int type=1);
     void processLoad (QSqlQuery* q, const QVariant &data, int query_type, WaitingObject *w);
     void processDailyRun(QSqlQuery* q);
+
+protected:
+    QAtomicInt queuedWrites;
+    QAtomicInt writtenWrites;
+    QAtomicInt coalescedWrites;
+    QAtomicInt batches;
+    QAtomicInt lastBatchTime;
+    QAtomicInt maxBatchTime;
 };
 
+/* Writes are not done right away: they're queued and written in batches, each in a transaction,
+   when there are SQL/WriteBatchSize of them or when the oldest one has waited SQL/WriteMaxStaleness
+   milliseconds. A member written again while still in the queue is only written once, with the
+   latest data.
+
+   Load queries and the daily run see all the writes queued before them. */
 template <class T>
 class LoadInsertThread : public AbstractLoadInsertThread
 {
 public:
-    LoadInsertThread() : finished(false), dailyRunToProcess(false) { connect(this, SIGNAL(finished()), SLOT(deleteLater()));}
+    LoadInsertThread() : finished(false), dailyRunToProcess(false), batchSize(200), maxStaleness(2000) {
+        connect(this, SIGNAL(finished()), SLOT(deleteLater()));
+        clock.start();
+    }
     ~LoadInsertThread() { finish(); }
 
     void pushQuery(const QVariant &name, WaitingObject *w, int query_type);
@@ -40,21 +64,45 @@ private:
         WaitingObject *w;
         int query_type;
 
-        Query(const QVariant &m, WaitingObject *w, int query_type)
+        Query(const QVariant &m = QVariant(), WaitingObject *w = nullptr, int query_type = 0)
             : data(m), w(w), query_type(query_type)
         {
 
         }
     };
 
+    struct Write {
+        T member;
+        int desc;
+        /* When the write was first queued */
+        qint64 time;
+    };
+
+    typedef QPair<QString, int> WriteKey;
+
+    /* Writes the queued members if there are enough of them or if they waited long enough,
+       or in any case if forced */
+    void writeMembers(QSqlDatabase &db, bool force);
+    /* Milliseconds before the oldest write has to be done, -1 if there's none */
+    int timeBeforeWrite();
+    /* One prepared statement per kind of write, so they're not prepared again each time */
+    QSqlQuery *statement(QSqlDatabase &db, int desc);
+    void clearStatements();
+
     QLinkedList<Query> queries;
     QMutex queryMutex;
     QSemaphore sem;
     bool finished;
 
-    QLinkedList<QPair<T, int> > members;
+    QLinkedList<Write> members;
+    QHash<WriteKey, typename QLinkedList<Write>::iterator> queuedMembers;
     QMutex memberMutex;
     bool dailyRunToProcess;
+
+    QHash<int, QSqlQuery*> statements;
+    QElapsedTimer clock;
+    int batchSize;
+    int maxStaleness;
 };
 
 template <class T>
@@ -67,61 +115,169 @@ void LoadInsertThread<T>::run()
     QSqlQuery sql(db);
     sql.setForwardOnly(true);
 
+    {
+        QSettings s("config", QSettings::IniFormat);
+        batchSize = std::max(s.value("SQL/WriteBatchSize", 200).toInt(), 1);
+        maxStaleness = std::max(s.value("SQL/WriteMaxStaleness", 2000).toInt(), 0);
+    }
+
     sem.acquire(1);
 
     forever {
         if (finished) {
+            writeMembers(db, true);
+            clearStatements();
             db.close();
             return;
         }
 
         bool loadQuery;
+        Query q;
 
         {
             QMutexLocker l1(&queryMutex);
-            QMutexLocker l2(&memberMutex);
 
             /* Maybe later a system to at least place a write now and then if overloaded with load queries */
             loadQuery = queries.size() > 0;
+            if (loadQuery) {
+                q = queries.takeFirst();
+            }
         }
 
         if (loadQuery) {
-            queryMutex.lock();
-            Query q = queries.takeFirst();
-            queryMutex.unlock();
+            writeMembers(db, true);
 
             emit processLoad(isSql() ? &sql : 0, q.data, q.query_type, q.w);
             q.w->emitSignal();
+        } else if (dailyRunToProcess) {
+            writeMembers(db, true);
+
+            dailyRunToProcess = false;
+            emit processDailyRun(isSql() ? &sql : 0);
         } else {
-            if (dailyRunToProcess) {
-                dailyRunToProcess = false;
-                emit processDailyRun(isSql() ? &sql : 0);
-            } else {
-                memberMutex.lock();
-                QPair<T , int> p = members.takeFirst();
-                memberMutex.unlock();
-
-                emit processWrite(isSql() ? &sql : 0, &p.first, p.second);
-            }
+            writeMembers(db, false);
         }
 
-        sem.acquire(1);
+        int wait = timeBeforeWrite();
+        if (wait == -1) {
+            sem.acquire(1);
+        } else {
+            sem.tryAcquire(1, wait);
+        }
     }
 }
 
+template <class T>
+void LoadInsertThread<T>::writeMembers(QSqlDatabase &db, bool force)
+{
+    QLinkedList<Write> batch;
+
+    {
+        QMutexLocker l(&memberMutex);
+
+        if (members.empty()) {
+            return;
+        }
+        if (!force && members.size() < batchSize && clock.elapsed() - members.first().time < maxStaleness) {
+            return;
+        }
+
+        batch.swap(members);
+        queuedMembers.clear();
+        queuedWrites.store(0);
+    }
+
+    /* A kind of write per tier and per version of the tiers, no need to keep the old ones around */
+    if (statements.size() > 64) {
+        clearStatements();
+    }
+
+    while (!batch.empty()) {
+        QElapsedTimer t;
+        t.start();
+
+        int count = std::min(batch.size(), batchSize);
+
+        if (isSql()) {
+            db.transaction();
+        }
+        for (int i = 0; i < count; i++) {
+            Write w = batch.takeFirst();
+            emit processWrite(isSql() ? statement(db, w.desc) : 0, &w.member, w.desc);
+        }
+        if (isSql()) {
+            db.commit();
+        }
+
+        int elapsed = t.elapsed();
+
+        writtenWrites.fetchAndAddRelaxed(count);
+        batches.fetchAndAddRelaxed(1);
+        lastBatchTime.store(elapsed);
+        if (elapsed > maxBatchTime.load()) {
+            maxBatchTime.store(elapsed);
+        }
+    }
+}
+
+template <class T>
+int LoadInsertThread<T>::timeBeforeWrite()
+{
+    QMutexLocker l(&memberMutex);
+
+    if (members.empty()) {
+        return -1;
+    }
+
+    return std::max(int(maxStaleness - (clock.elapsed() - members.first().time)), 0);
+}
+
+template <class T>
+QSqlQuery *LoadInsertThread<T>::statement(QSqlDatabase &db, int desc)
+{
+    QSqlQuery *&q = statements[desc];
+
+    if (!q) {
+        q = new QSqlQuery(db);
+        q->setForwardOnly(true);
+    }
+
+    return q;
+}
+
+template <class T>
+void LoadInsertThread<T>::clearStatements()
+{
+    qDeleteAll(statements);
+    statements.clear();
+}
+
 template <class T>
 void LoadInsertThread<T>::pushMember(const T &member, int desc)
 {
     memberMutex.lock();
 
-    members.push_back(QPair<T, int> (member, desc) );
+    WriteKey key(member.name.toLower(), desc);
+    typename QHash<WriteKey, typename QLinkedList<Write>::iterator>::iterator it = queuedMembers.find(key);
+
+    if (it != queuedMembers.end()) {
+        /* Still waiting, only the latest data matters */
+        it.value()->member = member;
+        coalescedWrites.fetchAndAddRelaxed(1);
+        memberMutex.unlock();
+        return;
+    }
+
+    Write w = {member, desc, clock.elapsed()};
+    members.push_back(w);
+    queuedMembers.insert(key, --members.end());
+    queuedWrites.fetchAndAddRelaxed(1);
 
     memberMutex.unlock();
 
     sem.release(1);
 }
 
-
 template <class T>
 void LoadInsertThread<T>::addDailyRun()
 {
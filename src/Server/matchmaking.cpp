@@ -0,0 +1,73 @@
+#include "matchmaking.h"
+
+MatchmakingQueue::MatchmakingQueue() : counter(0)
+{
+}
+
+void MatchmakingQueue::insert(int player, const FindBattleDataAdv &data, const QVector<Entry> &entries)
+{
+    remove(player);
+
+    Search &s = searches[player];
+    s.data = data;
+    s.entries = entries;
+    s.order = counter++;
+
+    for (int i = 0; i < entries.size(); i++) {
+        const Entry &e = entries[i];
+        buckets[groupKey(e.gen, e.allowIllegal)][e.tier].insert(e.rating, QPair<int,int>(player, i));
+    }
+
+    waiting.insert(s.order, player);
+}
+
+void MatchmakingQueue::remove(int player)
+{
+    QHash<int, Search>::iterator it = searches.find(player);
+
+    if (it == searches.end()) {
+        return;
+    }
+
+    const QVector<Entry> &entries = it->entries;
+
+    for (int i = 0; i < entries.size(); i++) {
+        const Entry &e = entries[i];
+        quint32 key = groupKey(e.gen, e.allowIllegal);
+
+        TierBuckets &group = buckets[key];
+        Bucket &bucket = group[e.tier];
+
+        bucket.remove(e.rating, QPair<int,int>(player, i));
+
+        if (bucket.isEmpty()) {
+            group.remove(e.tier);
+            if (group.isEmpty()) {
+                buckets.remove(key);
+            }
+        }
+    }
+
+    waiting.remove(it->order);
+    searches.erase(it);
+}
+
+bool MatchmakingQueue::contains(int player) const
+{
+    return searches.contains(player);
+}
+
+const MatchmakingQueue::Search &MatchmakingQueue::search(int player) const
+{
+    return *searches.constFind(player);
+}
+
+int MatchmakingQueue::count() const
+{
+    return searches.count();
+}
+
+QList<int> MatchmakingQueue::players() const
+{
+    return waiting.values();
+}
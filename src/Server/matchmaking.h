@@ -0,0 +1,155 @@
+#ifndef MATCHMAKING_H
+#define MATCHMAKING_H
+
+#include <QtCore>
+#include <PokemonInfo/battlestructs.h>
+#include <PokemonInfo/geninfo.h>
+
+/*
+  The players looking for a battle through "Find Battle".
+
+  Every team a searcher is willing to use is indexed in the bucket of its
+  generation and tier, and whether that tier allows illegal pokemon. Inside
+  a bucket, teams are ordered by rating, so that ranged searches only look
+  at the ratings in range, and the closest ratings are tried first.
+
+  The queue only knows about the search parameters, all the checks involving the
+  players themselves (ips, rated battles, team validity, scripts) are for the server
+  to do when it's given a candidate.
+*/
+class MatchmakingQueue
+{
+public:
+    struct Entry {
+        Entry() : player(0), team(0), rating(0), allowIllegal(false) {}
+
+        int player;
+        /* Slot of the team among the player's teams */
+        int team;
+        /* Rating in the tier, when the search started */
+        int rating;
+        QString tier;
+        Pokemon::gen gen;
+        bool allowIllegal;
+    };
+
+    struct Search {
+        FindBattleDataAdv data;
+        /* In the order the player's teams are to be tried */
+        QVector<Entry> entries;
+        quint32 order;
+    };
+
+    MatchmakingQueue();
+
+    void insert(int player, const FindBattleDataAdv &data, const QVector<Entry> &entries);
+    void remove(int player);
+    bool contains(int player) const;
+    const Search &search(int player) const;
+    int count() const;
+
+    /* The searchers, the ones who've been waiting the longest first */
+    QList<int> players() const;
+
+    /* Goes through the teams of the other searchers that can be paired with the entry,
+       closest rating first, until accept(entry, data) returns true. Returns whether one was accepted.
+
+       The tier restriction and rating range of the searcher are applied here, the ones of the
+       candidates are left to the caller. accept must not modify the queue. */
+    template <class Accept>
+    bool findOpponent(const Entry &e, const FindBattleData &f, Accept accept) const;
+private:
+    /* rating -> (player, index of the entry in the player's search) */
+    typedef QMultiMap<int, QPair<int, int> > Bucket;
+    typedef QHash<QString, Bucket> TierBuckets;
+
+    static quint32 groupKey(const Pokemon::gen &gen, bool allowIllegal) {
+        return (quint32(gen.num) << 16) | (quint32(gen.subnum) << 1) | quint32(allowIllegal);
+    }
+
+    template <class Accept>
+    bool findInBucket(const Bucket &bucket, const Entry &e, const FindBattleData &f, Accept &accept) const;
+
+    QHash<quint32, TierBuckets> buckets;
+    QHash<int, Search> searches;
+    QMap<quint32, int> waiting;
+    quint32 counter;
+};
+
+template <class Accept>
+bool MatchmakingQueue::findOpponent(const Entry &e, const FindBattleData &f, Accept accept) const
+{
+    QHash<quint32, TierBuckets>::const_iterator group = buckets.constFind(groupKey(e.gen, e.allowIllegal));
+
+    if (group == buckets.constEnd()) {
+        return false;
+    }
+
+    if (f.sameTier) {
+        TierBuckets::const_iterator it = group->constFind(e.tier);
+        return it != group->constEnd() && findInBucket(*it, e, f, accept);
+    }
+
+    /* Own tier first, then the other ones */
+    TierBuckets::const_iterator own = group->constFind(e.tier);
+    if (own != group->constEnd() && findInBucket(*own, e, f, accept)) {
+        return true;
+    }
+
+    for (TierBuckets::const_iterator it = group->constBegin(); it != group->constEnd(); ++it) {
+        if (it != own && findInBucket(*it, e, f, accept)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <class Accept>
+bool MatchmakingQueue::findInBucket(const Bucket &bucket, const Entry &e, const FindBattleData &f, Accept &accept) const
+{
+    Bucket::const_iterator begin = f.ranged ? bucket.lowerBound(e.rating - f.range) : bucket.constBegin();
+    Bucket::const_iterator end = f.ranged ? bucket.upperBound(e.rating + f.range) : bucket.constEnd();
+
+    /* Walks away from the searcher's rating in both directions */
+    Bucket::const_iterator up = bucket.lowerBound(e.rating);
+    Bucket::const_iterator down = up;
+
+    while (up != end || down != begin) {
+        bool goUp;
+
+        if (up == end) {
+            goUp = false;
+        } else if (down == begin) {
+            goUp = true;
+        } else {
+            Bucket::const_iterator prev = down - 1;
+            goUp = up.key() - e.rating <= e.rating - prev.key();
+        }
+
+        Bucket::const_iterator candidate;
+        if (goUp) {
+            candidate = up++;
+        } else {
+            candidate = --down;
+        }
+
+        const QPair<int, int> &who = candidate.value();
+        if (who.first == e.player) {
+            continue;
+        }
+
+        const Search &s = *searches.constFind(who.first);
+        if (s.data.sameTier && s.entries[who.second].tier != e.tier) {
+            continue;
+        }
+
+        if (accept(s.entries[who.second], s.data)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // MATCHMAKING_H
@@ -0,0 +1,740 @@
+#include "memberfile.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+struct MemberFile::Header
+{
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+    /* Records written so far, used or not */
+    quint32 records;
+    /* Records in use */
+    quint32 used;
+    qint32 freeHead;
+    qint32 flaggedHead;
+    /* Set while the file is open, so still being set when opening means the server went down */
+    quint32 dirty;
+    quint32 reserved[7];
+};
+
+struct MemberFile::IndexHeader
+{
+    char magic[8];
+    quint32 version;
+    /* Size of each of the two tables that follow, by name then by ip */
+    quint32 buckets;
+    quint32 reserved[12];
+};
+
+struct MemberFile::Record
+{
+    enum {
+        Used = 1,
+        /* In the list of the members with an auth or a ban */
+        Flagged = 2
+    };
+
+    quint32 flags;
+    /* Next record in the same name bucket, or next free record if unused */
+    qint32 nextName;
+    qint32 nextIp;
+    qint32 nextFlagged;
+    quint32 nameHash;
+    quint32 ipHash;
+    quint32 banExpireTime;
+    qint8 auth;
+    quint8 banned;
+    quint16 nameLength;
+    quint16 checksum;
+    quint16 reserved;
+    /* Not null terminated when full */
+    char date[20];
+    char salt[8];
+    char hash[32];
+    char ip[40];
+    quint16 name[MaxNameLength];
+};
+
+static const char memberMagic[8] = {'P', 'O', 'M', 'E', 'M', 'B', 'E', 'R'};
+static const char indexMagic[8] = {'P', 'O', 'M', 'E', 'M', 'I', 'D', 'X'};
+/* Records to start with, the file then doubles in size each time it's full */
+static const int initialCapacity = 1024;
+/* Buckets to start with, there are four times more each time the members are twice as many */
+static const int initialBuckets = 1024;
+
+static int bucketsFor(int members)
+{
+    int buckets = initialBuckets;
+    while (buckets * 2 < members) {
+        buckets *= 4;
+    }
+    return buckets;
+}
+
+static QByteArray fromFixed(const char *src, int size)
+{
+    return QByteArray(src, qstrnlen(src, size));
+}
+
+static void toFixed(char *dest, int size, const QByteArray &value)
+{
+    memset(dest, 0, size);
+    memcpy(dest, value.constData(), std::min(size, value.length()));
+}
+
+MemberFile::MemberFile() : data(nullptr), indexData(nullptr), capacity(0)
+{
+}
+
+MemberFile::~MemberFile()
+{
+    close();
+}
+
+bool MemberFile::open(const QString &path)
+{
+    close();
+
+    file.setFileName(path + ".dat");
+    indexFile.setFileName(path + ".idx");
+
+    if (!file.open(QIODevice::ReadWrite)) {
+        error = file.errorString();
+        close();
+        return false;
+    }
+    if (!indexFile.open(QIODevice::ReadWrite)) {
+        error = indexFile.errorString();
+        close();
+        return false;
+    }
+
+    if (file.size() == 0) {
+        if (!map(initialCapacity)) {
+            close();
+            return false;
+        }
+
+        Header *h = header();
+        memset(h, 0, sizeof(Header));
+        memcpy(h->magic, memberMagic, sizeof(memberMagic));
+        h->version = Version;
+        h->recordSize = sizeof(Record);
+        h->records = 0;
+        h->used = 0;
+        h->freeHead = -1;
+        h->flaggedHead = -1;
+    } else {
+        if (file.size() < qint64(sizeof(Header)) || !map((file.size() - sizeof(Header)) / sizeof(Record))) {
+            if (error.isEmpty()) {
+                error = "File too small";
+            }
+            close();
+            return false;
+        }
+
+        const Header *h = header();
+        if (memcmp(h->magic, memberMagic, sizeof(memberMagic)) != 0 || h->version != Version || h->recordSize != sizeof(Record)) {
+            error = "Not a member file, or a member file from an incompatible version";
+            close();
+            return false;
+        }
+
+        /* The file is grown before the count is updated, so more records than the
+           file can hold means the header is damaged */
+        if (h->records > quint32(capacity)) {
+            error = "Damaged header";
+            close();
+            return false;
+        }
+    }
+
+    /* The index is derived from the records, so if it's missing or doesn't look right it's
+       just made again */
+    int buckets = 0;
+    if (indexFile.size() >= qint64(sizeof(IndexHeader))) {
+        IndexHeader ih;
+        if (indexFile.read(reinterpret_cast<char*>(&ih), sizeof(IndexHeader)) == sizeof(IndexHeader)
+                && memcmp(ih.magic, indexMagic, sizeof(indexMagic)) == 0 && ih.version == Version
+                && ih.buckets >= quint32(initialBuckets) && (ih.buckets & (ih.buckets - 1)) == 0
+                && indexFile.size() == qint64(sizeof(IndexHeader)) + 2 * qint64(ih.buckets) * qint64(sizeof(qint32))) {
+            buckets = ih.buckets;
+        }
+    }
+
+    bool crashed = header()->dirty != 0;
+    bool rebuildNeeded = crashed || buckets == 0;
+
+    if (buckets == 0) {
+        buckets = bucketsFor(count());
+    }
+    if (!mapIndex(buckets)) {
+        close();
+        return false;
+    }
+    if (rebuildNeeded) {
+        if (crashed) {
+            qDebug() << "Member file " << file.fileName() << " wasn't closed properly, checking it";
+        }
+        rebuild(crashed);
+    }
+
+    header()->dirty = 1;
+    sync();
+
+    return true;
+}
+
+void MemberFile::close()
+{
+    if (data && indexData) {
+        sync();
+        header()->dirty = 0;
+    }
+    if (data) {
+        sync();
+        file.unmap(data);
+        data = nullptr;
+    }
+    if (indexData) {
+        indexFile.unmap(indexData);
+        indexData = nullptr;
+    }
+    file.close();
+    indexFile.close();
+    capacity = 0;
+}
+
+bool MemberFile::isOpen() const
+{
+    return data != nullptr && indexData != nullptr;
+}
+
+QString MemberFile::errorString() const
+{
+    return error;
+}
+
+int MemberFile::records() const
+{
+    return data ? int(header()->records) : 0;
+}
+
+int MemberFile::count() const
+{
+    return data ? int(header()->used) : 0;
+}
+
+int MemberFile::find(const QString &name) const
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    quint32 hash = hashName(name);
+    QString lower = name.toLower();
+
+    for (int i = nameBuckets()[hash & (buckets() - 1)]; i != -1; i = record(i)->nextName) {
+        const Record *r = record(i);
+        if (r->nameHash == hash && QString::fromUtf16(r->name, r->nameLength).toLower() == lower) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+QList<int> MemberFile::findByIp(const QString &ip) const
+{
+    QList<int> ret;
+
+    if (!isOpen()) {
+        return ret;
+    }
+
+    QByteArray bytes = ip.toUtf8().left(sizeof(Record::ip) - 1);
+    quint32 hash = hashIp(bytes);
+
+    for (int i = ipBuckets()[hash & (buckets() - 1)]; i != -1; i = record(i)->nextIp) {
+        const Record *r = record(i);
+        if (r->ipHash == hash && fromFixed(r->ip, sizeof(r->ip)) == bytes) {
+            ret.push_back(i);
+        }
+    }
+
+    return ret;
+}
+
+QList<int> MemberFile::flagged() const
+{
+    QList<int> ret;
+
+    if (!isOpen()) {
+        return ret;
+    }
+
+    for (int i = header()->flaggedHead; i != -1; i = record(i)->nextFlagged) {
+        ret.push_back(i);
+    }
+
+    return ret;
+}
+
+bool MemberFile::read(int index, SecurityManager::Member &m) const
+{
+    if (index < 0 || index >= records()) {
+        return false;
+    }
+
+    const Record *r = record(index);
+    if (!(r->flags & Record::Used)) {
+        return false;
+    }
+
+    m.name = QString::fromUtf16(r->name, r->nameLength);
+    m.date = QString::fromLatin1(fromFixed(r->date, sizeof(r->date)));
+    m.auth = r->auth;
+    m.banned = r->banned != 0;
+    m.salt = fromFixed(r->salt, sizeof(r->salt));
+    m.hash = fromFixed(r->hash, sizeof(r->hash));
+    m.ip = QString::fromUtf8(fromFixed(r->ip, sizeof(r->ip)));
+    m.ban_expire_time = r->banExpireTime;
+    m.filepos = index;
+
+    return true;
+}
+
+bool MemberFile::write(SecurityManager::Member &m)
+{
+    if (!isOpen()) {
+        return false;
+    }
+    if (m.name.length() > MaxNameLength) {
+        error = QString("Name too long: %1").arg(m.name);
+        return false;
+    }
+
+    int index = m.filepos;
+    bool added = index < 0 || index >= records() || !(record(index)->flags & Record::Used);
+
+    if (added) {
+        index = allocate();
+        if (index == -1) {
+            return false;
+        }
+    }
+
+    Record *r = record(index);
+
+    QByteArray ip = m.ip.toUtf8().left(sizeof(r->ip) - 1);
+    quint32 ipHash = hashIp(ip);
+    bool ipChanged = added || r->ipHash != ipHash || fromFixed(r->ip, sizeof(r->ip)) != ip;
+
+    if (added) {
+        memset(r, 0, sizeof(Record));
+        r->flags = Record::Used;
+        r->nameHash = hashName(m.name);
+        r->nameLength = m.name.length();
+        memcpy(r->name, m.name.utf16(), m.name.length() * sizeof(quint16));
+    } else if (ipChanged) {
+        unlinkIp(index);
+    }
+
+    toFixed(r->date, sizeof(r->date), m.date.toLatin1());
+    toFixed(r->salt, sizeof(r->salt), m.salt);
+    toFixed(r->hash, sizeof(r->hash), m.hash);
+    toFixed(r->ip, sizeof(r->ip), ip);
+    r->ipHash = ipHash;
+    r->auth = m.auth;
+    r->banned = m.banned;
+    r->banExpireTime = m.ban_expire_time;
+    seal(r);
+
+    if (added) {
+        linkName(index);
+    }
+    if (ipChanged) {
+        linkIp(index);
+    }
+
+    bool flag = m.auth > 0 || m.banned;
+    if (flag && !(r->flags & Record::Flagged)) {
+        linkFlagged(index);
+    } else if (!flag && (r->flags & Record::Flagged)) {
+        unlinkFlagged(index);
+    }
+
+    m.filepos = index;
+
+    if (added) {
+        /* Only counted once complete */
+        if (index == records()) {
+            header()->records += 1;
+        }
+        header()->used += 1;
+
+        if (count() > 2 * buckets() && mapIndex(buckets() * 4)) {
+            rebuild(false);
+        }
+    }
+
+    return true;
+}
+
+void MemberFile::remove(int index)
+{
+    if (index < 0 || index >= records()) {
+        return;
+    }
+
+    Record *r = record(index);
+    if (!(r->flags & Record::Used)) {
+        return;
+    }
+
+    unlinkName(index);
+    unlinkIp(index);
+    if (r->flags & Record::Flagged) {
+        unlinkFlagged(index);
+    }
+
+    r->flags = 0;
+    r->nextName = header()->freeHead;
+    header()->freeHead = index;
+    header()->used -= 1;
+    seal(r);
+}
+
+void MemberFile::sync()
+{
+#ifdef Q_OS_WIN
+    if (data) {
+        FlushViewOfFile(data, sizeof(Header) + size_t(capacity) * sizeof(Record));
+    }
+    if (indexData) {
+        FlushViewOfFile(indexData, sizeof(IndexHeader) + 2 * size_t(buckets()) * sizeof(qint32));
+    }
+#else
+    if (data) {
+        msync(data, sizeof(Header) + size_t(capacity) * sizeof(Record), MS_SYNC);
+    }
+    if (indexData) {
+        msync(indexData, sizeof(IndexHeader) + 2 * size_t(buckets()) * sizeof(qint32), MS_SYNC);
+    }
+#endif
+}
+
+MemberFile::Header *MemberFile::header() const
+{
+    return reinterpret_cast<Header*>(data);
+}
+
+MemberFile::Record *MemberFile::record(int index) const
+{
+    return reinterpret_cast<Record*>(data + sizeof(Header)) + index;
+}
+
+qint32 *MemberFile::nameBuckets() const
+{
+    return reinterpret_cast<qint32*>(indexData + sizeof(IndexHeader));
+}
+
+qint32 *MemberFile::ipBuckets() const
+{
+    return nameBuckets() + buckets();
+}
+
+int MemberFile::buckets() const
+{
+    return reinterpret_cast<const IndexHeader*>(indexData)->buckets;
+}
+
+/* On failure (a full disk for example) the file is left as it was and stays usable. Windows
+   can't resize a file while a view of it is mapped, so there the old mapping goes first and is
+   mapped again if anything fails. Elsewhere the new size is mapped before the old mapping goes */
+bool MemberFile::map(int capacity)
+{
+    qint64 size = sizeof(Header) + qint64(capacity) * sizeof(Record);
+    qint64 oldSize = file.size();
+    bool remap = false;
+
+#ifdef Q_OS_WIN
+    if (data) {
+        file.unmap(data);
+        data = nullptr;
+        remap = true;
+    }
+#endif
+
+    uchar *mapped = nullptr;
+    if (oldSize == size || file.resize(size)) {
+        mapped = file.map(0, size);
+    }
+
+    if (!mapped) {
+        error = file.errorString();
+        if (file.size() != oldSize) {
+            file.resize(oldSize);
+        }
+        if (remap) {
+            data = file.map(0, oldSize);
+            /* If even that fails the files are closed, isOpen() then says so */
+            if (!data) {
+                close();
+            }
+        }
+        return false;
+    }
+
+    if (data) {
+        file.unmap(data);
+    }
+    data = mapped;
+
+    this->capacity = capacity;
+    return true;
+}
+
+/* Same as map(), the old buckets are kept if the index can't grow */
+bool MemberFile::mapIndex(int buckets)
+{
+    qint64 size = sizeof(IndexHeader) + 2 * qint64(buckets) * sizeof(qint32);
+    qint64 oldSize = indexFile.size();
+    bool remap = false;
+
+#ifdef Q_OS_WIN
+    if (indexData) {
+        indexFile.unmap(indexData);
+        indexData = nullptr;
+        remap = true;
+    }
+#endif
+
+    uchar *mapped = nullptr;
+    if (oldSize == size || indexFile.resize(size)) {
+        mapped = indexFile.map(0, size);
+    }
+
+    if (!mapped) {
+        error = indexFile.errorString();
+        if (indexFile.size() != oldSize) {
+            indexFile.resize(oldSize);
+        }
+        if (remap) {
+            indexData = indexFile.map(0, oldSize);
+            if (!indexData) {
+                close();
+            }
+        }
+        return false;
+    }
+
+    if (indexData) {
+        indexFile.unmap(indexData);
+    }
+    indexData = mapped;
+
+    IndexHeader *ih = reinterpret_cast<IndexHeader*>(indexData);
+    memset(ih, 0, sizeof(IndexHeader));
+    memcpy(ih->magic, indexMagic, sizeof(indexMagic));
+    ih->version = Version;
+    ih->buckets = buckets;
+
+    return true;
+}
+
+int MemberFile::allocate()
+{
+    Header *h = header();
+
+    if (h->freeHead != -1) {
+        int index = h->freeHead;
+        h->freeHead = record(index)->nextName;
+        return index;
+    }
+
+    if (records() >= capacity && !map(qMax(capacity * 2, initialCapacity))) {
+        return -1;
+    }
+
+    return records();
+}
+
+void MemberFile::rebuild(bool checkRecords)
+{
+    Header *h = header();
+
+    h->used = 0;
+    h->freeHead = -1;
+    h->flaggedHead = -1;
+
+    qint32 *tables = nameBuckets();
+    for (int i = 0; i < 2 * buckets(); i++) {
+        tables[i] = -1;
+    }
+
+    int damaged = 0;
+
+    /* Backwards, so that the chains and the free list come out in increasing order */
+    for (int i = records() - 1; i >= 0; i--) {
+        Record *r = record(i);
+
+        if (checkRecords && (r->flags & Record::Used) && (r->checksum != checksum(*r) || r->nameLength > MaxNameLength)) {
+            damaged += 1;
+            r->flags = 0;
+        }
+
+        if (!(r->flags & Record::Used)) {
+            r->flags = 0;
+            r->nextName = h->freeHead;
+            h->freeHead = i;
+            seal(r);
+            continue;
+        }
+
+        r->flags &= ~Record::Flagged;
+        linkName(i);
+        linkIp(i);
+        if (r->auth > 0 || r->banned) {
+            linkFlagged(i);
+        }
+        h->used += 1;
+    }
+
+    if (damaged > 0) {
+        qDebug() << "Skipped " << damaged << " damaged records in " << file.fileName();
+    }
+}
+
+void MemberFile::linkName(int index)
+{
+    Record *r = record(index);
+    qint32 &head = nameBuckets()[r->nameHash & (buckets() - 1)];
+
+    r->nextName = head;
+    seal(r);
+    head = index;
+}
+
+void MemberFile::linkIp(int index)
+{
+    Record *r = record(index);
+    qint32 &head = ipBuckets()[r->ipHash & (buckets() - 1)];
+
+    r->nextIp = head;
+    seal(r);
+    head = index;
+}
+
+void MemberFile::linkFlagged(int index)
+{
+    Record *r = record(index);
+
+    r->nextFlagged = header()->flaggedHead;
+    r->flags |= Record::Flagged;
+    seal(r);
+    header()->flaggedHead = index;
+}
+
+void MemberFile::unlinkName(int index)
+{
+    Record *r = record(index);
+    qint32 &head = nameBuckets()[r->nameHash & (buckets() - 1)];
+
+    if (head == index) {
+        head = r->nextName;
+        return;
+    }
+
+    for (int i = head; i != -1; i = record(i)->nextName) {
+        Record *prev = record(i);
+        if (prev->nextName == index) {
+            prev->nextName = r->nextName;
+            seal(prev);
+            return;
+        }
+    }
+}
+
+void MemberFile::unlinkIp(int index)
+{
+    Record *r = record(index);
+    qint32 &head = ipBuckets()[r->ipHash & (buckets() - 1)];
+
+    if (head == index) {
+        head = r->nextIp;
+        return;
+    }
+
+    for (int i = head; i != -1; i = record(i)->nextIp) {
+        Record *prev = record(i);
+        if (prev->nextIp == index) {
+            prev->nextIp = r->nextIp;
+            seal(prev);
+            return;
+        }
+    }
+}
+
+void MemberFile::unlinkFlagged(int index)
+{
+    Record *r = record(index);
+    r->flags &= ~Record::Flagged;
+    seal(r);
+
+    if (header()->flaggedHead == index) {
+        header()->flaggedHead = r->nextFlagged;
+        return;
+    }
+
+    for (int i = header()->flaggedHead; i != -1; i = record(i)->nextFlagged) {
+        Record *prev = record(i);
+        if (prev->nextFlagged == index) {
+            prev->nextFlagged = r->nextFlagged;
+            seal(prev);
+            return;
+        }
+    }
+}
+
+void MemberFile::seal(Record *r)
+{
+    r->checksum = checksum(*r);
+}
+
+quint16 MemberFile::checksum(const Record &r)
+{
+    Record copy = r;
+    copy.checksum = 0;
+
+    return qChecksum(reinterpret_cast<const char*>(&copy), sizeof(Record));
+}
+
+/* FNV-1a, rather than qHash which is seeded differently on each run */
+quint32 MemberFile::hashName(const QString &name)
+{
+    QString lower = name.toLower();
+    quint32 hash = 2166136261u;
+
+    for (int i = 0; i < lower.length(); i++) {
+        hash = (hash ^ lower[i].unicode()) * 16777619u;
+    }
+
+    return hash;
+}
+
+quint32 MemberFile::hashIp(const QByteArray &ip)
+{
+    quint32 hash = 2166136261u;
+
+    for (int i = 0; i < ip.length(); i++) {
+        hash = (hash ^ quint8(ip[i])) * 16777619u;
+    }
+
+    return hash;
+}
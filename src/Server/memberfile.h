@@ -0,0 +1,97 @@
+#ifndef MEMBERFILE_H
+#define MEMBERFILE_H
+
+#include <QtCore>
+
+#include "security.h"
+
+/*
+  Members when not using SQL: serverdb/members.dat and serverdb/members.idx
+
+  members.dat is a header followed by fixed size records, one per member, and is memory mapped.
+  A member keeps the same record for its whole life (Member::filepos is the index of the record),
+  so an update overwrites its record in place. Records of deleted members are reused.
+
+  members.idx holds the buckets of two hash indexes, on the lowercased name and on the ip. The
+  chains go through the records themselves. Members with an auth or a ban are chained together as
+  well, so that they can be listed at startup without reading the whole file.
+
+  The indexes are only trusted if the file was closed properly. Otherwise, they are rebuilt from
+  the records on the next open, skipping the records with a bad checksum.
+
+  Values are stored in the native byte order, the files aren't meant to be moved between machines.
+*/
+class MemberFile
+{
+public:
+    enum {
+        Version = 1,
+        /* Names are at most 20 characters, some room left */
+        MaxNameLength = 32
+    };
+
+    MemberFile();
+    ~MemberFile();
+
+    /* Opens path.dat and path.idx, creating them if needed. Returns false if the files are
+       unusable, errorString() then tells why */
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    /* Number of records in the file, including the unused ones */
+    int records() const;
+    /* Number of members */
+    int count() const;
+
+    /* Index of the record of the member, -1 if there's none */
+    int find(const QString &name) const;
+    QList<int> findByIp(const QString &ip) const;
+    /* Records of the members with an auth or a ban */
+    QList<int> flagged() const;
+
+    /* Fills m with the record at the index. Returns false if the record is unused */
+    bool read(int index, SecurityManager::Member &m) const;
+    /* Writes the member in place, or in a new record if m.filepos is -1, in which case m.filepos
+       is updated. Returns false if the member can't be stored */
+    bool write(SecurityManager::Member &m);
+    void remove(int index);
+    /* Pushes the changes to the disk */
+    void sync();
+private:
+    struct Header;
+    struct IndexHeader;
+    struct Record;
+
+    Header *header() const;
+    Record *record(int index) const;
+    qint32 *nameBuckets() const;
+    qint32 *ipBuckets() const;
+    int buckets() const;
+
+    bool map(int capacity);
+    bool mapIndex(int buckets);
+    int allocate();
+    /* Links back all the records, after a crash or when the buckets change */
+    void rebuild(bool checkRecords);
+
+    void linkName(int index);
+    void linkIp(int index);
+    void linkFlagged(int index);
+    void unlinkName(int index);
+    void unlinkIp(int index);
+    void unlinkFlagged(int index);
+
+    static void seal(Record *r);
+    static quint16 checksum(const Record &r);
+    static quint32 hashName(const QString &name);
+    static quint32 hashIp(const QByteArray &ip);
+
+    QFile file, indexFile;
+    uchar *data, *indexData;
+    int capacity;
+    QString error;
+};
+
+#endif // MEMBERFILE_H
@@ -8,7 +8,9 @@ template <class Member>
 class MemoryHolder
 {
 public:
-    MemoryHolder(int cacheSize=10000) : cacheSize(cacheSize) {
+    /* With fileBacked, members are cached the same way when not using SQL, instead of
+       being all in memory */
+    MemoryHolder(int cacheSize=10000, bool fileBacked=false) : cacheSize(cacheSize), fileBacked(fileBacked) {
 
     }
 
@@ -18,7 +20,7 @@ public:
 
     bool isInMemory(const QString &name) const
     {
-        if (isSql()) {
+        if (isCached()) {
             QString n2 = name.toLower();
 
             QMutexLocker lock(&memberMutex);
@@ -31,7 +33,7 @@ public:
 
     void addMemberInMemory(const Member &m)
     {
-        if (isSql()) {
+        if (isCached()) {
             memberMutex.lock();
 
             nonExistentMembers.remove(m.name);
@@ -66,6 +68,22 @@ public:
         cachedMembersMutex.unlock();
     }
 
+    /* Calls f on each member in memory, removing the ones for which it returns false */
+    template <class F>
+    void updateMembers(F f)
+    {
+        QMutexLocker m(&memberMutex);
+
+        typename QHash<QString, Member>::iterator it = members.begin();
+        while (it != members.end()) {
+            if (f(it.value())) {
+                ++it;
+            } else {
+                it = members.erase(it);
+            }
+        }
+    }
+
     /* Used for debugging purposes */
     int cachedMembersCount()
     {
@@ -132,12 +150,17 @@ public:
     }
 
 protected:
+    bool isCached() const {
+        return fileBacked || isSql();
+    }
+
     QHash<QString, Member> members;
     QSet<QString> nonExistentMembers;
     mutable QMutex memberMutex;
     QLinkedList<QString> cachedMembersOrder;
     mutable QMutex cachedMembersMutex;
     int cacheSize;
+    bool fileBacked;
 };
 
 #endif // MEMORYHOLDER_H
@@ -42,5 +42,36 @@ QByteArray makePacket(int command, Params&&... params) {
     return ret;
 }
 
+/* Frames a command that's already serialized, like makePacket */
+inline QByteArray framePacket(const QByteArray &command) {
+    QByteArray ret(4, Qt::Uninitialized);
+
+    const int l = command.length();
+    ret[0] = l >> (3*8);
+    ret[1] = l >> (2*8);
+    ret[2] = l >> 8;
+    ret[3] = l;
+
+    ret.append(command);
+    return ret;
+}
+
+/* Compresses and frames a command that's already serialized, like makeZipPacket */
+inline QByteArray frameZipPacket(const QByteArray &command) {
+    QByteArray cp = qCompress(command);
+
+    QByteArray ret(6, Qt::Uninitialized);
+
+    const int l = 2 + cp.length();
+    ret[0] = l >> (3*8);
+    ret[1] = l >> (2*8);
+    ret[2] = l >> 8;
+    ret[3] = l;
+    ret[4] = '\0'; /* ZipCommand == 0 */
+    ret[5] = '\0'; /* 0 = Single command, 1 would be multiple packets */
+
+    ret.append(cp);
+    return ret;
+}
 
 #endif // NETWORKUTILITIES_H
@@ -130,6 +130,8 @@ void Player::ladderChange(bool n)
     }
     state().setFlag(LadderEnabled, n);
     relay().notifyOptionsChange(id(), away(), n);
+
+    Server::serverIns->outdatePlayer(id());
 }
 
 void Player::cancelBattleSearch()
@@ -966,6 +968,11 @@ bool Player::supportsZip() const
     return spec()[SupportsZipCompression];
 }
 
+bool Player::supportsChannelDeltas() const
+{
+    return spec()[SupportsChannelDeltas] && Server::serverIns->channelDeltaWindow() > 0;
+}
+
 bool Player::hasTier(const QString &tier) const
 {
     return tiers.contains(tier);
@@ -1131,6 +1138,12 @@ void Player::loggedIn(LoginInfo *info)
     spec().setFlag(ReconnectEnabled, info->network[NetworkServ::LoginCommand::HasReconnect]);
     spec().setFlag(HasRegisterCheck, info->data[PlayerFlags::HasRegisterCheck]);
     spec().setFlag(WantsHTML, info->data[PlayerFlags::WantsHTML]);
+    spec().setFlag(SupportsZipStream, info->data[PlayerFlags::SupportsZipStream]);
+    spec().setFlag(SupportsChannelDeltas, info->data[PlayerFlags::SupportsChannelDeltas]);
+
+    if (spec()[SupportsZipStream] && Server::serverIns->useZipStream()) {
+        relay().enableZipStream(Server::serverIns->zipStreamDictionary());
+    }
     state().setFlag(LadderEnabled, info->data[PlayerFlags::LadderEnabled]);
     state().setFlag(Away, info->data[PlayerFlags::Idle]);
     reconnectBits() = info->reconnectBits;
@@ -1690,8 +1703,3 @@ void Player::sendMessage(const QString &mess, bool html)
 {
     relay().sendMessage(mess, html);
 }
-
-void Player::sendPlayers(const QVector<reference<PlayerInfo> > & bundles)
-{
-    relay().notify(NetworkServ::PlayersList, Expander<decltype(bundles)>(bundles));
-}
@@ -59,7 +59,9 @@ public:
         IdsWithMessage,
         ReconnectEnabled,
         HasRegisterCheck,
-        WantsHTML
+        WantsHTML,
+        SupportsZipStream,
+        SupportsChannelDeltas
     };
 
     QSet<int> battlesSpectated;
@@ -76,7 +78,6 @@ public:
     void sendLoginInfo();
     /* Sends a message to the player */
     void sendMessage(const QString &mess, bool html=false);
-    void sendPlayers(const QVector<reference<PlayerInfo> > & bundles);
 
     bool hasSentCommand(int commandid) const;
 
@@ -105,6 +106,8 @@ public:
     bool isLoggedIn() const;
     bool battling() const;
     bool supportsZip() const;
+    /* Whether the changes of the channels' members are batched for the player (see Channel) */
+    bool supportsChannelDeltas() const;
     bool hasKnowledgeOf(Player *other) const;
     void acquireKnowledgeOf(Player *other);
     void acquireRoughKnowledgeOf(Player *other);
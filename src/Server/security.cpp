@@ -11,8 +11,10 @@
 #include "server.h"
 #include "waitingobject.h"
 #include "loadinsertthread.h"
+#include "memberfile.h"
 
-MemoryHolder<SecurityManager::Member>  SecurityManager::holder;
+/* Not using SQL, the members are read from the member file as needed and kept in the same cache */
+MemoryHolder<SecurityManager::Member>  SecurityManager::holder(10000, true);
 QNickValidator SecurityManager::val(nullptr);
 QHash<QString, unsigned int> SecurityManager::bannedIPs;
 QHash<QString, std::pair<QString, int> > SecurityManager::bannedMembers;
@@ -20,19 +22,10 @@ int SecurityManager::dailyRunDays = 182;
 
 LoadInsertThread<SecurityManager::Member> * SecurityManager::thread = nullptr;
 
-QFile SecurityManager::memberFile;
-int SecurityManager::lastPlace;
+MemberFile SecurityManager::memberFile;
 istringmap<SecurityManager::Member> SecurityManager::members;
-QMultiHash<QString, QString> SecurityManager::playersByIp;
 QSet<QString> SecurityManager::authed;
 
-SecurityManager::Member::Member(const QString &name, const QString &date, int auth, bool banned, const QByteArray &salt, const QByteArray &hash,
-                                const QString &ip, int ban_expire_time)
-    :name(name), date(date), auth(auth), banned(banned), salt(salt), hash(hash), ip(ip), ban_expire_time(ban_expire_time)
-{
-    filepos = -1;
-}
-
 QString SecurityManager::Member::toString() const
 {
     char auth[4] = {'0','0','0', '\0'};
@@ -43,31 +36,6 @@ QString SecurityManager::Member::toString() const
     return QString("%1%%2%%3%%4%%5%%6%%7\n").arg(name, date, auth, QString::fromUtf8(salt), QString::fromUtf8(hash), ip, QString::number(ban_expire_time));
 }
 
-void SecurityManager::Member::write(QIODevice *device) const {
-    assert(filepos >= 0);
-
-    char auth[4] = {'0','0','0', '\0'};
-    if (this->authority() != 0 && this->authority() >= 0 && this->authority() <= 9)
-        auth[0] += this->authority();
-    if (this->isBanned())
-        auth[1] = '1';
-
-    device->write(name.toUtf8().constData());
-    device->write("%");
-    device->write(date.toUtf8().leftJustified(dateLength, ' ', true).constData());
-    device->write("%");
-    device->write(auth);
-    device->write("%");
-    device->write(salt.leftJustified(saltLength, ' ', true).constData());
-    device->write("%");
-    device->write(hash.leftJustified(hashLength, ' ', true).constData());
-    device->write("%");
-    device->write(ip.leftJustified(ipLength, ' ', true).toUtf8().constData());
-    device->write("%");
-    device->write(QByteArray::number(ban_expire_time).rightJustified(banTimeLength, '0', true).constData());
-    device->write("\n");
-}
-
 void SecurityManager::loadSqlMembers() {
 
     QSqlQuery query;
@@ -206,82 +174,95 @@ void SecurityManager::loadMembers()
         loadSqlMembers();
         return;
     }
-    const char *path = "serverdb/members.txt";
-    const char *backup = "serverdb/members.backup.txt";
+    const char *path = "serverdb/members";
+    const char *textPath = "serverdb/members.txt";
     {
         QDir d;
         d.mkdir("serverdb");
     }
 
-    if (!QFile::exists(path) && QFile::exists(backup)) {
-        QFile::rename(backup, path);
+    if (!QFile::exists(QString(path) + ".dat") && QFile::exists(textPath)) {
+        importTextMembers(textPath, path);
     }
 
-    memberFile.setFileName(path);
-    if (!memberFile.open(QFile::ReadWrite)) {
-        throw QObject::tr("Error: cannot open the file that contains the members (%1)").arg(path);
+    if (!memberFile.open(path)) {
+        throw QObject::tr("Error: cannot open the file that contains the members (%1): %2").arg(path, memberFile.errorString());
+    }
+
+    /* Only the members with an auth or a ban are needed at startup, the others are read when they log in */
+    foreach(int index, memberFile.flagged()) {
+        Member m;
+        if (!memberFile.read(index, m)) {
+            continue;
+        }
+
+        if (m.isBanned()) {
+            bannedIPs.insert(m.ip, m.ban_expire_time);
+            bannedMembers.insert(m.name.toLower(), std::pair<QString, int>(m.ip, m.ban_expire_time));
+        }
+        if (m.authority() > 0) {
+            authed.insert(m.name);
+        }
+    }
+}
+
+void SecurityManager::importTextMembers(const QString &textPath, const QString &path)
+{
+    QFile in(textPath);
+
+    if (!in.open(QFile::ReadOnly)) {
+        throw QObject::tr("Error: cannot open the file that contains the members (%1)").arg(textPath);
     }
 
-    int pos = memberFile.pos();
-    while (!memberFile.atEnd()) {
-        QByteArray arr = memberFile.readLine();
+    /* Converted in files of their own, which only take the place of the member files once
+       complete. If the server goes down meanwhile, the conversion starts over next time */
+    QString importPath = path + ".import";
+    QFile::remove(importPath + ".dat");
+    QFile::remove(importPath + ".idx");
+
+    if (!memberFile.open(importPath)) {
+        throw QObject::tr("Error: cannot create the file to convert the members to (%1): %2").arg(importPath, memberFile.errorString());
+    }
+
+    Server::print(QString("Converting %1 to the new member format").arg(textPath));
+
+    int counter = 0;
+    while (!in.atEnd()) {
+        QByteArray arr = in.readLine();
         QString s = QString::fromUtf8(arr.constData(), std::max(0,arr.length()-1)); //-1 to remove the \n
 
         QStringList ls = s.split('%');
 
         if (ls.size() >= 6 && isValid(ls[0])) {
-            Member m (ls[0], ls[1].trimmed(), ls[2][0].toLatin1() - '0', ls[2][1] == '1', ls[3].trimmed().toLatin1(), ls[4].trimmed().toLatin1(), ls[5].trimmed());
+            Member m (ls[0].toLower(), ls[1].trimmed(), ls[2][0].toLatin1() - '0', ls[2][1] == '1', ls[3].trimmed().toLatin1(), ls[4].trimmed().toLatin1(), ls[5].trimmed());
 
             if (ls.size() >= 7) {
                 m.ban_expire_time = ls[6].toInt();
             }
 
-            m.filepos = pos;
-            members[ls[0]] = m;
-
-            /* Update pos for next iteration */
-            pos = memberFile.pos();
-
-            if (m.isBanned()) {
-                bannedIPs.insert(m.ip, m.ban_expire_time);
-                bannedMembers.insert(m.name.toLower(), std::pair<QString, int>(m.ip, m.ban_expire_time));
+            /* Later lines of the same member win, like they did when the whole file was loaded */
+            m.filepos = memberFile.find(m.name);
+            if (!memberFile.write(m)) {
+                Server::print(QString("Couldn't convert member %1: %2").arg(m.name, memberFile.errorString()));
+                continue;
             }
-            if (m.authority() > 0) {
-                authed.insert(m.name);
+
+            if (++counter % 10000 == 0) {
+                Server::print(QString("Converted %1 members so far...").arg(counter));
             }
-            playersByIp.insert(m.ip, m.name);
         }
-        lastPlace = memberFile.pos();
     }
 
-    //We also clean up the file by rewritting it with only the valid contents
-    QFile temp (backup);
-    if (!temp.open(QFile::WriteOnly | QFile::Truncate))
-        throw QObject::tr("Impossible to change %1").arg(backup);
-
-    pos = temp.pos();
+    memberFile.close();
 
-    for(auto it = members.begin(); it != members.end(); ++it) {
-        Member &m = it->second;
-        m.write(&temp);
-        m.filepos = pos;
-        pos = temp.pos();
+    /* The .dat file goes last, its presence means the conversion is done */
+    QFile::remove(path + ".idx");
+    QFile::remove(path + ".dat");
+    if (!QFile::rename(importPath + ".idx", path + ".idx") || !QFile::rename(importPath + ".dat", path + ".dat")) {
+        throw QObject::tr("Error: cannot move the converted members to %1").arg(path);
     }
 
-    lastPlace = temp.pos();
-
-    temp.flush();
-    memberFile.remove();
-
-    if (!temp.rename(path)) {
-        throw QObject::tr("Error: cannot rename the file that contains the members (%1 -> %2)").arg(backup).arg(path);
-    }
-
-    temp.rename(path);
-
-    if (!memberFile.open(QFile::ReadWrite)) {
-        throw QObject::tr("Error: cannot reopen the file that contains the members (%1)").arg(path);
-    }
+    Server::print(QString("Converted %1 members").arg(counter));
 }
 
 void SecurityManager::init()
@@ -300,6 +281,7 @@ void SecurityManager::init()
 void SecurityManager::destroy()
 {
     thread->finish();
+    memberFile.close();
 }
 
 bool SecurityManager::isValid(const QString &name) {
@@ -308,15 +290,16 @@ bool SecurityManager::isValid(const QString &name) {
 
 bool SecurityManager::exist(const QString &name)
 {
+    if (!isSql() && !holder.isInMemory(name)) {
+        /* The index is enough, no need to fill the cache with every name checked */
+        return memberFile.find(name) != -1;
+    }
+
     if (!holder.isInMemory(name)) {
         loadMemberInMemory(name);
     }
 
-    if (isSql()) {
-        return holder.exists(name);
-    } else {
-        return members.find(name) != members.end();
-    }
+    return holder.exists(name);
 }
 
 SecurityManager::Member SecurityManager::member(const QString &name)
@@ -327,11 +310,7 @@ SecurityManager::Member SecurityManager::member(const QString &name)
 
     assert(exist(name));
 
-    if (isSql()) {
-        return holder.member(name);
-    } else {
-        return members[name];
-    }
+    return holder.member(name);
 }
 
 QStringList SecurityManager::membersForIp(const QString &ip)
@@ -358,7 +337,17 @@ QStringList SecurityManager::membersForIp(const QString &ip)
 
         return ret;
     }
-    return playersByIp.values(ip);
+
+    QStringList ret;
+
+    foreach(int index, memberFile.findByIp(ip)) {
+        Member m;
+        if (memberFile.read(index, m)) {
+            ret.push_back(m.name);
+        }
+    }
+
+    return ret;
 }
 
 QHash<QString, std::pair<QString, int> > SecurityManager::banList()
@@ -398,8 +387,11 @@ QStringList SecurityManager::userList()
             ret.push_back(q.value(0).toString());
         }
     } else {
-        for(auto it = members.begin(); it != members.end(); ++it) {
-            ret.push_back(it->first);
+        for (int i = 0; i < memberFile.records(); i++) {
+            Member m;
+            if (memberFile.read(i, m)) {
+                ret.push_back(m.name);
+            }
         }
     }
 
@@ -417,21 +409,21 @@ void SecurityManager::deleteUser(const QString &name)
         return;
     }
 
-    Member m = member(name);
+    int index = memberFile.find(name);
+    Member m;
 
-    assert (m.name.length() > 0);
+    if (!memberFile.read(index, m)) {
+        return;
+    }
 
-    m.name[0] = ':'; //invalid character, will not get loaded when reloading database
-    memberFile.seek(m.filepos);
-    members[name].write(&memberFile);
-    memberFile.flush();
+    memberFile.remove(index);
 
-    playersByIp.remove(m.ip, name);
-    authed.remove(name);
-    members.erase(name);
-    bannedMembers.remove(name.toLower());
+    holder.removeMemberInMemory(m.name.toLower());
+    holder.addNonExistant(m.name.toLower());
+    authed.remove(m.name);
+    bannedMembers.remove(m.name.toLower());
 
-    if (bannedIPs.contains(m.ip) && !playersByIp.contains(m.ip)) {
+    if (bannedIPs.contains(m.ip) && memberFile.findByIp(m.ip).isEmpty()) {
         bannedIPs.remove(m.ip);
     }
 }
@@ -603,7 +595,11 @@ void SecurityManager::clearPass(const QString &name) {
 int SecurityManager::maxAuth(const QString &ip) {
     int max = 0;
 
-    foreach(QString name, playersByIp.values(ip)) {
+    if (isSql()) {
+        return max;
+    }
+
+    foreach(QString name, membersForIp(ip)) {
         max = std::max(auth(name), max);
     }
 
@@ -627,9 +623,12 @@ void SecurityManager::loadMemberInMemory(const QString &name, QObject *o, const
         if (holder.isInMemory(n2))
             return;
 
-        qDebug() << "loading member in memory not with a thread";
+        if (!isSql()) {
+            loadMember(nullptr, n2, GetInfoOnUser);
+            return;
+        }
 
-        assert(isSql());
+        qDebug() << "loading member in memory not with a thread";
 
         QSqlQuery q;
         q.setForwardOnly(true);
@@ -645,6 +644,11 @@ void SecurityManager::loadMemberInMemory(const QString &name, QObject *o, const
     connect(w, SIGNAL(waitFinished()), o, slot);
     connect(w, SIGNAL(waitFinished()), WaitingObjects::getInstance(), SLOT(freeObject()));
 
+    if (!isSql() && !holder.isInMemory(n2)) {
+        /* A read in the mapped file, not worth a trip to the thread */
+        loadMember(nullptr, n2, GetInfoOnUser);
+    }
+
     if (holder.isInMemory(n2)) {
         w->emitSignal();
     }
@@ -660,15 +664,23 @@ LoadInsertThread<SecurityManager::Member> * SecurityManager::getThread()
     return thread;
 }
 
+QString SecurityManager::writeStats()
+{
+    return thread ? thread->writeStats() : QString();
+}
+
 void SecurityManager::insertMember(QSqlQuery *q, void *m2, int update)
 {
     SecurityManager::Member &m = * (SecurityManager::Member*) m2;
 
     if (isSql()) {
-        if (update)
-            q->prepare("update trainers set laston=:laston, auth=:auth, banned=:banned, salt=:salt, hash=:hash, ip=:ip, ban_expire_time=:banexpire where name=:name");
-        else
-            q->prepare("insert into trainers(name, laston, auth, banned, salt, hash, ip, ban_expire_time) values(:name, :laston, :auth, :banned, :salt, :hash, :ip, :banexpire)");
+        const char *statement = update ? "update trainers set laston=:laston, auth=:auth, banned=:banned, salt=:salt, hash=:hash, ip=:ip, ban_expire_time=:banexpire where name=:name"
+                                       : "insert into trainers(name, laston, auth, banned, salt, hash, ip, ban_expire_time) values(:name, :laston, :auth, :banned, :salt, :hash, :ip, :banexpire)";
+
+        /* The query is kept prepared between writes of the same kind */
+        if (q->lastQuery() != statement) {
+            q->prepare(statement);
+        }
 
         q->bindValue(":name", m.name.toLower());
         q->bindValue(":laston", m.date);
@@ -685,39 +697,36 @@ void SecurityManager::insertMember(QSqlQuery *q, void *m2, int update)
         return;
     }
 
-    if (update) {
-        Member oldm = member(m.name);
-        m.filepos = oldm.filepos;
-
-        playersByIp.remove(oldm.ip, oldm.name);
-        authed.remove(oldm.name);
-
-        members[m.name] = m;
-        memberFile.seek(m.filepos);
-        m.write(&memberFile);
-        memberFile.flush();
-    } else {
-        m.filepos = lastPlace;
-        members[m.name] = m;
-
-        memberFile.seek(lastPlace);
-        m.write(&memberFile);
-
-        lastPlace = memberFile.pos();
-
-        memberFile.flush();
+    /* Found through the index rather than trusted, the member in memory may have been copied before its first write */
+    m.filepos = memberFile.find(m.name);
+    if (!memberFile.write(m)) {
+        Server::print(QString("Error writing member %1: %2").arg(m.name, memberFile.errorString()));
+        return;
     }
 
-    playersByIp.insert(m.ip,m.name);
+    holder.addMemberInMemory(m);
+
     if (m.auth > 0) {
         authed.insert(m.name);
+    } else {
+        authed.remove(m.name);
     }
 }
 
 void SecurityManager::loadMember(QSqlQuery *q, const QVariant &name, int query_type)
 {
     if (!isSql()) {
-        /* No SQL usage, all already in memory */
+        if (query_type == SecurityManager::GetInfoOnUser) {
+            QString n2 = name.toString().toLower();
+            Member m;
+
+            if (!memberFile.read(memberFile.find(n2), m)) {
+                holder.addNonExistant(n2);
+            } else {
+                m.name = m.name.toLower();
+                holder.addMemberInMemory(m);
+            }
+        }
         return;
     }
 
@@ -794,6 +803,15 @@ const istringmap<SecurityManager::Member> & SecurityManager::getMembers() {
 
             members[m.name] = m;
         }
+    } else {
+        members.clear();
+
+        for (int i = 0; i < memberFile.records(); i++) {
+            Member m;
+            if (memberFile.read(i, m)) {
+                members[m.name] = m;
+            }
+        }
     }
 
     return members;
@@ -824,8 +842,11 @@ void SecurityManager::dailyRunEx(QSqlQuery *q)
     qDebug() << "Processing daily run for members with limit " << limit;
 
     QStringList toDelete;
-    for (auto it = members.begin(); it != members.end(); ++it) {
-        Member &m = it->second;
+    for (int i = 0; i < memberFile.records(); i++) {
+        Member m;
+        if (!memberFile.read(i, m)) {
+            continue;
+        }
 
         if (m.authority() <= 0 && !m.isBanned() && m.date < limit) {
             toDelete.push_back(m.name);
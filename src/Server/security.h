@@ -11,6 +11,7 @@
 #include "memoryholder.h"
 
 class WaitingObject;
+class MemberFile;
 
 template<class T> class LoadInsertThread;
 
@@ -31,7 +32,10 @@ public:
     /* A member as stored in the file */
     struct Member {
         Member(const QString &name="", const QString &date="", int auth = 0, bool banned = false,
-               const QByteArray &salt="", const QByteArray &hash="", const QString &ip="", int ban_expire_time = 0);
+               const QByteArray &salt="", const QByteArray &hash="", const QString &ip="", int ban_expire_time = 0)
+            : name(name), date(date), auth(auth), banned(banned), salt(salt), hash(hash), ip(ip), filepos(-1),
+              ban_expire_time(ban_expire_time) {
+        }
         QString name;
         QString date;
         int auth;
@@ -39,7 +43,7 @@ public:
         QByteArray salt;
         QByteArray hash;
         QString ip;
-        int filepos; // position in the file
+        int filepos; // record in the member file, when not using SQL
         unsigned int ban_expire_time;
 
         void modifyIP(const QString &ip) {
@@ -94,8 +98,6 @@ public:
         static const int dateLength = 19;
         static const int ipLength = 39; //IPv6 is 39, so lets be ready for the future
         static const int banTimeLength = 10;
-
-        void write(QIODevice *device) const;
     };
 
 
@@ -135,6 +137,8 @@ public:
 
     static void processDailyRun(int maxdays, bool async=true);
     static void exportDatabase();
+    /* State of the queue of writes to the database */
+    static QString writeStats();
 private slots:
     static void insertMember(QSqlQuery *q, void *m, int update);
     static void loadMember(QSqlQuery *q, const QVariant &name, int query_type);
@@ -143,6 +147,8 @@ private slots:
 private:
     static void loadMembers();
     static void loadSqlMembers();
+    /* Converts the members.txt of older versions into the member files at path */
+    static void importTextMembers(const QString &textPath, const QString &path);
 
     static MemoryHolder<Member> holder;
 
@@ -164,11 +170,9 @@ private:
     static QNickValidator val;
 
     static int dailyRunDays;
-    static int lastPlace;
-    static QFile memberFile;
+    static MemberFile memberFile;
     static istringmap<Member> members;
 
-    static QMultiHash<QString, QString> playersByIp;
     static QSet<QString> authed;
 };
 
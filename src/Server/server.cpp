@@ -114,6 +114,7 @@ void Server::start(){
     setDefaultValue("Server/MinimumHTML", -1); // -1 is disabled
     setDefaultValue("Channels/LoggingEnabled", false);
     setDefaultValue("Channels/MainChannel", QString());
+    setDefaultValue("Channels/DeltaWindow", 100); // in ms, 0 is disabled
     setDefaultValue("Ladder/MonthsExpiration", 3);
     setDefaultValue("Ladder/PeriodDuration", 24);
     setDefaultValue("Ladder/DecayPerPeriod", 5);
@@ -125,8 +126,11 @@ void Server::start(){
     setDefaultValue("Battles/RatedThroughChallenge", false);
     setDefaultValue("Network/ProxyServers",QString("127.0.0.1,::1%0,localhost"));
     setDefaultValue("Network/LowTCPDelay", false);
+    setDefaultValue("Network/ZipStream", true);
+    setDefaultValue("Network/ZipStreamDictionary", true);
     setDefaultValue("AntiDOS/ShowOveractiveMessages", true);
     setDefaultValue("AntiDOS/TrustedIps", "127.0.0.1,::1%0,localhost");
+    setDefaultValue("AntiDOS/BannedRanges", QString());
     setDefaultValue("AntiDOS/MaxPeoplePerIp", 2);
     setDefaultValue("AntiDOS/MaxCommandsPerUser", 50);
     setDefaultValue("AntiDOS/MaxKBPerUser", 25);
@@ -147,6 +151,8 @@ void Server::start(){
     setDefaultValue("SQL/Host", "localhost");
     setDefaultValue("SQL/DatabaseSchema", "");
     setDefaultValue("SQL/VacuumOnStartup", true);
+    setDefaultValue("SQL/WriteBatchSize", 200);
+    setDefaultValue("SQL/WriteMaxStaleness", 2000);
 
     registry = new RegistryCommunicator(s.value("Registry/IP").toString(), this);
 
@@ -178,6 +184,7 @@ void Server::start(){
 
     TierMachine::init();
     connect(TierMachine::obj(), SIGNAL(tiersChanged()), SLOT(tiersChanged()));
+    connect(TierMachine::obj(), SIGNAL(dailyRunFinished()), SLOT(ratingsUpdated()));
 
     AntiDos::init(s);
     RelayManager::init();
@@ -240,6 +247,9 @@ void Server::start(){
     serverPrivate = quint16(s.value("Server/Private").toInt());
     amountOfInactiveDays = s.value("Players/InactiveThresholdInDays").toInt();
     lowTCPDelay = quint16(s.value("Network/LowTCPDelay").toBool());
+    zipStream = s.value("Network/ZipStream").toBool();
+    zipDictionary = s.value("Network/ZipStreamDictionary").toBool() ? ::zipStreamDictionary() : QByteArray();
+    deltaWindow = s.value("Channels/DeltaWindow").toInt();
     safeScripts = s.value("Scripts/SafeMode").toBool();
     overactiveShow = s.value("AntiDOS/ShowOveractiveMessages").toBool();
     proxyServers = s.value("Network/ProxyServers").toString().split(",");
@@ -265,6 +275,12 @@ void Server::start(){
     connect(t2, SIGNAL(timeout()), this, SLOT(processDailyRun()));
     t2->start(24*3600*1000);
 
+    /* Searchers that couldn't be matched when they started searching are tried again
+       every few seconds, as scripts and rated battle restrictions can change their mind */
+    QTimer *t3 = new QTimer(this);
+    connect(t3, SIGNAL(timeout()), this, SLOT(processBattleSearches()));
+    t3->start(10*1000);
+
     myengine = new ScriptEngine(this);
     myengine->init();
     myengine->serverStartUp();
@@ -286,6 +302,7 @@ void Server::initBattles()
     connect(battles, SIGNAL(error()), battles, SLOT(startServer()));
     connect(battles, SIGNAL(battleFinished(int,int,int,int)), SLOT(battleResult(int,int,int,int)));
     connect(battles, SIGNAL(battleInfo(int,int,QByteArray)), SLOT(sendBattleCommand(int,int,QByteArray)));
+    connect(battles, SIGNAL(battleBroadcast(int,int,QByteArray)), SLOT(broadcastBattleCommand(int,int,QByteArray)));
     connect(battles, SIGNAL(sendBattleInfos(int,int,int,TeamBattle,BattleConfiguration,QString)), SLOT(sendBattleInfos(int,int,int,TeamBattle,BattleConfiguration,QString)));
 }
 
@@ -353,7 +370,10 @@ void Server::updateDatabase()
 void Server::updateRatings()
 {
     TierMachine::obj()->processDailyRun();
+}
 
+void Server::ratingsUpdated()
+{
     broadCast("All ratings updated!");
 
     /* Updating ratings of the players online */
@@ -997,6 +1017,50 @@ void Server::sendBattleCommand(int publicId, int id, const QByteArray &comm)
     }
 }
 
+void Server::broadcastBattleCommand(int publicId, int except, const QByteArray &comm)
+{
+    int ids[2];
+
+    if (battles->contains(publicId)) {
+        FullBattleConfiguration *battle = battles->battle(publicId);
+        ids[0] = battle->id(0);
+        ids[1] = battle->id(1);
+    } else if (endedBattles.contains(publicId)) {
+        /* Sent after the battle was removed, only its players may still get it */
+        ids[0] = endedBattles[publicId].first;
+        ids[1] = endedBattles[publicId].second;
+    } else {
+        return;
+    }
+
+    /* Framed once, every player of the audience gets the same buffer */
+    QByteArray battlePacket, watchPacket;
+
+    for (int i = 0; i < 2; i++) {
+        int id = ids[i];
+
+        if (id == except || !playerExist(id)) {
+            continue;
+        }
+        if (player(id)->hasBattle(publicId) || player(id)->lastBattle() == publicId) {
+            if (battlePacket.isNull()) {
+                battlePacket = makePacket(NetworkServ::BattleMessage, qint32(publicId), comm);
+            }
+            player(id)->sendPacket(battlePacket);
+        }
+    }
+
+    foreach(int id, battles->liveSpectators(publicId)) {
+        if (id == except || !playerExist(id) || !player(id)->battlesSpectated.contains(publicId)) {
+            continue;
+        }
+        if (watchPacket.isNull()) {
+            watchPacket = makePacket(NetworkServ::SpectatingBattleMessage, qint32(publicId), comm);
+        }
+        player(id)->sendPacket(watchPacket);
+    }
+}
+
 void Server::sendServerMessage(const QString &message)
 {
     if (myengine->beforeServerMessage(message))
@@ -1162,9 +1226,12 @@ void Server::awayChanged(int src, bool away)
 
     bool ladder = player(src)->state()[Player::LadderEnabled];
 
+    outdatePlayer(src);
+
     ++lastDataId;
     foreach(int chanid, player(src)->getChannels()) {
-        notifyChannelLastId(chanid, NetworkServ::OptionsChange, qint32(src), Flags(ladder + (away << 1)));
+        channel(chanid).changeOptions(src, ladder + (away << 1));
+        notifyChannelChange(chanid, NetworkServ::OptionsChange, qint32(src), Flags(ladder + (away << 1)));
     }
 }
 
@@ -1214,7 +1281,7 @@ void Server::transferId(int sender, int id, bool copyInfo)
 void Server::cancelSearch(int id)
 {
     player(id)->battleSearch() = false;
-    delete battleSearchs.take(id);
+    battleSearchs.remove(id);
 }
 
 void Server::dealWithChallenge(int from, int to, const ChallengeInfo &c)
@@ -1240,76 +1307,139 @@ void Server::findBattle(int id, const FindBattleData &_f)
 
     f.shuffle(p1->teamCount());
 
-    QHash<int, FindBattleDataAdv*>::iterator it;
-    for(it = battleSearchs.begin(); it != battleSearchs.end(); ++it)
-    {
-        int key = it.key();
-        FindBattleDataAdv *data = it.value();
-        Player *p2 = player(key);
+    QVector<MatchmakingQueue::Entry> entries;
+    for (int i = 0; i < f.shuffled.count(); i++) {
+        const TeamBattle &t = p1->team(f.shuffled[i]);
+
+        MatchmakingQueue::Entry e;
+        e.player = id;
+        e.team = f.shuffled[i];
+        e.rating = p1->rating(t.tier);
+        e.tier = t.tier;
+        e.gen = t.gen;
+        e.allowIllegal = TierMachine::obj()->tier(t.tier).allowIllegal == "true";
+
+        entries.push_back(e);
+    }
+
+    battleSearchs.insert(id, f, entries);
+    p1->battleSearch() = true;
+
+    matchBattleSearch(id);
+}
+
+void Server::processBattleSearches()
+{
+    foreach(int id, battleSearchs.players()) {
+        /* Could have been matched with someone earlier in the loop */
+        if (battleSearchs.contains(id)) {
+            matchBattleSearch(id);
+        }
+    }
+}
+
+bool Server::matchBattleSearch(int id)
+{
+    /* The scripts are only called on the first few candidates of each team, the others
+       are left to the next time the searches are processed */
+    static const int maxCandidates = 8;
 
-        /* First look if this not a repeat */
-        if (p2->lastFindBattleIp() == p1->ip() || p1->lastFindBattleIp() == p2->ip()) {
+    /* Copied, the search is removed from the queue when the battle starts */
+    const MatchmakingQueue::Search s = battleSearchs.search(id);
+    const FindBattleDataAdv &f = s.data;
+
+    Player *p1 = player(id);
+
+    for (int i = 0; i < s.entries.size(); i++) {
+        const MatchmakingQueue::Entry &e = s.entries[i];
+
+        if (e.team >= p1->teamCount()) {
             continue;
         }
 
-        for (int i = 0; i < f.shuffled.count(); i++) {
-            for (int j = 0; j < data->shuffled.count(); j++) {
-                const TeamBattle &t1 = p1->team(f.shuffled[i]);
-                const TeamBattle &t2 = p2->team(data->shuffled[j]);
+        const TeamBattle &t1 = p1->team(e.team);
+        QList<QPair<MatchmakingQueue::Entry, ChallengeInfo> > candidates;
 
-                if (t1.gen != t2.gen)
-                    continue;
+        battleSearchs.findOpponent(e, f, [&](const MatchmakingQueue::Entry &o, const FindBattleDataAdv &data) -> bool {
+            int key = o.player;
+            Player *p2 = player(key);
 
-                /* We check the tier thing */
-                if ( (f.sameTier || data->sameTier) && t1.tier != t2.tier)
-                    continue;
+            /* First look if this not a repeat */
+            if (p2->lastFindBattleIp() == p1->ip() || p1->lastFindBattleIp() == p2->ip()) {
+                return false;
+            }
 
-                /* skip if one side doesn't allow illegal pokemon */
-                if (TierMachine::obj()->tier(t1.tier).allowIllegal != TierMachine::obj()->tier(t2.tier).allowIllegal) {
-                    continue;
-                }
+            if (o.team >= p2->teamCount()) {
+                return false;
+            }
 
-                /* We check both allow rated if needed */
-                if (f.rated || data->rated) {
-                    if (!canHaveRatedBattle(id, key, t1, t2, f.rated, data->rated))
-                        continue;
-                }
+            const TeamBattle &t2 = p2->team(o.team);
 
-                /* Then the range thing */
-                if (f.ranged)
-                    if (p1->rating(t1.tier) - f.range > p2->rating(t2.tier) || p1->rating(t1.tier) + f.range < p2->rating(t2.tier) )
-                        continue;
-                if (data->ranged)
-                    if (p1->rating(t1.tier) - data->range > p2->rating(t2.tier) || p1->rating(t1.tier) + data->range < p2->rating(t2.tier) )
-                        continue;
-
-                //We have a match!
-                ChallengeInfo c;
-                c.opp = key;
-                c.rated =  f.rated || data->rated || canHaveRatedBattle(id, key, t1, t2, f.rated, data->rated);
-                c.clauses = TierMachine::obj()->tier(t1.tier).getClauses();
-                c.mode = TierMachine::obj()->tier(t1.tier).getMode();
-                c.gen = t1.gen;
-
-                /* If someone has an invalid team, and it's not CC, cancel the match */
-                if (!(c.clauses & ChallengeInfo::ChallengeCup) && (t1.invalid() || t2.invalid())) {
-                    continue;
-                }
+            /* The team may have changed since the search started */
+            if (t1.gen != t2.gen || t2.tier != o.tier || t1.tier != e.tier) {
+                return false;
+            }
 
-                if (myengine->beforeBattleMatchup(id,key,c, f.shuffled[i], data->shuffled[j])) {
-                    player(id)->lastFindBattleIp() = player(key)->ip();
-                    player(key)->lastFindBattleIp() = player(id)->ip();
-                    startBattle(id,key,c,f.shuffled[i], data->shuffled[j]);
-                    myengine->afterBattleMatchup(id,key,c, f.shuffled[i], data->shuffled[j]);
-                    return;
-                }
+            /* We check both allow rated if needed */
+            if (f.rated || data.rated) {
+                if (!canHaveRatedBattle(id, key, t1, t2, f.rated, data.rated))
+                    return false;
+            }
+
+            /* Then the range thing, the ratings in the queue are only used to narrow the search */
+            int r1 = p1->rating(t1.tier), r2 = p2->rating(t2.tier);
+            if (f.ranged)
+                if (r1 - f.range > r2 || r1 + f.range < r2)
+                    return false;
+            if (data.ranged)
+                if (r1 - data.range > r2 || r1 + data.range < r2)
+                    return false;
+
+            ChallengeInfo c;
+            c.opp = key;
+            c.rated =  f.rated || data.rated || canHaveRatedBattle(id, key, t1, t2, f.rated, data.rated);
+            c.clauses = TierMachine::obj()->tier(t1.tier).getClauses();
+            c.mode = TierMachine::obj()->tier(t1.tier).getMode();
+            c.gen = t1.gen;
+
+            /* If someone has an invalid team, and it's not CC, cancel the match */
+            if (!(c.clauses & ChallengeInfo::ChallengeCup) && (t1.invalid() || t2.invalid())) {
+                return false;
+            }
+
+            candidates.push_back(QPair<MatchmakingQueue::Entry, ChallengeInfo>(o, c));
+            return candidates.size() >= maxCandidates;
+        });
+
+        for (int j = 0; j < candidates.size(); j++) {
+            int key = candidates[j].first.player;
+            int team = candidates[j].first.team;
+            ChallengeInfo &c = candidates[j].second;
+
+            /* The scripts may have done anything in the meantime */
+            if (!battleSearchs.contains(id)) {
+                return false;
+            }
+            if (!battleSearchs.contains(key)) {
+                continue;
+            }
+
+            if (myengine->beforeBattleMatchup(id,key,c, e.team, team)) {
+                battleSearchs.remove(id);
+                battleSearchs.remove(key);
+                player(id)->battleSearch() = false;
+                player(key)->battleSearch() = false;
+
+                player(id)->lastFindBattleIp() = player(key)->ip();
+                player(key)->lastFindBattleIp() = player(id)->ip();
+                startBattle(id,key,c,e.team, team);
+                myengine->afterBattleMatchup(id,key,c, e.team, team);
+                return true;
             }
         }
     }
 
-    /* Not reached if a match was found */
-    battleSearchs.insert(id, new FindBattleDataAdv(f));
-    p1->battleSearch() = true;
+    return false;
 }
 
 bool Server::beforePlayerRegister(int src)
@@ -1421,6 +1551,7 @@ void Server::trustedIpsChanged(const QString &ips)
     if (trustedIps == newlist)
         return;
     trustedIps = ips.split(",");
+    AntiDos::obj()->setTrustedIps(trustedIps);
     forcePrint("Trusted IPs setting changed");
 }
 
@@ -1569,7 +1700,7 @@ void Server::startBattle(int id1, int id2, const ChallengeInfo &c, int team1, in
     foreach(int chanid, allChannels) {
         Channel &chan = channel(chanid);
         if (!chan.battleList.contains(id)) {
-            chan.battleList.insert(id,battleS);
+            chan.insertBattle(id,battleS);
         }
 
         foreach(int pid, chan.players) {
@@ -1651,7 +1782,7 @@ void Server::battleResult(int battleid, int desc, int winner, int loser)
         foreach(int chanid, allChannels) {
             Channel &chan = channel(chanid);
 
-            chan.battleList.remove(battleid);
+            chan.removeBattle(battleid);
             notifyChannelLastId(chanid, NetworkServ::BattleFinished, qint32(battleid), qint8(desc), qint8(mode), qint32(winner), qint32(loser));
         }
 
@@ -1698,17 +1829,44 @@ void Server::removeBattle(int battleid)
     Player* p1 = player(battle->id(0));
     Player* p2 = player(battle->id(1));
 
+    int previous1 = p1->lastBattle(), previous2 = p2->lastBattle();
+
     p1->removeBattle(battleid);
     p2->removeBattle(battleid);
 
+    endedBattles.insert(battleid, qMakePair(battle->id(0), battle->id(1)));
+    forgetEndedBattle(previous1);
+    forgetEndedBattle(previous2);
+
     battles->removeBattle(battleid);
 }
 
+void Server::forgetEndedBattle(int battleid)
+{
+    if (!endedBattles.contains(battleid)) {
+        return;
+    }
+
+    const QPair<int, int> &ids = endedBattles[battleid];
+
+    if ((playerExist(ids.first) && player(ids.first)->lastBattle() == battleid) ||
+            (playerExist(ids.second) && player(ids.second)->lastBattle() == battleid)) {
+        return;
+    }
+
+    endedBattles.remove(battleid);
+}
+
 void Server::sendBattlesList(int playerid, int chanid)
 {
-    Analyzer &relay = player(playerid)->relay();
+    channel(chanid).sendBattleList(player(playerid));
+}
 
-    relay.sendBattleList(chanid, channel(chanid).battleList);
+void Server::outdatePlayer(int id)
+{
+    foreach(int chanid, player(id)->getChannels()) {
+        channel(chanid).outdatePlayer(id);
+    }
 }
 
 void Server::sendPlayer(int id)
@@ -1721,6 +1879,8 @@ void Server::sendPlayer(int id)
 
     PlayerInfo bundle = source->bundle();
 
+    outdatePlayer(id);
+
     ++lastDataId;
     foreach(int chanid, source->getChannels()) {
         notifyChannelLastId(chanid, NetworkServ::PlayersList, bundle);
@@ -1735,7 +1895,8 @@ void Server::sendLogout(int id)
 
     ++lastDataId;
     foreach(int chanid, source->getChannels()) {
-        notifyChannelLastId(chanid, NetworkServ::Logout, qint32(id));
+        channel(chanid).logout(id);
+        notifyChannelChange(chanid, NetworkServ::Logout, qint32(id));
     }
 }
 
@@ -1902,6 +2063,7 @@ void Server::removePlayer(int id)
         }
 
         myplayers.take(id)->deleteLater();
+        forgetEndedBattle(p->lastBattle());
 
         if ((loggedIn || p->state()[Player::WaitingReconnect]) && mynames.value(playerName.toLower()) == p->id())
             mynames.remove(playerName.toLower());
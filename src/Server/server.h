@@ -6,6 +6,7 @@
 #include <PokemonInfo/networkstructs.h>
 #include "serverinterface.h"
 #include "channel.h"
+#include "matchmaking.h"
 
 #define PRINTOPT(a, b) (fprintf(stdout, "  %-25s\t%s\n", a, b))
 
@@ -65,6 +66,8 @@ public:
     void sendMessage(int id, const QString &message);
 
     void sendBattlesList(int id, int chanid);
+    /* The info of the player changed, drops it from the player lists its channels keep */
+    void outdatePlayer(int id);
     /* Sends the login of the player to everybody but the player */
     void sendLogin(int id);
     void sendLogout(int id);
@@ -106,6 +109,13 @@ public:
     bool isSafeScripts() const { return safeScripts; }
     bool isPrivate() const { return serverPrivate == 1; }
     bool isLegalProxyServer(const QString &ip) const;
+    /* Whether to compress the connections of the players supporting it in a single deflate stream,
+       and the preset dictionary to use for it (can be empty) */
+    bool useZipStream() const { return zipStream; }
+    const QByteArray &zipStreamDictionary() const { return zipDictionary; }
+    /* How long channels gather the changes of their members before sending them at once
+       to the players supporting it, in ms. 0 if they are sent right away */
+    int channelDeltaWindow() const { return deltaWindow; }
 
     bool isPasswordProtected() const { return passwordProtected; }
 
@@ -167,6 +177,7 @@ public slots:
     void startBattle(int id1, int id2, const ChallengeInfo &c, int team1=0,int team2=0);
     void battleResult(int battleid, int desc, int winner, int loser);
     void sendBattleCommand(int battleId, int id, const QByteArray &command);
+    void broadcastBattleCommand(int battleId, int except, const QByteArray &command);
     void spectatingRequested(int id, int ongoingBattle);
     void spectatingStopped(int id, int ongoingBattle);
     bool joinRequest(int player, const QString &chn);
@@ -198,6 +209,8 @@ public slots:
     void tiersChanged();
     void findBattle(int id,const FindBattleData &f);
     void cancelSearch(int id);
+    /* Tries again to match every searcher, the earliest ones first */
+    void processBattleSearches();
     void loadRatedBattlesSettings();
 
     void channelClose(int chanid);
@@ -205,6 +218,7 @@ public slots:
     void processDailyRun();
     void updateDatabase();
     void updateRatings();
+    void ratingsUpdated();
 
     void atServerShutDown();
     void battleConnectionLost();
@@ -228,6 +242,9 @@ private:
     bool useChannelFileLog;
     int amountOfInactiveDays;
     bool lowTCPDelay;
+    bool zipStream;
+    QByteArray zipDictionary;
+    int deltaWindow;
     bool safeScripts;
     bool overactiveShow;
     bool passwordProtected;
@@ -275,6 +292,11 @@ private:
     Cache<QByteArray, void (*)(QByteArray&)> zchannelCache;
 
     QHash<qint32, Battle> battleList;
+    /* Players of the battles that were removed, for the commands the battle server sends
+       after the end (like the clocks stopping on a forfeit). Kept while one of them still has
+       it as their last battle */
+    QHash<qint32, QPair<int, int> > endedBattles;
+    void forgetEndedBattle(int battleid);
 
 #ifndef BOOST_SOCKETS
     QTcpServer *server(int i);
@@ -321,7 +343,9 @@ private:
 
     ScriptEngine *myengine;
 
-    QHash<int, FindBattleDataAdv*> battleSearchs;
+    MatchmakingQueue battleSearchs;
+    /* Looks for an opponent for the searcher, and starts the battle if found */
+    bool matchBattleSearch(int id);
 public:
     template <typename ...Params>
     void notifyGroup(PlayerGroupFlags group, int command, Params &&... params);
@@ -342,6 +366,8 @@ public:
     /* Notify all players in the channel part of the group which haven't received the same command already */
     template <typename ...Params>
     void notifyChannelLastId(int channel, int command, Params &&... params);
+    template <typename ...Params>
+    void notifyChannelChange(int channel, int command, Params &&... params);
 
     /* Notify all players in the channel not part of the group */
     template <typename ...Params>
@@ -90,6 +90,21 @@ void Server::notifyChannelLastId(int channel, int command, Params &&... params)
     }
 }
 
+/* Same as notifyChannelLastId, but for a change of the channel's members: the players
+   getting them batched are told by the channel instead */
+template <typename ...Params>
+void Server::notifyChannelChange(int channel, int command, Params &&... params)
+{
+    QByteArray packet = makePacket(command, std::forward<Params>(params)...);
+
+    foreach(int pid, this->channel(channel).players) {
+        Player *p = player(pid);
+        if (!p->supportsChannelDeltas() && !p->hasSentCommand(lastDataId)) {
+            p->sendPacket(packet);
+        }
+    }
+}
+
 template <typename ...Params>
 void Server::notifyAll(int command, Params &&... params)
 {
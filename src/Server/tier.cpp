@@ -4,6 +4,7 @@ class uniqueId;
 unsigned int qHash (const Pokemon::uniqueId &key);
 
 #include <cmath>
+#include <algorithm>
 #include <ctime>
 #include <cassert>
 
@@ -72,17 +73,50 @@ void MemberRating::calculateDisplayedRating()
 
     /* We don't do a min check on the time, in order to let alts be 3 months old and get deleted.*/
 
-    if (bonus_time > 0)
-        displayed_rating = rating;
-    else {
-        int percent =  ((-bonus_time)/(hpp*3600))*TierMachine::obj()->percent_per_period;
+    displayed_rating = displayedRating(cur_time);
+}
 
-        if (percent > TierMachine::obj()->max_percent_decay) {
-            percent = TierMachine::obj()->max_percent_decay;
-        }
+int MemberRating::displayedRating(int now) const
+{
+    /* The bonus time only goes down with time */
+    int bonus = bonus_time - (now - last_check_time);
+
+    if (bonus > 0) {
+        return rating;
+    }
+
+    const int hpp = TierMachine::obj()->hours_per_period;
+    int percent =  ((-bonus)/(hpp*3600))*TierMachine::obj()->percent_per_period;
+
+    if (percent > TierMachine::obj()->max_percent_decay) {
+        percent = TierMachine::obj()->max_percent_decay;
+    }
+
+    return 1000 + (rating-1000) * (100 - percent) / 100;
+}
 
-        displayed_rating = 1000 + (rating-1000) * (100 - percent) / 100;
+int MemberRating::nextDecay(int now) const
+{
+    const TierMachine *tm = TierMachine::obj();
+    const int period = tm->hours_per_period * 3600;
+    /* When the bonus time reaches 0 */
+    const int expiry = last_check_time + bonus_time;
+    /* Periods after which the decay doesn't go further */
+    const int lastPeriod = std::max(tm->max_percent_decay + tm->percent_per_period - 1, 0) / tm->percent_per_period;
+
+    int next = expiry + tm->alt_expiration * 3600 * 24 * 30 + 1;
+
+    int periods = now < expiry ? 0 : (now - expiry) / period;
+    if (periods < lastPeriod) {
+        next = std::min(next, expiry + (periods + 1) * period);
     }
+
+    return next;
+}
+
+bool MemberRating::expired(int now) const
+{
+    return bonus_time - (now - last_check_time) < -TierMachine::obj()->alt_expiration * 3600 * 24 * 30;
 }
 
 QPair<int, int> MemberRating::pointChangeEstimate(int opponent_rating)
@@ -248,12 +282,61 @@ void Tier::loadFromFile()
 
     ratings.clear();
     rankings = decltype(rankings)();
+    decayEpochs.clear();
+
+    QString path = "serverdb/tier_" + name();
+
+    if (!QFile::exists(path + ".dat") && QFile::exists(path + ".txt")) {
+        importTextLadder(path + ".txt", path + ".dat");
+    }
 
-    delete in;
-    in = new QFile("serverdb/tier_" + name() + ".txt");
-    in->open(QIODevice::ReadOnly);
+    if (!ladder.open(path + ".dat")) {
+        Server::print(QString("Can't open the ladder of tier %1: %2").arg(name(), ladder.errorString()));
+        return;
+    }
 
-    QStringList members = QString::fromUtf8(in->readAll()).split('\n');
+    int now = time(nullptr);
+
+    /* One pass over the records, in file order */
+    for (int i = 0; i < ladder.records(); i++) {
+        MemberRating m;
+
+        if (!ladder.read(i, m)) {
+            continue;
+        }
+        if (!SecurityManager::exist(m.name) || ratings.find(m.name) != ratings.end()) {
+            ladder.remove(i);
+            continue;
+        }
+
+        /* Only in memory, the record has all that's needed to get there again */
+        m.calculateDisplayedRating();
+        m.node = rankings.insert(m.displayed_rating, m.name);
+
+        MemberRating &inserted = ratings[m.name];
+        inserted = m;
+        scheduleDecay(inserted, now);
+    }
+}
+
+void Tier::importTextLadder(const QString &path, const QString &ladderPath)
+{
+    QFile in(path);
+    in.open(QIODevice::ReadOnly);
+
+    /* Converted in a file of its own, which only takes the place of the ladder once complete.
+       If the server goes down meanwhile, the conversion starts over next time */
+    QString importPath = ladderPath + ".import";
+    QFile::remove(importPath);
+
+    if (!ladder.open(importPath)) {
+        Server::print(QString("Can't convert the ladder of tier %1: %2").arg(name(), ladder.errorString()));
+        return;
+    }
+
+    Server::print(QString("Converting ladder file %1 for tier %2").arg(path, name()));
+
+    QStringList members = QString::fromUtf8(in.readAll()).split('\n');
 
     foreach(QString member, members) {
         QStringList mmr = member.split('%');
@@ -278,23 +361,16 @@ void Tier::loadFromFile()
             m.winCount = mmr[6].toInt();
         }
 
-        m.node = rankings.insert(m.displayed_rating, m.name);
-        ratings[m.name] = m;
+        if (!ladder.write(m)) {
+            Server::print(ladder.errorString());
+        }
     }
 
-    in->close();
-    in->open(QIODevice::WriteOnly);
-
-    int pos = 0;
+    ladder.close();
 
-    for (auto it = ratings.begin(); it != ratings.end(); ++it) {
-        it->second.filePos = pos;
-        in->write(it->second.toString().toUtf8());
-        pos = in->pos();
+    if (!QFile::rename(importPath, ladderPath)) {
+        Server::print(QString("Can't move the converted ladder of tier %1 to %2").arg(name(), ladderPath));
     }
-    lastFilePos = pos;
-    in->close();
-    in->open(QIODevice::ReadWrite);
 }
 
 int Tier::count()
@@ -338,140 +414,35 @@ void Tier::addBanParent(Tier *t)
     parent = t;
 }
 
-QString Tier::bannedReason(const PokeBattle &p, bool child) const {
-    QString errorList = "";
-    if (banPokes) {
-        if (bannedPokes.contains(PokemonInfo::NonAestheticForme(p.num()))) {
-            errorList += QString("Pokemon %1 is banned, ").arg(PokemonInfo::Name(p.num()));
-        }
-        if (bannedMoves.size() > 0) {
-            for(int i = 0; i < 4; i++) {
-                if(bannedMoves.contains(p.move(i).num())) {
-                    errorList += QString("Move %1 is banned, ").arg(MoveInfo::Name(p.move(i).num()));
-                }
-            }
-        }
-        if (bannedItems.contains(p.item())) {
-            errorList += QString("Item %1 is banned, ").arg(ItemInfo::Name(p.item()));
-        }
-        if (bannedAbilities.contains(p.ability())) {
-            errorList += QString("Ability %1 is banned, ").arg(AbilityInfo::Name(p.ability()));
-        }
-    } else {
-        if (bannedPokes.size() > 0 && !bannedPokes.contains(PokemonInfo::NonAestheticForme(p.num()))) {
-            errorList += QString("Pokemon %1 is banned, ").arg(PokemonInfo::Name(p.num()));
-        }
-        if (bannedMoves.size() > 0) {
-            for(int i = 0; i < 4; i++) {
-                if(p.move(i).num() != 0 && !bannedMoves.contains(p.move(i).num())) {
-                    errorList += QString("Move %1 is banned, ").arg(MoveInfo::Name(p.move(i).num()));
-                }
-            }
-        }
-        if (bannedItems.size() > 0 && p.item() != 0 && !bannedItems.contains(p.item())) {
-            errorList += QString("Item %1 is banned, ").arg(ItemInfo::Name(p.item()));
+void Tier::compileBans()
+{
+    bans.clear();
+
+    for (const Tier *t = this; t != NULL; t = t->parent) {
+        bans.addTier(t->banPokes, t->bannedPokes, t->bannedMoves, t->bannedItems, t->bannedAbilities);
+
+        if (t->allowIllegal != "true") {
+            bans.banIllegal();
         }
-        if (bannedAbilities.size() > 0 && p.ability() != 0 && !bannedAbilities.contains(p.ability())) {
-            errorList += QString("Ability %1 is banned, ").arg(AbilityInfo::Name(p.ability()));
+        if (t->minGen > 0) {
+            bans.checkMovesets(t->m_gen, t->minGen);
         }
     }
-    if (allowIllegal != "true" && p.illegal()) {
-        errorList += QString("Pokemon %1 has an illegal set, ").arg(PokemonInfo::Name(p.num()));
-    }
-    if (parent) {
-        errorList += parent->bannedReason(p, true);
-    }
-    if (errorList.length() >= 2 && !child) {
-        QStringList errors = errorList.split(", ").toSet().toList(); //remove duplicates
-        QMutableListIterator<QString> i(errors);
-        while (i.hasNext()) {
-            if (i.next().isEmpty()) {
-                i.remove();
-            }
-        }
-        errorList = errors.join(", ") + ".";
-    }
-    return errorList;
+
+    bans.setRestricted(restrictedPokes);
+}
+
+QString Tier::bannedReason(const PokeBattle &p) const {
+    return bans.bannedReason(p);
 }
 
 bool Tier::isBanned(const PokeBattle &p) const {
-    if (banPokes) {
-        if (bannedPokes.contains(PokemonInfo::NonAestheticForme(p.num())))
-            return true;
-        if (bannedMoves.size() > 0) {
-            for (int i = 0; i < 4; i++) {
-                if (bannedMoves.contains(p.move(i).num())) {
-                    return true;
-                }
-            }
-        }
-        if (bannedItems.contains(p.item())) {
-            return true;
-        }
-        if (bannedAbilities.contains(p.ability())) {
-           return true;
-        }
-        //        if (bannedSets.contains(p.num())) {
-        //            foreach (BannedPoke b, bannedSets.values(p.num())) {
-        //                if (b.isBanned(p))
-        //                    return true;
-        //            }
-        //        }
-    } else {
-        /* The mode is the "restrict" mode, so instead we force the pokemons to have
-           some characteristics */
-        if (bannedPokes.size() > 0 && !bannedPokes.contains(PokemonInfo::NonAestheticForme(p.num())))
-            return true;
-        if (bannedMoves.size() > 0) {
-            for (int i = 0; i < 4; i++) {
-                if (p.move(i).num() != 0 && !bannedMoves.contains(p.move(i).num())) {
-                    return true;
-                }
-            }
-        }
-        if (bannedItems.size() > 0 && p.item() != 0 && !bannedItems.contains(p.item())) {
-            return true;
-        }
-        if (bannedAbilities.size() > 0 && p.ability() != 0 && !bannedAbilities.contains(p.ability())) {
-            return true;
-        }
-        //        if (bannedSets.size() > 0 && bannedSets.contains(p.num())) {
-        //            foreach (BannedPoke b, bannedSets.values(p.num())) {
-        //                if (b.isForcedMatch(p))
-        //                    goto afterloop;
-        //            }
-        //            return true;
-        //            afterloop:;
-        //        }
-    }
-    if(minGen > 0) {
-        if(!MoveSetChecker::isValid(p.num(), m_gen, p.move(0).num(), p.move(1).num(), p.move(2).num(), p.move(3).num(), p.ability(), p.gender(), p.level(), false, NULL, NULL, minGen)) {
-            return true;
-        }
-    }
-    if (allowIllegal != "true" && p.illegal()) {
-        return true;
-    }
-    if (parent) {
-        return parent->isBanned(p);
-    } else {
-        return false;
-    }
+    return bans.isBanned(p);
 }
 
 bool Tier::isRestricted(const PokeBattle &p) const
 {
-    if (restrictedPokes.contains(PokemonInfo::NonAestheticForme(p.num())))
-        return true;
-
-    //    if (restrictedSets.contains(p.num())) {
-    //        foreach (BannedPoke set, restrictedSets) {
-    //            if (set.isBanned(p))
-    //                return true;
-    //        }
-    //    }
-
-    return false;
+    return bans.isRestricted(p);
 }
 
 bool Tier::exists(const QString &name)
@@ -488,6 +459,11 @@ bool Tier::exists(const QString &name)
 
 int Tier::ranking(const QString &name)
 {
+    /* Before looking the member up, decaying may remove it */
+    if (!isSql()) {
+        decayRankings();
+    }
+
     if (!exists(name))
         return -1;
 
@@ -562,11 +538,13 @@ void Tier::changeRating(const QString &player, int newRating)
     if (isSql()) {
         MemberRating m = member(player);
         m.rating = newRating;
+        m.calculateDisplayedRating();
         updateMember(m);
 
         return;
     }
     ratings[player].rating = newRating;
+    ratings[player].calculateDisplayedRating();
     updateMember(ratings[player]);
 }
 
@@ -607,15 +585,16 @@ int Tier::rating(const QString &name)
 {
     if (!holder.isInMemory(name))
         loadMemberInMemory(name);
-    if (exists(name)) {
-        if (isSql()) {
-            return holder.member(name).displayed_rating;
-        } else {
-            return ratings[name].displayed_rating;
-        }
-    } else {
-        return 1000;
+
+    if (isSql()) {
+        return exists(name) ? holder.member(name).displayed_rating : 1000;
     }
+
+    /* Before looking the member up, decaying may remove it */
+    decayRankings();
+
+    auto it = ratings.find(name);
+    return it == ratings.end() ? 1000 : it->second.displayed_rating;
 }
 
 int Tier::inner_rating(const QString &name)
@@ -822,6 +801,8 @@ void Tier::processQuery(QSqlQuery *q, const QVariant &name, int type, WaitingObj
             return;
         }
 
+        decayRankings();
+
         RankingTree<QString>::iterator it = rankings.getByRanking(startingRank);
 
         int i = 0;
@@ -843,12 +824,18 @@ void Tier::insertMember(QSqlQuery *q, void *data, int update)
     MemberRating &m = *(MemberRating*) data;
 
     if (isSql()) {
+        QString statement;
         if (update)
-            q->prepare(QString("update %1 set matches=:matches, rating=:rating, displayed_rating=:displayed_rating, last_check_time=:last_check_time,"
-                               "bonus_time=:bonus_time, winCount=:winCount where name=:name").arg(sql_table));
+            statement = QString("update %1 set matches=:matches, rating=:rating, displayed_rating=:displayed_rating, last_check_time=:last_check_time,"
+                               "bonus_time=:bonus_time, winCount=:winCount where name=:name").arg(sql_table);
         else
-            q->prepare(QString("insert into %1(name, matches, rating, displayed_rating, last_check_time, bonus_time, winCount)"
-                               "values(:name, :matches, :rating, :displayed_rating, :last_check_time, :bonus_time, :winCount)").arg(sql_table));
+            statement = QString("insert into %1(name, matches, rating, displayed_rating, last_check_time, bonus_time, winCount)"
+                               "values(:name, :matches, :rating, :displayed_rating, :last_check_time, :bonus_time, :winCount)").arg(sql_table);
+
+        /* The query is kept prepared between writes of the same kind */
+        if (q->lastQuery() != statement) {
+            q->prepare(statement);
+        }
 
         q->bindValue(":name", m.name.toLower());
         q->bindValue(":matches", m.matches);
@@ -864,26 +851,100 @@ void Tier::insertMember(QSqlQuery *q, void *data, int update)
         return;
     }
 
+    /* Ranked by displayed rating, like when loading */
     if (update) {
         MemberRating oldm = ratings.at(m.name);
         m.filePos = oldm.filePos;
         m.node = oldm.node;
+        m.decayEpoch = oldm.decayEpoch;
 
-        in->seek(m.filePos);
-        in->write(m.toString().toUtf8());
+        ladder.write(m);
 
-        ratings[m.name] = m;
-        ratings[m.name].node = rankings.changeKey(m.node.node(), m.rating);
+        MemberRating &updated = ratings[m.name];
+        updated = m;
+        updated.node = rankings.changeKey(m.node.node(), m.displayed_rating);
+        scheduleDecay(updated, time(nullptr));
     } else {
-        m.filePos = lastFilePos;
-        m.node = rankings.insert(m.rating, m.name);
-        in->seek(lastFilePos);
-        in->write(m.toString().toUtf8());
-        lastFilePos = in->pos();
-        ratings[m.name] = m;
+        m.filePos = -1;
+        m.decayEpoch = -1;
+        m.node = rankings.insert(m.displayed_rating, m.name);
+        if (!ladder.write(m)) {
+            Server::print(QString("Can't save %1 in the ladder of tier %2: %3").arg(m.name, name(), ladder.errorString()));
+        }
+
+        MemberRating &inserted = ratings[m.name];
+        inserted = m;
+        scheduleDecay(inserted, time(nullptr));
     }
 }
 
+void Tier::scheduleDecay(MemberRating &m, int now)
+{
+    /* Rounded up, so that every member of a bucket past now has changed */
+    int epoch = (qint64(m.nextDecay(now)) + DecayBucket - 1) / DecayBucket;
+
+    if (epoch == m.decayEpoch) {
+        return;
+    }
+
+    unscheduleDecay(m);
+    decayEpochs[epoch].insert(m.name);
+    m.decayEpoch = epoch;
+}
+
+void Tier::unscheduleDecay(MemberRating &m)
+{
+    if (m.decayEpoch == -1) {
+        return;
+    }
+
+    auto it = decayEpochs.find(m.decayEpoch);
+    if (it != decayEpochs.end()) {
+        it->remove(m.name);
+        if (it->empty()) {
+            decayEpochs.erase(it);
+        }
+    }
+    m.decayEpoch = -1;
+}
+
+int Tier::decayRankings(int now)
+{
+    int removed = 0;
+
+    while (!decayEpochs.empty() && qint64(decayEpochs.firstKey()) * DecayBucket <= now) {
+        QSet<QString> names = decayEpochs.take(decayEpochs.firstKey());
+
+        foreach(const QString &name, names) {
+            auto it = ratings.find(name);
+            if (it == ratings.end()) {
+                continue;
+            }
+
+            MemberRating &m = it->second;
+            m.decayEpoch = -1;
+
+            if (m.expired(now)) {
+                ladder.remove(m.filePos);
+                rankings.deleteNode(m.node.node());
+                ratings.erase(it);
+                removed += 1;
+                continue;
+            }
+
+            int displayed = m.displayedRating(now);
+            if (displayed != m.displayed_rating) {
+                m.displayed_rating = displayed;
+                m.node = rankings.changeKey(m.node.node(), displayed);
+            }
+
+            scheduleDecay(m, now);
+        }
+    }
+
+    return removed;
+}
+
 void Tier::updateMember(MemberRating &m, bool add)
 {
     holder.addMemberInMemory(m);
@@ -997,9 +1058,9 @@ void Tier::resetLadder()
     }
     ratings.clear();
     rankings = decltype(rankings)();
+    decayEpochs.clear();
 
-    in->remove();
-    in->open(QIODevice::ReadWrite);
+    ladder.clear();
 }
 
 void Tier::clearCache()
@@ -1299,7 +1360,6 @@ void Tier::importRestrictedPokes(const QString &s)
 Tier::Tier(TierMachine *boss, TierCategory *cat) : boss(boss), node(cat), holder(1000) {
     m_count = -1;
     last_count_time = 0;
-    in = nullptr;
     banPokes = true;
     parent = nullptr;
     m_gen = Pokemon::gen(GenInfo::GenMax(), GenInfo::NumberOfSubgens(GenInfo::GenMax())-1);
@@ -1316,7 +1376,6 @@ Tier::Tier(TierMachine *boss, TierCategory *cat) : boss(boss), node(cat), holder
 
 Tier::~Tier()
 {
-    delete in, in = nullptr;
     qDebug() << "Deleting tier " << name();
 }
 
@@ -1386,109 +1445,82 @@ Tier *Tier::dataClone() const
 
     t.m_name = m_name;
 
+    t.compileBans();
+
     return ret;
 }
 
-void Tier::processDailyRun()
+int Tier::processDailyRun(QSqlQuery &q, const QString &table, int now)
 {
-    if (isSql()) {
-        QSqlQuery query;
-
-        query.setForwardOnly(true);
-
-        Server::print(QString("Running Daily Run for tier %1").arg(name()));
-
-        clock_t t = clock();
-
-        QSqlDatabase::database().transaction();
-
-        query.prepare(QString("select name, matches, rating, displayed_rating, last_check_time, bonus_time, winCount from %1").arg(sql_table));
-        query.exec();
-
-        QStringList names;
-
-        while (query.next()) {
-            QString name = query.value(0).toString();
-            names.push_back(name);
-            if (!holder.isInMemory(name)) {
-                MemberRating m(query.value(0).toString(), query.value(1).toInt(), query.value(2).toInt(), query.value(3).toInt(),
-                               query.value(4).toInt(), query.value(5).toInt());
-                m.calculateDisplayedRating();
-                holder.addMemberInMemory(m);
-            } else {
-                MemberRating m = holder.member(name);
-                m.calculateDisplayedRating();
-                holder.addMemberInMemory(m);
-            }
-        }
-
-        query.finish();
-
-        foreach(QString name, names) {
-            MemberRating m = holder.member(name);
-            insertMember(&query, &m, true);
-        }
-
-        /* After updating all, deleting the old members */
-        int min_bonus_time = -TierMachine::obj()->alt_expiration * 3600 * 24 * 30;
-        query.prepare(QString("select name from %1 where bonus_time<%2").arg(sql_table).arg(min_bonus_time));
-        query.exec();
+    const TierMachine *tm = TierMachine::obj();
+    const int period = tm->hours_per_period * 3600;
+    /* Integer division truncating towards 0 like in C++, MySQL's "/" gives decimals */
+    const QString div = SQLCreator::databaseType == SQLCreator::MySQL ? " div " : " / ";
+
+    auto least = [](const QString &a, int b) {
+        return QString("(case when %1 > %2 then %2 else %1 end)").arg(a).arg(b);
+    };
+
+    QString bonus = least(QString("(bonus_time - (%1 - last_check_time))").arg(now), tm->max_saved_periods * period);
+    QString percent = least("((-" + bonus + ")" + div + QString::number(period) + " * " + QString::number(tm->percent_per_period) + ")",
+                            tm->max_percent_decay);
+
+    /* MySQL uses the new values of the columns already set in the statement, so the displayed
+       rating comes first and the check time last */
+    q.prepare("update " + table + " set displayed_rating = (case when " + bonus + " > 0 then rating else 1000 + (rating - 1000) * (100 - "
+              + percent + ")" + div + "100 end), bonus_time = " + bonus + ", last_check_time = " + QString::number(now));
+
+    if (!q.exec()) {
+        qDebug() << "Daily run of" << table << "failed:" << q.lastError().text();
+        return -1;
+    }
 
-        int count = 0;
+    /* After updating all, deleting the old members */
+    int min_bonus_time = -tm->alt_expiration * 3600 * 24 * 30;
+    q.prepare(QString("delete from %1 where bonus_time<%2").arg(table).arg(min_bonus_time));
 
-        while (query.next()) {
-            holder.removeMemberInMemory(query.value(0).toString());
-            count ++;
-        }
-        Server::print(QString("%1 alts removed from the ladder.").arg(count));
+    if (!q.exec()) {
+        qDebug() << "Removing the alts of" << table << "failed:" << q.lastError().text();
+        return -1;
+    }
 
-        query.prepare(QString("delete from %1 where bonus_time<%2").arg(sql_table).arg(min_bonus_time));
-        query.exec();
+    int count = q.numRowsAffected();
+    q.finish();
 
-        holder.cleanCache();
+    return count;
+}
 
-        QSqlDatabase::database().commit();
+void Tier::afterDailyRun(int removed)
+{
+    int min_bonus_time = -TierMachine::obj()->alt_expiration * 3600 * 24 * 30;
 
-        t = clock() - t;
+    holder.updateMembers([min_bonus_time](MemberRating &m) {
+        m.calculateDisplayedRating();
+        return m.bonus_time >= min_bonus_time;
+    });
 
-        Server::print(QString::number(float(t)/CLOCKS_PER_SEC) + " secs");
-        Server::print(query.lastError().text());
+    /* The count changed */
+    m_count = -1;
 
-        return;
+    if (removed >= 0) {
+        Server::print(QString("%1 alts removed from the ladder of tier %2.").arg(removed).arg(name()));
     }
+}
 
+void Tier::processDailyRun()
+{
     Server::print(QString("Running Daily Run for tier %1").arg(name()));
 
     clock_t t = clock();
 
-    int count = 0;
-    int min_bonus_time = -TierMachine::obj()->alt_expiration * 3600 * 24 * 30;
-
-    for (auto it = ratings.begin(); it != ratings.end(); ) {
-        auto &m = it->second;
+    /* Only the members whose displayed rating changed are touched, the rest is
+       already up to date */
+    int count = decayRankings();
 
-        if (m.bonus_time < min_bonus_time) {
-            m.name[0] = ':';
-
-            in->seek(m.filePos);
-            in->write(m.toString().toUtf8());
-
-            it = ratings.erase(it);
-        } else {
-            m.calculateDisplayedRating();
-
-            in->seek(m.filePos);
-            in->write(m.toString().toUtf8());
-
-            ++it;
-        }
-    }
+    ladder.sync();
 
     Server::print(QString("%1 alts removed from the ladder.").arg(count));
 
-    /* Regenerate rankings & all */
-    loadFromFile();
-
     t = clock() - t;
 
     Server::print(QString::number(float(t)/CLOCKS_PER_SEC) + " secs");
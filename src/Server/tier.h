@@ -12,6 +12,8 @@
 
 #include "memoryholder.h"
 #include "tiernode.h"
+#include "ladderfile.h"
+#include "banfilter.h"
 
 class TierMachine;
 class TierCategory;
@@ -35,12 +37,15 @@ struct MemberRating
     int bonus_time;
     int winCount;
 
+    /* Record in the ladder file, -1 if not written yet */
     int filePos;
     RankingTree<QString>::iterator node;
+    /* Bucket of the next change of the displayed rating (see Tier::decayRankings), -1 if none */
+    int decayEpoch;
 
     MemberRating(const QString &name="", int matches=0, int rating=1000, int displayed_rating = 1000,
                  int last_check_time = -1, int bonus_time = 0, int winCount = 0) : name(name), matches(matches), rating(rating),
-                   displayed_rating(displayed_rating), bonus_time(bonus_time), winCount(winCount) {
+                   displayed_rating(displayed_rating), bonus_time(bonus_time), winCount(winCount), filePos(-1), decayEpoch(-1) {
         if (last_check_time == -1) {
             this->last_check_time = time(nullptr);
         } else {
@@ -51,6 +56,12 @@ struct MemberRating
     QString toString() const;
     void changeRating(int other, bool win);
     void calculateDisplayedRating();
+    /* The displayed rating calculateDisplayedRating() would give at that time, without changing
+       anything. The bonus time must be within its maximum, as it is after calculateDisplayedRating() */
+    int displayedRating(int now) const;
+    /* When the displayed rating changes next after that time, or when the member becomes an alt to remove */
+    int nextDecay(int now) const;
+    bool expired(int now) const;
     QPair<int, int> pointChangeEstimate(int otherRating);
 };
 
@@ -100,9 +111,11 @@ public:
     QPair<int, int> pointChangeEstimate(const QString &player, const QString &foe);
 
     void addBanParent(Tier *t);
+    /* Flattens the bans of the tier and its ban parents, to do once the parents are set */
+    void compileBans();
 
     bool isBanned(const PokeBattle &p) const;
-    QString bannedReason(const PokeBattle &p, bool child = false) const;
+    QString bannedReason(const PokeBattle &p) const;
     bool isRestricted(const PokeBattle &p) const;
     bool isValid(const TeamBattle &t) const;
     bool exists(const QString &name);
@@ -139,7 +152,15 @@ public:
     void importBannedAbilities(const QString &);
 
     void exportDatabase() const;
+    /* Without SQL, the daily run of the tier. With SQL, see the ones below */
     void processDailyRun();
+    /* The same as calculateDisplayedRating() and the removal of expired alts for all the members
+       of an SQL ladder, done by the database in two statements. Can be called from any thread with
+       a query on a connection of this thread. Returns the number of members removed, -1 on error */
+    static int processDailyRun(QSqlQuery &q, const QString &table, int now);
+    /* Updates the members in memory once the database is done with the daily run */
+    void afterDailyRun(int removed);
+    QString sqlTable() const { return sql_table; }
     /* Removes all ranking */
     void resetLadder();
     /* Clears the cache, forces synchronization with SQL database */
@@ -183,6 +204,8 @@ protected:
     void insertMember(QSqlQuery *q, void *data, int type);
 
     void loadSqlFromFile();
+    /* Converts a ladder from the old text format into the ladder file at ladderPath */
+    void importTextLadder(const QString &path, const QString &ladderPath);
 
 private:
     TierMachine *boss;
@@ -202,6 +225,7 @@ private:
     QSet<int> bannedAbilities;
     QSet<Pokemon::uniqueId> bannedPokes;
     QSet<Pokemon::uniqueId> restrictedPokes;
+    BanFilter bans;
     int mode; /* < 0 : any, otherwise specific mode */
     quint32 clauses;
 
@@ -211,7 +235,7 @@ private:
 
     int m_id;
 
-    QFile *in;
+    LadderFile ladder;
 
     mutable MemoryHolder<MemberRating> holder;
 
@@ -221,7 +245,19 @@ private:
 
     istringmap<MemberRating> ratings;
     RankingTree<QString> rankings;
-    int lastFilePos;
+
+    /* Without SQL the displayed ratings decay lazily: members are put in buckets of DecayBucket seconds
+       by the time their displayed rating changes next (MemberRating::nextDecay), and only the members
+       of the buckets that are past get updated, in the rankings too. The ladder file keeps the values
+       the displayed rating is calculated from, so nothing is written then */
+    enum { DecayBucket = 3600 };
+    QMap<int, QSet<QString> > decayEpochs;
+
+    void scheduleDecay(MemberRating &m, int now);
+    void unscheduleDecay(MemberRating &m);
+    /* Updates the members whose displayed rating changed since, removing the expired ones.
+       Returns the number of members removed */
+    int decayRankings(int now = time(nullptr));
 };
 
 #endif // TIER_H
@@ -1,3 +1,4 @@
+#include <ctime>
 #include <PokemonInfo/battlestructs.h>
 
 #include "waitingobject.h"
@@ -30,6 +31,7 @@ TierMachine::TierMachine()
 
     connect(thread , SIGNAL(processLoad (QSqlQuery*, QVariant, int, WaitingObject*)), this, SLOT(processQuery(QSqlQuery*, QVariant, int, WaitingObject *)), Qt::DirectConnection);
     connect(thread, SIGNAL(processWrite(QSqlQuery*, void*,int)), this, SLOT(insertMember(QSqlQuery*, void*,int)), Qt::DirectConnection);
+    connect(thread, SIGNAL(processDailyRun(QSqlQuery*)), this, SLOT(dailyRunEx(QSqlQuery*)), Qt::DirectConnection);
 
     thread->start();
 
@@ -167,6 +169,11 @@ void TierMachine::fromString(const QString &s)
         }
     }
 
+    /* Once all the parents are known */
+    foreach(Tier *t, tiers) {
+        t->compileBans();
+    }
+
     /* Then, we open the files and load the ladders for each tier and people */
     for (int i =0; i < tiers.size(); i++) {
         tiers[i]->changeId(i);
@@ -257,11 +264,11 @@ void TierMachine::tierValidation(PokeBattle &pok, const QString &name) const
             pok.forceMatchHiddenPowerIV();
         }
     } else {
-        Tier *t = this->tier(name).dataClone();
+        const Tier &t = this->tier(name);
 
-        if (t->gen() >= 7) {
+        if (t.gen() >= 7) {
             //change ivs to match hp instead for android friendliness
-            if (t->maxLevel == 5 || pok.level() < t->maxLevel) {
+            if (t.maxLevel == 5 || pok.level() < t.maxLevel) {
                 pok.forceMatchHiddenPowerIV();
             }
         }
@@ -340,6 +347,11 @@ LoadInsertThread<MemberRating> *TierMachine::getThread()
     return thread;
 }
 
+QString TierMachine::writeStats()
+{
+    return thread->writeStats();
+}
+
 void TierMachine::exportDatabase() const
 {
     for(int i = 0; i < m_tiers.size(); i++) {
@@ -355,7 +367,111 @@ TierTree *TierMachine::getDataTree() const
 
 void TierMachine::processDailyRun()
 {
+    if (isSql()) {
+        Server::print("Running Daily Run for the tiers");
+
+        QStringList tables;
+        for(int i = 0; i < m_tiers.size(); i++) {
+            tables.push_back(m_tiers[i]->sqlTable());
+        }
+
+        {
+            QMutexLocker l(&dailyRunMutex);
+            dailyRunTables = tables;
+        }
+
+        dailyRunClock.start();
+        thread->addDailyRun();
+        return;
+    }
+
     for(int i = 0; i < m_tiers.size(); i++) {
         m_tiers[i]->processDailyRun();
     }
+
+    emit dailyRunFinished();
+}
+
+/* The daily run of a tier on its own connection to the database */
+class DailyRunTask : public QRunnable
+{
+public:
+    DailyRunTask(const QString &table, int now, QHash<QString, int> *removed, QMutex *mutex)
+        : table(table), now(now), removed(removed), mutex(mutex) {
+    }
+
+    void run() {
+        QString dbname = "dailyrun_" + table;
+        int count;
+
+        SQLCreator::createSQLConnection(dbname);
+        {
+            QSqlDatabase db = QSqlDatabase::database(dbname);
+            QSqlQuery q(db);
+            q.setForwardOnly(true);
+
+            count = Tier::processDailyRun(q, table, now);
+        }
+        QSqlDatabase::removeDatabase(dbname);
+
+        QMutexLocker l(mutex);
+        removed->insert(table, count);
+    }
+private:
+    QString table;
+    int now;
+    QHash<QString, int> *removed;
+    QMutex *mutex;
+};
+
+void TierMachine::dailyRunEx(QSqlQuery *q)
+{
+    QStringList tables;
+    {
+        QMutexLocker l(&dailyRunMutex);
+        tables = dailyRunTables;
+    }
+
+    int now = time(NULL);
+    QHash<QString, int> removed;
+
+    if (SQLCreator::databaseType == SQLCreator::SQLite) {
+        /* Writes to an SQLite database are one at a time anyway */
+        foreach(const QString &table, tables) {
+            removed.insert(table, Tier::processDailyRun(*q, table, now));
+        }
+    } else {
+        QThreadPool pool;
+        QMutex mutex;
+
+        pool.setMaxThreadCount(std::min(std::max(QThread::idealThreadCount(), 1), 4));
+        foreach(const QString &table, tables) {
+            pool.start(new DailyRunTask(table, now, &removed, &mutex));
+        }
+        pool.waitForDone();
+    }
+
+    {
+        QMutexLocker l(&dailyRunMutex);
+        dailyRunRemoved = removed;
+    }
+
+    QMetaObject::invokeMethod(this, "afterDailyRun", Qt::QueuedConnection);
+}
+
+void TierMachine::afterDailyRun()
+{
+    QHash<QString, int> removed;
+    {
+        QMutexLocker l(&dailyRunMutex);
+        removed.swap(dailyRunRemoved);
+    }
+
+    for(int i = 0; i < m_tiers.size(); i++) {
+        m_tiers[i]->afterDailyRun(removed.value(m_tiers[i]->sqlTable(), -1));
+    }
+
+    Server::print(QString("Daily Run of the tiers done in %1 secs").arg(dailyRunClock.elapsed() / 1000.));
+
+    emit dailyRunFinished();
 }
@@ -57,6 +57,8 @@ public:
     int inner_rating(const QString &name, const QString &tier);
     int ranking(const QString &name, const QString &tier);
     int count (const QString &tier);
+    /* State of the queue of writes to the database */
+    QString writeStats();
     void changeRating(const QString &winner, const QString &loser, const QString &tier);
     void changeRating(const QString &winner, const QString &tier, int newRating);
 
@@ -75,13 +77,26 @@ public:
     int max_percent_decay;
 signals:
     void tiersChanged();
+    /* The daily run is over, the ratings are updated */
+    void dailyRunFinished();
 public slots:
     void processQuery(QSqlQuery *q, const QVariant &,int,WaitingObject*);
     void insertMember(QSqlQuery *q,void *,int);
     /* Processes the daily run in which ratings are updated.
-       Be aware that it may take long. I may thread it in the future. */
+       With SQL, the database does it in the thread of the writes, after the writes already queued,
+       with the tiers done in parallel when it's not SQLite. */
     void processDailyRun();
+private slots:
+    /* In the thread of the writes */
+    void dailyRunEx(QSqlQuery *q);
+    void afterDailyRun();
 private:
+    /* Tables for the daily run to process, and how many members were removed from each */
+    QStringList dailyRunTables;
+    QHash<QString, int> dailyRunRemoved;
+    QMutex dailyRunMutex;
+    QElapsedTimer dailyRunClock;
+
     QList<Tier*> m_tiers;
     QHash<QString, Tier*> m_tierByNames;
     QStringList m_tierNames;
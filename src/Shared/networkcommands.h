@@ -74,7 +74,9 @@ enum Command {
     SpecialPass,
     ServerListEnd,              // Indicates end of transmission for registry.
     SetIP,                      // Indicates that a proxy server sends the real ip of client
-    ServerPass                 // Prompts for the server password
+    ServerPass,                // Prompts for the server password
+    BattleBroadcast,           // Battle server -> server only: battle message for the players and the spectators of a battle
+    ChannelDelta               // Joins, leaves, option changes and logouts in a channel, batched for the clients supporting it
 };
 
 enum ProtocolError {
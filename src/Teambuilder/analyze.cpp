@@ -72,12 +72,16 @@ void Analyzer::login(const TeamHolder &team, bool ladder, bool away, const QColo
     data.setFlag(PlayerFlags::Idle, away);
     data.setFlag(PlayerFlags::HasRegisterCheck, true);
     data.setFlag(PlayerFlags::WantsHTML, true);
+    data.setFlag(PlayerFlags::SupportsZipStream, true);
+    data.setFlag(PlayerFlags::SupportsChannelDeltas, true);
     //                  SupportsZipCompression,
     //                  LadderEnabled,
     //                  IdsWithMessage,
     //                  Idle,
     //                  HasRegisterCheck,
-    //                  WantsHTML
+    //                  WantsHTML,
+    //                  SupportsZipStream,
+    //                  SupportsChannelDeltas
 
     out << uchar(Login) << ownVersion << network;
 
@@ -269,6 +273,8 @@ void Analyzer::wasConnected()
 {
     /* At least makes client use full bandwith, even if the server doesn't */
     socket().setLowDelay(true);
+    /* New connection, new stream */
+    inflater.reset();
 }
 
 /*{
@@ -278,6 +284,16 @@ void Analyzer::wasConnected()
     break;
 }*/
 
+void Analyzer::channelMemberCommand(int command, int chanid, qint32 id)
+{
+    QByteArray data;
+    DataStream out(&data, QIODevice::WriteOnly, version.version);
+    out << id;
+
+    DataStream in(data, version.version);
+    emit channelCommandReceived(command, chanid, &in);
+}
+
 void Analyzer::commandReceived(const QByteArray &commandline)
 {
     DataStream in (commandline, version.version);
@@ -305,7 +321,7 @@ void Analyzer::commandReceived(const QByteArray &commandline)
 
         in >> contentType;
 
-        if (contentType > 1) {
+        if (contentType > 2) {
             return;
         }
 
@@ -314,11 +330,26 @@ void Analyzer::commandReceived(const QByteArray &commandline)
         if (length <= 0) {
             return;
         }
-        char data[length];
 
-        in.readRawData(data, length);
+        QByteArray info;
+
+        if (contentType == 2) {
+            /* Chunk of the deflate stream of the connection, holding several commands like contentType 1 */
+            if (!inflater) {
+                inflater.reset(new ZipInflater(zipStreamDictionary()));
+            }
+            if (!inflater->decompress(commandline.mid(2), info)) {
+                emit connectionError(0, tr("Error decompressing the data sent by the server."));
+                return;
+            }
+            contentType = 1;
+        } else {
+            char data[length];
 
-        QByteArray info = qUncompress((uchar*)data, length);
+            in.readRawData(data, length);
+
+            info = qUncompress((uchar*)data, length);
+        }
 
         if (contentType == 0) {
             if (info.length() == 0) {
@@ -549,6 +580,30 @@ void Analyzer::commandReceived(const QByteArray &commandline)
         emit ladderChanged(id, f[0]);
         break;
     }
+    case ChannelDelta: {
+        /* The JoinChannel, LeaveChannel, OptionsChange and Logout commands of a channel
+           gathered by the server, dealt with in the same way */
+        qint32 chanid;
+        QVector<qint32> joined, left, optionIds, loggedOut;
+        QVector<quint8> options;
+        in >> chanid >> joined >> left >> optionIds >> options >> loggedOut;
+
+        foreach(qint32 id, joined) {
+            channelMemberCommand(JoinChannel, chanid, id);
+        }
+        for (int i = 0; i < optionIds.size() && i < options.size(); i++) {
+            Flags f(options[i]);
+            emit awayChanged(optionIds[i], f[1]);
+            emit ladderChanged(optionIds[i], f[0]);
+        }
+        foreach(qint32 id, left) {
+            channelMemberCommand(LeaveChannel, chanid, id);
+        }
+        foreach(qint32 id, loggedOut) {
+            emit playerLogout(id);
+        }
+        break;
+    }
     case SpectateBattle: {
         Flags f;
         qint32 battleId;
@@ -8,6 +8,7 @@
 #include <QtCore>
 #include <Utilities/network.h>
 #include <Utilities/coreclasses.h>
+#include <Utilities/zipstream.h>
 #include <PokemonInfo/networkstructs.h>
 
 class Client;
@@ -169,6 +170,11 @@ private:
 
     QList<QByteArray> storedCommands;
     QSet<int> channelCommands;
+    /* Emits a JoinChannel / LeaveChannel of the channel for the player, as if sent alone */
+    void channelMemberCommand(int command, int chanid, qint32 id);
+
+    /* The deflate stream the server uses when it supports it, one per connection */
+    QScopedPointer<ZipInflater> inflater;
 
     network_type mysocket;
 
@@ -487,7 +487,8 @@ void Channel::dealWithCommand(int command, DataStream *stream)
     } else if (command == NetworkCli::LeaveChannel) {
         qint32 id;
         in >> id;
-        if (eventEnabled(Client::ChannelEvent) && name(id) != "~Unknown~") {
+        /* Batched leaves can be of players the channel never showed */
+        if (eventEnabled(Client::ChannelEvent) && hasPlayer(id) && name(id) != "~Unknown~") {
             printLine(tr("%1 left the channel.").arg(name(id)), false, false);
         }
         /* Remove everything... */
@@ -13,6 +13,7 @@ HEADERS += pokemonstructs.h \
     pokemoninfo.h \
     networkstructs.h \
     movesetchecker.h \
+    movebitset.h \
     battlestructs.h \
     teamsaver.h \
     enums.h \
@@ -0,0 +1,155 @@
+#ifndef MOVEBITSET_H
+#define MOVEBITSET_H
+
+#include <QtCore>
+
+/* A set of moves, one bit per move number. Used for the learnsets, where checking that
+   a pokemon learns a moveset or removing the moves learnt a way or another is done a word
+   at a time instead of hashing every move.
+
+   Moves out of range are ignored when inserted and never contained. */
+class MoveBitset
+{
+public:
+    enum {
+        Size = 1024,
+        Words = Size / 64
+    };
+
+    MoveBitset() {
+        memset(bits, 0, sizeof(bits));
+    }
+
+    explicit MoveBitset(const QSet<int> &moves) {
+        memset(bits, 0, sizeof(bits));
+        foreach(int move, moves) {
+            insert(move);
+        }
+    }
+
+    void insert(int move) {
+        if (uint(move) < uint(Size)) {
+            bits[move >> 6] |= quint64(1) << (move & 63);
+        }
+    }
+
+    void remove(int move) {
+        if (uint(move) < uint(Size)) {
+            bits[move >> 6] &= ~(quint64(1) << (move & 63));
+        }
+    }
+
+    bool contains(int move) const {
+        return uint(move) < uint(Size) && (bits[move >> 6] >> (move & 63)) & 1;
+    }
+
+    /* Whether all the moves of other are in the set */
+    bool contains(const MoveBitset &other) const {
+        for (int i = 0; i < Words; i++) {
+            if (other.bits[i] & ~bits[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool intersects(const MoveBitset &other) const {
+        for (int i = 0; i < Words; i++) {
+            if (other.bits[i] & bits[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    MoveBitset &unite(const MoveBitset &other) {
+        for (int i = 0; i < Words; i++) {
+            bits[i] |= other.bits[i];
+        }
+        return *this;
+    }
+
+    MoveBitset &subtract(const MoveBitset &other) {
+        for (int i = 0; i < Words; i++) {
+            bits[i] &= ~other.bits[i];
+        }
+        return *this;
+    }
+
+    MoveBitset &intersect(const MoveBitset &other) {
+        for (int i = 0; i < Words; i++) {
+            bits[i] &= other.bits[i];
+        }
+        return *this;
+    }
+
+    bool isEmpty() const {
+        for (int i = 0; i < Words; i++) {
+            if (bits[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int count() const {
+        int ret = 0;
+        for (int i = 0; i < Words; i++) {
+            for (quint64 w = bits[i]; w; w &= w - 1) {
+                ret += 1;
+            }
+        }
+        return ret;
+    }
+
+    /* Smallest move in the set, -1 if empty */
+    int first() const {
+        for (int i = 0; i < Words; i++) {
+            if (bits[i]) {
+                int j = 0;
+                while (!((bits[i] >> j) & 1)) {
+                    j++;
+                }
+                return i*64 + j;
+            }
+        }
+        return -1;
+    }
+
+    QSet<int> toSet() const {
+        QSet<int> ret;
+        for (int i = 0; i < Words; i++) {
+            for (int j = 0; j < 64; j++) {
+                if ((bits[i] >> j) & 1) {
+                    ret.insert(i*64 + j);
+                }
+            }
+        }
+        return ret;
+    }
+
+    /* In increasing order */
+    QList<int> toList() const {
+        QList<int> ret;
+        for (int i = 0; i < Words; i++) {
+            for (int j = 0; j < 64; j++) {
+                if ((bits[i] >> j) & 1) {
+                    ret.push_back(i*64 + j);
+                }
+            }
+        }
+        return ret;
+    }
+
+    bool operator == (const MoveBitset &other) const {
+        return memcmp(bits, other.bits, sizeof(bits)) == 0;
+    }
+
+    bool operator != (const MoveBitset &other) const {
+        return !(*this == other);
+    }
+private:
+    quint64 bits[Words];
+};
+
+#endif // MOVEBITSET_H
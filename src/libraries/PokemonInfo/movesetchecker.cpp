@@ -1,9 +1,9 @@
 #include "movesetchecker.h"
 #include "pokemoninfo.h"
 
-QHash<Pokemon::gen, QHash<Pokemon::uniqueId, QList<QSet<int > > > > MoveSetChecker::legalCombinations;
-QHash<Pokemon::gen, QHash<Pokemon::uniqueId, QList<QSet<int > > > > MoveSetChecker::eventCombinations;
-QHash<Pokemon::gen, QHash<Pokemon::uniqueId, QList<QSet<int > > > > MoveSetChecker::breedingCombinations;
+MoveSetChecker::Combinations MoveSetChecker::legalCombinations;
+MoveSetChecker::Combinations MoveSetChecker::eventCombinations;
+MoveSetChecker::Combinations MoveSetChecker::breedingCombinations;
 
 static void fill_uid_str(QHash<Pokemon::uniqueId, QString> &container, const QString &filename, bool trans = false)
 {
@@ -39,7 +39,7 @@ QString MoveSetChecker::path(const QString &arg, const Pokemon::gen & g)
     }
 }
 
-void MoveSetChecker::loadCombinations(const QString &file, Pokemon::gen gen, QHash<Pokemon::gen, QHash<Pokemon::uniqueId, QList<QSet<int> > > > &set)
+void MoveSetChecker::loadCombinations(const QString &file, Pokemon::gen gen, Combinations &set)
 {
     QHash<Pokemon::uniqueId, QString> temp;
     fill_uid_str(temp, file);
@@ -53,15 +53,15 @@ void MoveSetChecker::loadCombinations(const QString &file, Pokemon::gen gen, QHa
         /* Even if the hash is empty, it proves it's here, otherwise it would be filled by the data of
            the base forme */
         if (!legalCombinations[gen].contains(id))
-            legalCombinations[gen].insert(id, QList<QSet<int > >());
+            legalCombinations[gen].insert(id, QList<MoveBitset>());
 
-        set[gen][id] = QList<QSet<int > >();
+        set[gen][id] = QList<MoveBitset>();
 
         if (it.value().length() > 0) {
             QStringList combs = it.value().split('|');
             foreach(QString comb, combs) {
                 QStringList moves = comb.split(' ');
-                QSet<int> toPush;
+                MoveBitset toPush;
                 foreach(QString move, moves) {
                     toPush.insert(move.toInt());
                 }
@@ -102,7 +102,7 @@ void MoveSetChecker::loadGenData(const Pokemon::gen &g)
     /* Event move combinations */
     loadCombinations(path("event_combinations.txt", g), g, eventCombinations);
 
-    QHash<Pokemon::uniqueId, QList<QSet<int> > > &legal = legalCombinations[g];
+    QHash<Pokemon::uniqueId, QList<MoveBitset> > &legal = legalCombinations[g];
 
     foreach(Pokemon::uniqueId id, legal.keys()) {
         if (PokemonInfo::IsForme(id))
@@ -129,10 +129,10 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
     return isValid(pokeid, gen, moves, ability, gender, level, maledw, invalid_moves, error, minGen);
 }
 
-static QString getCombinationS(const QSet<int> &invalid_moves) {
+static QString getCombinationS(const MoveBitset &invalid_moves) {
     QString s;
     bool comma(false);
-    foreach(int move, invalid_moves) {
+    foreach(int move, invalid_moves.toList()) {
         if (comma)
             s += ", ";
         comma = true;
@@ -141,6 +141,33 @@ static QString getCombinationS(const QSet<int> &invalid_moves) {
     return s;
 }
 
+bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen, const QSet<int> &moves, int ability, int gender,
+                             int level, bool maledw, QSet<int> *invalid_moves, QString *error, int minGen)
+{
+    /* Moves that don't fit in a bitset can't be learnt by anything */
+    foreach(int move, moves) {
+        if (move < 0 || move >= MoveBitset::Size) {
+            if (invalid_moves) {
+                invalid_moves->insert(move);
+            }
+            if (error) {
+                *error = QObject::tr("%1 can't learn %2.").arg(PokemonInfo::Name(pokeid), MoveInfo::Name(move));
+            }
+            return false;
+        }
+    }
+
+    if (!invalid_moves) {
+        return checkMoves(pokeid, gen, MoveBitset(moves), ability, gender, level, maledw, NULL, error, minGen);
+    }
+
+    MoveBitset invalid(*invalid_moves);
+    bool ret = checkMoves(pokeid, gen, MoveBitset(moves), ability, gender, level, maledw, &invalid, error, minGen);
+    *invalid_moves = invalid.toSet();
+
+    return ret;
+}
+
 /**
  * How a validity check is performed.
  *
@@ -175,11 +202,11 @@ static QString getCombinationS(const QSet<int> &invalid_moves) {
  * There are many special cases in there. For example dealing with HMs, or
  * 4th gen evos with 3rd gen moves. But there should be a comment everytime for
  * those exceptions in the code below. */
-bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen, const QSet<int> &moves2, int ability, int gender,
-                             int level, bool maledw, QSet<int> *invalid_moves, QString *error, int minGen)
+bool MoveSetChecker::checkMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen gen, const MoveBitset &moves2, int ability, int gender,
+                                int level, bool maledw, MoveBitset *invalid_moves, QString *error, int minGen)
 {
     if (gen == Gen::StadiumWithTradebacks) {
-        foreach(int move, moves2) {
+        foreach(int move, moves2.toList()) {
             if (!MoveInfo::Exists(move, gen)) {
                 if (invalid_moves) {
                     invalid_moves->insert(move);
@@ -191,7 +218,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
             }
         }
 
-        return isValid(pokeid, Pokemon::gen(2,-1), moves2, ability, gender, level, maledw, invalid_moves, error);
+        return checkMoves(pokeid, Pokemon::gen(2,-1), moves2, ability, gender, level, maledw, invalid_moves, error);
     }
 
     /* Last Gen = Whole gen */
@@ -199,7 +226,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
         gen.subnum = -1;
     }
 
-    QSet<int> moves = moves2;
+    MoveBitset moves = moves2;
     moves.remove(0);
 
     bool transferWrongAbility = false;
@@ -217,10 +244,10 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
     for (Pokemon::gen g = gen; g >= limit; g = Pokemon::gen(g.num-1, -1)) {
         if (!PokemonInfo::Exists(pokeid, g)) {
             if(PokemonInfo::IsMegaEvo(pokeid) || (PokemonInfo::OriginalForme(pokeid) == Pokemon::Arceus && PokemonInfo::IsForme(pokeid))) {
-                return MoveSetChecker::isValid(PokemonInfo::OriginalForme(pokeid), g, moves, 0, gender, level, maledw,
+                return MoveSetChecker::checkMoves(PokemonInfo::OriginalForme(pokeid), g, moves, 0, gender, level, maledw,
                                                invalid_moves, error);
             } else if (PokemonInfo::HasPreEvo(pokeid.pokenum)) {
-                return MoveSetChecker::isValid(PokemonInfo::PreEvo(pokeid), g, moves, 0, gender, level, maledw,
+                return MoveSetChecker::checkMoves(PokemonInfo::PreEvo(pokeid), g, moves, 0, gender, level, maledw,
                                                invalid_moves, error);
             }
             if (invalid_moves) {
@@ -242,8 +269,11 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
             }
             return false;
         }
-        if (!PokemonInfo::Moves(pokeid, g).contains(moves)) {
-            moves.subtract(PokemonInfo::Moves(pokeid, g));
+        /* Copied, the learnsets of other gens may be loaded in the recursive calls below */
+        const PokemonMoves learnset = PokemonInfo::Learnset(pokeid, g);
+
+        if (!learnset.genMoves.contains(moves)) {
+            moves.subtract(learnset.genMoves);
             if (invalid_moves) {
                 *invalid_moves = moves;
             }
@@ -279,7 +309,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
                         return false;
                     }
                     return nobreeding == false &&
-                            isValid(PokemonInfo::PreEvo(pokeid), g, moves, 0, gender, level, false, invalid_moves, error);
+                            checkMoves(PokemonInfo::PreEvo(pokeid), g, moves, 0, gender, level, false, invalid_moves, error);
                 }
                 if(gen < 6) {
                     if (invalid_moves) {
@@ -296,7 +326,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
                     int priorHA = PokemonInfo::Abilities(pokeid, g).ab(2);
                     if(priorHA != 0 && priorHA != ability)
                     {
-                        return isValid(pokeid, g, moves, priorHA, gender, level, false, invalid_moves, error);
+                        return checkMoves(pokeid, g, moves, priorHA, gender, level, false, invalid_moves, error);
                     }
                     else {
                         if (invalid_moves) {
@@ -324,7 +354,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
             QHash<QString, QHash<QString, QList<QString> > > invalidCombinations;
             rbyInvalidCombinations(&invalidCombinations);
             if (invalidCombinations.contains(PokemonInfo::Name(pokeid))) {
-                foreach(int moveA, moves) {
+                foreach(int moveA, moves.toList()) {
                     if (invalidCombinations.value(PokemonInfo::Name(pokeid)).contains(MoveInfo::Name(moveA))) {
                         if (invalidCombinations.value(PokemonInfo::Name(pokeid)).value(MoveInfo::Name(moveA)).isEmpty()) {
                             if (invalid_moves) {
@@ -355,7 +385,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
         }
 
         /* now we know the pokemon at least knows all moves */
-        moves.subtract(PokemonInfo::RegularMoves(pokeid, g));
+        moves.subtract(learnset.regularMoves);
 
         /* Can transfer gen 1 and 2 from virtual console to gen 7 */
         if (g.num == 7)
@@ -363,9 +393,9 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
             AbilityGroup ab = PokemonInfo::Abilities(pokeid, gen);
             bool valid;
             if (g.subnum == 0) {
-                valid = isValid(pokeid, Gen::Yellow, moves, ability, gender, level, maledw, nullptr, error, minGen);
+                valid = checkMoves(pokeid, Gen::Yellow, moves, ability, gender, level, maledw, nullptr, error, minGen);
             } else {
-                valid = isValid(pokeid, Gen::Crystal, moves, ability, gender, level, maledw, nullptr, error, minGen);
+                valid = checkMoves(pokeid, Gen::Crystal, moves, ability, gender, level, maledw, nullptr, error, minGen);
                 //i dont think this adds anything since you can trade back and forth between 1 and 2
                 /*if (!valid) {
                     valid = isValid(pokeid, Gen::Yellow, moves, ability, gender, level, maledw, nullptr, error, minGen);
@@ -390,7 +420,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
         if (g.num == 2) {
             if (PokemonInfo::Exists(pokeid, 1)) {
                 bool ok = true;
-                foreach(int move, moves) {
+                foreach(int move, moves.toList()) {
                     if (!MoveInfo::Exists(move, 1)) {
                         ok = false;
                         break;
@@ -398,14 +428,14 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
                 }
 
                 if (ok) {
-                    moves.subtract(PokemonInfo::RegularMoves(pokeid, Pokemon::gen(1, Pokemon::gen::wholeGen)));
+                    moves.subtract(PokemonInfo::Learnset(pokeid, Pokemon::gen(1, Pokemon::gen::wholeGen)).regularMoves);
 
                     /* Special case: Pikachu has a pre-evo in gen 2, and egg moves
                       from it, but moves it learn from gen 1 and its pre evo can't learn
                       from gen 1 */
                     Pokemon::uniqueId preevo = PokemonInfo::PreEvo(pokeid);
                     if (preevo.pokenum != 0 &&  preevo.pokenum != pokeid.pokenum) {
-                        if (ok && isValid(preevo, g, moves))
+                        if (ok && checkMoves(preevo, g, moves))
                             return true;
                     }
                 }
@@ -414,14 +444,14 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
 
                 if (preevo.pokenum != 0 &&  preevo.pokenum != pokeid.pokenum && PokemonInfo::Exists(preevo, 1)) {
                     bool ok = true;
-                    foreach(int move, moves) {
+                    foreach(int move, moves.toList()) {
                         if (!MoveInfo::Exists(move, 1)) {
                             ok = false;
                             break;
                         }
                     }
 
-                    if (ok && isValid(preevo, g, moves))
+                    if (ok && checkMoves(preevo, g, moves))
                         return true;
                 }
             }
@@ -430,25 +460,25 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
         /* Pokemon that require knowing a certain move to evolve can't have
           4 other moves from their preevolution except in gen 6 */
         if (PokemonInfo::MoveEvolution(pokeid.pokenum)) {
-            QSet<int> moves3 = moves;
-            moves3.subtract(PokemonInfo::dreamWorldMoves(pokeid, g));
-            moves3.subtract(PokemonInfo::EggMoves(pokeid, g));
-            moves3.subtract(PokemonInfo::SpecialMoves(pokeid, g));
+            MoveBitset moves3 = moves;
+            moves3.subtract(learnset.dreamWorldMoves);
+            moves3.subtract(learnset.eggMoves);
+            moves3.subtract(learnset.specialMoves);
             if(g >= 6) {
-                moves3.subtract(PokemonInfo::PreEvoMoves(pokeid, g));
+                moves3.subtract(learnset.preEvoMoves);
             }
-            if(moves3.size() >= 1) {
-                QSet<int> moves4;
-                moves4 = PokemonInfo::EggMoves(pokeid, g);
-                moves4.unite(PokemonInfo::dreamWorldMoves(pokeid, g));
+            if(moves3.count() >= 1) {
+                MoveBitset moves4;
+                moves4 = learnset.eggMoves;
+                moves4.unite(learnset.dreamWorldMoves);
                 if(g >= 6) {
-                    moves4.unite(PokemonInfo::PreEvoMoves(pokeid, g));
+                    moves4.unite(learnset.preEvoMoves);
                 }
                 moves3.unite(moves4.intersect(moves));
             }
-            if(moves3.size() == 4) {
+            if(moves3.count() == 4) {
                 if (invalid_moves) {
-                    *invalid_moves->insert(moves.toList().value(0));
+                    invalid_moves->insert(moves.first());
                 }
                 if (error) {
                     *error = QObject::tr(gen >= 6 ? "%1 can't have 4 moves which are learned from a previous evolution in a past generation or learned by breeding."
@@ -461,10 +491,7 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
 
         if (!nobreeding) {
             /* If there's a pre evo move and an old gen move, you must check the pre evo has the combination in the old gen */
-            QSet<int> moves3 = moves;
-            moves3.subtract(PokemonInfo::PreEvoMoves(pokeid,g));
-
-            if (moves3.size() != moves.size()) {
+            if (moves.intersects(learnset.preEvoMoves)) {
                 Pokemon::uniqueId pokemon = PokemonInfo::PreEvo(pokeid);
 
                 int ab2;
@@ -481,33 +508,33 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
 
                 /* Shedinja can get one of ninjask's move, as an event move, for free */
                 if (pokeid == Pokemon::Shedinja) {
-                    foreach(int move, moves) {
-                        if (PokemonInfo::SpecialMoves(pokeid, g).contains(move)) {
-                            QSet<int> moves4 = moves;
+                    foreach(int move, moves.toList()) {
+                        if (learnset.specialMoves.contains(move)) {
+                            MoveBitset moves4 = moves;
                             moves4.remove(move);
 
-                            if (isValid(pokemon, g, moves4, ab2, gender, level, maledw))
+                            if (checkMoves(pokemon, g, moves4, ab2, gender, level, maledw))
                                 return true;
                         }
                     }
                 }
-                if (isValid(pokemon, g, moves, ab2, gender, level, maledw))
+                if (checkMoves(pokemon, g, moves, ab2, gender, level, maledw))
                     return true;
             }
         }
 
 
-        if (moves.empty())
+        if (moves.isEmpty())
             return true;
 
         if (!maledw) {
-            if (moves.size() == 1) {
+            if (moves.count() == 1) {
                 if (!nobreeding) {
-                    if (PokemonInfo::HasMoveInGen(pokeid, *moves.begin(), g)) {
+                    if (PokemonInfo::HasMoveInGen(pokeid, moves.first(), g)) {
                         return true;
                     }
                 } else {
-                    if (PokemonInfo::SpecialMoves(pokeid, g).contains(*moves.begin())) {
+                    if (learnset.specialMoves.contains(moves.first())) {
                         return true;
                     }
                 }
@@ -522,15 +549,15 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
             AbilityGroup ab = PokemonInfo::Abilities(pokeid, g);
 
             if (ability == ab.ab(2) || (ability == ab.ab(0) && ab.ab(2) == 0)) {
-                if (moves.size() == 1 && PokemonInfo::dreamWorldMoves(pokeid, g).contains(moves)) {
+                if (moves.count() == 1 && learnset.dreamWorldMoves.contains(moves)) {
                     return true;
                 }
             }
         }
 
-        foreach(int move, moves) {
+        foreach(int move, moves.toList()) {
             if (g > 3 && MoveInfo::isHM(move, Pokemon::gen(g.num-1, GenInfo::NumberOfSubgens(g.num - 1)-1))
-                    && !PokemonInfo::HasMoveInGen(pokeid, *moves.begin(), g) && !PokemonInfo::dreamWorldMoves(pokeid, g).contains(moves)) {
+                    && !PokemonInfo::HasMoveInGen(pokeid, moves.first(), g) && !learnset.dreamWorldMoves.contains(moves)) {
                 if (error) {
                     *error = QObject::tr("%1 can't have HM %2 inherited from past generations.").arg(PokemonInfo::Name(pokeid), MoveInfo::Name(move));
                 }
@@ -545,8 +572,8 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
         *invalid_moves = moves;
     }
     if (error) {
-        if (moves.size() == 1) {
-            *error = QObject::tr("%1 can't learn %2 with moves from older generations.").arg(PokemonInfo::Name(pokeid), MoveInfo::Name(*moves.begin()));
+        if (moves.count() == 1) {
+            *error = QObject::tr("%1 can't learn %2 with moves from older generations.").arg(PokemonInfo::Name(pokeid), MoveInfo::Name(moves.first()));
         } else {
             *error = QObject::tr("%1 can't learn the following move combination: %2.").arg(PokemonInfo::Name(pokeid), getCombinationS(moves));
         }
@@ -556,15 +583,33 @@ bool MoveSetChecker::isValid(const Pokemon::uniqueId &pokeid, Pokemon::gen gen,
 }
 
 bool MoveSetChecker::isAnEggMoveCombination(const Pokemon::uniqueId &pokeid, Pokemon::gen gen, QSet<int> moves)
+{
+    foreach(int move, moves) {
+        if (move < 0 || move >= MoveBitset::Size) {
+            return false;
+        }
+    }
+
+    return isAnEggMoveCombination(pokeid, gen, MoveBitset(moves));
+}
+
+bool MoveSetChecker::isAnEggMoveCombination(const Pokemon::uniqueId &pokeid, Pokemon::gen gen, const MoveBitset &moves)
 {
     if (!legalCombinations.contains(gen)) {
         loadGenData(gen);
     }
     /* In gen 6, everything is an egg move combinations (except for event moves */
-    if (gen >= 6 && PokemonInfo::EggMoves(pokeid, gen).contains(moves)) {
+    if (gen >= 6 && PokemonInfo::Learnset(pokeid, gen).eggMoves.contains(moves)) {
         return true;
     }
-    foreach(QSet<int> combination, legalCombinations[gen].value(pokeid)) {
+
+    const QHash<Pokemon::uniqueId, QList<MoveBitset> > &combinations = legalCombinations[gen];
+    QHash<Pokemon::uniqueId, QList<MoveBitset> >::const_iterator it = combinations.constFind(pokeid);
+    if (it == combinations.constEnd()) {
+        return false;
+    }
+
+    foreach(const MoveBitset &combination, it.value()) {
         if (combination.contains(moves))
             return true;
     }
@@ -572,10 +617,31 @@ bool MoveSetChecker::isAnEggMoveCombination(const Pokemon::uniqueId &pokeid, Pok
     return false;
 }
 
+QHash<Pokemon::uniqueId, QList<QSet<int> > > MoveSetChecker::toSets(const QHash<Pokemon::uniqueId, QList<MoveBitset> > &combinations)
+{
+    QHash<Pokemon::uniqueId, QList<QSet<int> > > ret;
+
+    QHashIterator<Pokemon::uniqueId, QList<MoveBitset> > it(combinations);
+    while (it.hasNext()) {
+        it.next();
+
+        QList<QSet<int> > &sets = ret[it.key()];
+        foreach(const MoveBitset &combination, it.value()) {
+            sets.push_back(combination.toSet());
+        }
+    }
+
+    return ret;
+}
+
 /* Used by ChainBreeding */
 QList<QSet<int> > MoveSetChecker::combinationsFor(Pokemon::uniqueId pokenum, Pokemon::gen gen)
 {
-    return legalCombinations.value(gen).value(pokenum);
+    QList<QSet<int> > ret;
+    foreach(const MoveBitset &combination, legalCombinations.value(gen).value(pokenum)) {
+        ret.push_back(combination.toSet());
+    }
+    return ret;
 }
 
 QHash<Pokemon::uniqueId, QList<QSet<int> > > MoveSetChecker::eventCombinationsOf(Pokemon::gen gen)
@@ -583,7 +649,7 @@ QHash<Pokemon::uniqueId, QList<QSet<int> > > MoveSetChecker::eventCombinationsOf
     if (!legalCombinations.contains(gen)) {
         loadGenData(gen);
     }
-    return eventCombinations.value(gen);
+    return toSets(eventCombinations.value(gen));
 }
 
 QHash<Pokemon::uniqueId, QList<QSet<int> > > MoveSetChecker::breedingCombinationsOf(Pokemon::gen gen)
@@ -591,7 +657,7 @@ QHash<Pokemon::uniqueId, QList<QSet<int> > > MoveSetChecker::breedingCombination
     if (!legalCombinations.contains(gen)) {
         loadGenData(gen);
     }
-    return breedingCombinations.value(gen);
+    return toSets(breedingCombinations.value(gen));
 }
 
 void MoveSetChecker::rbyInvalidCombinations(QHash<QString, QHash<QString, QList<QString> > >* hash) {
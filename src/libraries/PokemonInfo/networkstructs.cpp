@@ -49,6 +49,50 @@ DataStream & operator << (DataStream &out, const PlayerInfo &p)
     return out;
 }
 
+QByteArray zipStreamDictionary()
+{
+    static QByteArray dictionary;
+
+    if (!dictionary.isEmpty()) {
+        return dictionary;
+    }
+
+    DataStream out(&dictionary, QIODevice::WriteOnly, PROTOCOL_VERSION);
+
+    /* Kept under the 4KB window of the deflater. What's most common goes last,
+       as it's closer to what is compressed and so is cheaper to refer to */
+    static const char * const markup[] = {
+        "<a href='po:", "</a>", "<i>", "</i>", "<br/>", "<span style='color: ", "</span>",
+        "<font color='", "'>", "</font>", "<b>", "</b>", "<timestamp/>", "***", ": "
+    };
+    for (unsigned i = 0; i < sizeof(markup)/sizeof(*markup); i++) {
+        out << QString(markup[i]);
+    }
+
+    static const char * const tiers[] = {
+        "Challenge Cup", "Ubers", "LC", "UU", "OU"
+    };
+
+    for (unsigned i = 0; i < sizeof(tiers)/sizeof(*tiers); i++) {
+        out << Battle(10000+2*i, 10001+2*i, 0, tiers[i]);
+    }
+
+    for (unsigned i = 0; i < sizeof(tiers)/sizeof(*tiers); i++) {
+        PlayerInfo p;
+        p.id = 10000 + i;
+        p.name = "Player";
+        p.info = "";
+        p.avatar = 1 + i;
+        p.color = QColor(0, 0, 0);
+        p.flags.setFlag(PlayerInfo::LadderEnabled, true);
+        p.ratings.insert(tiers[i], 1000);
+
+        out << p;
+    }
+
+    return dictionary;
+}
+
 Battle::Battle(int id1, int id2, int mode, const QString &tier) : id1(id1), id2(id2), mode(mode), tier(tier)
 {
 
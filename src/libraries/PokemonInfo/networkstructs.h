@@ -52,7 +52,9 @@ namespace PlayerFlags {
         IdsWithMessage,
         Idle,
         HasRegisterCheck,
-        WantsHTML
+        WantsHTML,
+        SupportsZipStream,
+        SupportsChannelDeltas
     };
     enum {
         NoReconnectData,
@@ -116,6 +118,10 @@ struct Battle
 DataStream & operator >> (DataStream &in, Battle &p);
 DataStream & operator << (DataStream &out, const Battle &p);
 
+/* Preset dictionary for connections compressed with a deflate stream (see ZipDeflater).
+   Changing it breaks the compatibility with the other side, unless they changed it too. */
+QByteArray zipStreamDictionary();
+
 struct ProtocolVersion
 {
     quint16 version;
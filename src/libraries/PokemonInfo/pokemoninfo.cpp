@@ -30,6 +30,9 @@ QVector<QHash<Pokemon::uniqueId, int> > PokemonInfo::m_Abilities[3];
 QVector<QHash<Pokemon::uniqueId, PokeBaseStats> > PokemonInfo::m_BaseStats;
 QVector<QHash<Pokemon::uniqueId, int> > PokemonInfo::m_LevelBalance;
 QHash<int, quint16> PokemonInfo::m_MaxForme;
+QVector<PokemonInfo::Flat> PokemonInfo::m_Flat;
+QVector<int> PokemonInfo::m_FlatWeights;
+QVector<int> PokemonInfo::m_FormeOffsets;
 QHash<Pokemon::uniqueId, QString> PokemonInfo::m_Options;
 int PokemonInfo::m_trueNumberOfPokes;
 QSet<Pokemon::uniqueId> PokemonInfo::m_AestheticFormes;
@@ -42,6 +45,8 @@ QHash<int, int> PokemonInfo::m_PreEvos;
 
 QString MoveInfo::m_Directory;
 QHash<Pokemon::gen, MoveInfo::Gen> MoveInfo::gens;
+QVector<MoveInfo::Table> MoveInfo::m_Tables;
+QVector<int> MoveInfo::m_TableOffsets;
 QHash<int,QString> MoveInfo::m_Names;
 QHash<QString, int> MoveInfo::m_LowerCaseMoves;
 QHash<int, QStringList> MoveInfo::m_MoveMessages;
@@ -581,6 +586,11 @@ QString PokemonInfo::Height(const Pokemon::uniqueId &pokeid)
 
 int PokemonInfo::Type1(const Pokemon::uniqueId &pokeid, Pokemon::gen gen)
 {
+    const int index = flatIndex(pokeid);
+    if (index != -1 && gen.num >= GEN_MIN && gen.num-GEN_MIN < m_Flat.size()) {
+        return m_Flat[gen.num-GEN_MIN].type1[index];
+    }
+
     if (m_Type1[gen.num-GEN_MIN].contains(pokeid)) {
         return m_Type1[gen.num-GEN_MIN].value(pokeid);
     } else {
@@ -590,6 +600,11 @@ int PokemonInfo::Type1(const Pokemon::uniqueId &pokeid, Pokemon::gen gen)
 
 int PokemonInfo::Type2(const Pokemon::uniqueId &pokeid, Pokemon::gen gen)
 {
+    const int index = flatIndex(pokeid);
+    if (index != -1 && gen.num >= GEN_MIN && gen.num-GEN_MIN < m_Flat.size()) {
+        return m_Flat[gen.num-GEN_MIN].type2[index];
+    }
+
     if (m_Type2[gen.num-GEN_MIN].contains(pokeid)) {
         return m_Type2[gen.num-GEN_MIN].value(pokeid);
     } else {
@@ -638,6 +653,11 @@ void PokemonInfo::init(const QString &dir)
 {
     m_Directory = dir;
 
+    /* The tables of the previous data mustn't be used while loading the new one */
+    m_Flat.clear();
+    m_FlatWeights.clear();
+    m_FormeOffsets.clear();
+
     // Load db/pokes data.
     loadNames();
     loadEvos();
@@ -711,6 +731,78 @@ void PokemonInfo::init(const QString &dir)
     loadDescriptions();
 
     makeDataConsistent();
+    flatten();
+}
+
+void PokemonInfo::flatten()
+{
+    /* Lookups go through the hashes while the tables are built */
+    m_Flat.clear();
+    m_FlatWeights.clear();
+    m_FormeOffsets.clear();
+
+    if (m_Names.isEmpty()) {
+        return;
+    }
+
+    QVector<int> offsets;
+    const int maxPoke = m_Names.lastKey().pokenum;
+
+    for (int i = 0; i <= maxPoke; i++) {
+        offsets.push_back(offsets.empty() ? 0 : offsets.last() + m_MaxForme.value(i-1, 0) + 1);
+    }
+    offsets.push_back(offsets.last() + m_MaxForme.value(maxPoke, 0) + 1);
+
+    const int count = offsets.last();
+
+    QVector<Flat> flat(GenInfo::NumberOfGens());
+    QVector<int> weights(count);
+
+    for (int i = 0; i < flat.size(); i++) {
+        Flat &f = flat[i];
+        Pokemon::gen gen(i + GEN_MIN, Pokemon::gen::wholeGen);
+
+        f.type1.resize(count);
+        f.type2.resize(count);
+        f.baseStats.resize(count);
+        for (int j = 0; j < 3; j++) {
+            f.abilities[j].resize(count);
+        }
+
+        for (int poke = 0; poke <= maxPoke; poke++) {
+            for (int index = offsets[poke]; index < offsets[poke+1]; index++) {
+                Pokemon::uniqueId id(poke, index - offsets[poke]);
+
+                f.type1[index] = Type1(id, gen);
+                f.type2[index] = Type2(id, gen);
+                f.baseStats[index] = BaseStats(id, gen);
+
+                AbilityGroup ab = Abilities(id, gen);
+                for (int j = 0; j < 3; j++) {
+                    f.abilities[j][index] = ab.ab(j);
+                }
+
+                if (i == 0) {
+                    weights[index] = Weight(id);
+                }
+            }
+        }
+    }
+
+    m_Flat = flat;
+    m_FlatWeights = weights;
+    m_FormeOffsets = offsets;
+}
+
+int PokemonInfo::flatIndex(const Pokemon::uniqueId &pokeid)
+{
+    if (pokeid.pokenum + 1 >= m_FormeOffsets.size()) {
+        return -1;
+    }
+
+    const int index = m_FormeOffsets[pokeid.pokenum] + pokeid.subnum;
+
+    return index < m_FormeOffsets[pokeid.pokenum+1] ? index : -1;
 }
 
 void PokemonInfo::loadStadiumTradebacks()
@@ -817,7 +909,7 @@ void PokemonInfo::Gen::loadMoves(Gen *parent)
 
             QStringList move_list = it.value().split(' ');
 
-            QSet<int> data_set;
+            MoveBitset data_set;
             for(int ml_counter = 0; ml_counter < move_list.size(); ml_counter++) {
                 int move = move_list[ml_counter].toInt();
                 if(move != 0)
@@ -826,7 +918,7 @@ void PokemonInfo::Gen::loadMoves(Gen *parent)
             /* Should create an item with pokeid key in m_Moves if it does not exist. */
             PokemonMoves &moves = m_Moves[it.key()];
 
-            QSet<int> *refs[] = {
+            MoveBitset *refs[] = {
                 &moves.TMMoves, &moves.levelMoves, &moves.specialMoves, &moves.preEvoMoves, &moves.eggMoves,
                 &moves.tutorMoves, &moves.dreamWorldMoves
             };
@@ -913,28 +1005,32 @@ void PokemonInfo::Gen::addVirtualConsoleTransfer(Gen *parent)
 
 void PokemonInfo::Gen::addTradebacks(Gen *parent)
 {
+    /* Only the moves existing in this gen are traded back */
+    MoveBitset existing;
+    for (int move = 0; move < MoveInfo::NumberOfMoves(); move++) {
+        if (MoveInfo::Exists(move, gen)) {
+            existing.insert(move);
+        }
+    }
+
     QMutableHashIterator<Pokemon::uniqueId, PokemonMoves> it(m_Moves);
     while(it.hasNext()) {
         it.next();
         PokemonMoves &moves = it.value();
         PokemonMoves &moves2 = parent->m_Moves[it.key()];
 
-        QSet<int> *refs[] = {
+        MoveBitset *refs[] = {
             &moves.TMMoves, &moves.levelMoves, &moves.specialMoves, &moves.preEvoMoves, &moves.eggMoves,
             &moves.tutorMoves, &moves.dreamWorldMoves
         };
 
-        QSet<int> *refs2[] = {
+        MoveBitset *refs2[] = {
             &moves2.TMMoves, &moves2.levelMoves, &moves2.specialMoves, &moves2.preEvoMoves, &moves2.eggMoves,
             &moves2.tutorMoves, &moves2.dreamWorldMoves
         };
 
         for (int i = 0; i < 7; i++) {
-            foreach(int move, *refs2[i]) {
-                if (MoveInfo::Exists(move, gen)) {
-                    refs[i]->insert(move);
-                }
-            }
+            refs[i]->unite(MoveBitset(*refs2[i]).intersect(existing));
         }
     }
 }
@@ -960,24 +1056,24 @@ void PokemonInfo::RunMovesSanityCheck(int gen)
         PokemonMoves &m1 = _1.m_Moves[id];
         PokemonMoves &m2 = _2.m_Moves[id];
 
-        QSet<int> t1, t2;
+        MoveBitset t1, t2;
         t1 = m1.regularMoves;
         //t1.unite(m1.dreamWorldMoves).unite(m1.specialMoves);
         t2 = m2.regularMoves;
         //t2.unite(m2.dreamWorldMoves).unite(m2.specialMoves);
 
-        QSet<int> s1(t1), s2(t2);
+        MoveBitset s1(t1), s2(t2);
 
         s1.subtract(t2);
         s2.subtract(t1);
 
-        if (!s1.empty()) {
-            foreach(int m, s1) {
+        if (!s1.isEmpty()) {
+            foreach(int m, s1.toSet()) {
                 qDebug() << "Whole gen contains " << MoveInfo::Name(m) << " for " << PokemonInfo::Name(id) << " while subgens don't";
             }
         }
-        if (!s2.empty()) {
-            foreach(int m, s2) {
+        if (!s2.isEmpty()) {
+            foreach(int m, s2.toSet()) {
                 qDebug() << "Subgens contains " << MoveInfo::Name(m) << " for " << PokemonInfo::Name(id) << " while whole gen doesn't";
             }
         }
@@ -1382,55 +1478,67 @@ QByteArray PokemonInfo::Cry(const Pokemon::uniqueId &pokeid, bool mod)
     return data;
 }
 
+const PokemonMoves &PokemonInfo::Learnset(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
+{
+    static const PokemonMoves empty;
+
+    const Gen &data = gen(g);
+    QHash<Pokemon::uniqueId, PokemonMoves>::const_iterator it = data.m_Moves.constFind(pokeid);
+
+    return it == data.m_Moves.constEnd() ? empty : it.value();
+}
+
 QSet<int> PokemonInfo::Moves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).genMoves;
+    return Learnset(pokeid, g).genMoves.toSet();
 }
 
 bool PokemonInfo::HasMoveInGen(const Pokemon::uniqueId &pokeid, int move, Pokemon::gen g)
 {
-    return gen(g).m_Moves[pokeid].regularMoves.contains(move) || gen(g).m_Moves[pokeid].specialMoves.contains(move)
-            || gen(g).m_Moves[pokeid].eggMoves.contains(move) || gen(g).m_Moves[pokeid].preEvoMoves.contains(move);
+    const PokemonMoves &moves = Learnset(pokeid, g);
+
+    return moves.regularMoves.contains(move) || moves.specialMoves.contains(move)
+            || moves.eggMoves.contains(move) || moves.preEvoMoves.contains(move);
 }
 
 QSet<int> PokemonInfo::RegularMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).regularMoves;
+    return Learnset(pokeid, g).regularMoves.toSet();
 }
 
 QSet<int> PokemonInfo::EggMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).eggMoves;
+    return Learnset(pokeid, g).eggMoves.toSet();
 }
 
 QSet<int> PokemonInfo::LevelMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).levelMoves;
+    return Learnset(pokeid, g).levelMoves.toSet();
 }
 
 QSet<int> PokemonInfo::TutorMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).tutorMoves;
+    return Learnset(pokeid, g).tutorMoves.toSet();
 }
 
 QSet<int> PokemonInfo::TMMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).TMMoves;
+    return Learnset(pokeid, g).TMMoves.toSet();
 }
 
 QSet<int> PokemonInfo::SpecialMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).specialMoves;
+    return Learnset(pokeid, g).specialMoves.toSet();
 }
 
 QSet<int> PokemonInfo::PreEvoMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).preEvoMoves;
+    return Learnset(pokeid, g).preEvoMoves.toSet();
 }
 
 QSet<int> PokemonInfo::dreamWorldMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen g)
 {
-    return gen(g).m_Moves.value(pokeid).dreamWorldMoves;
+    return Learnset(pokeid, g).dreamWorldMoves.toSet();
 }
 
 PokemonInfo::Gen &PokemonInfo::gen(Pokemon::gen gen)
@@ -1450,6 +1558,14 @@ AbilityGroup PokemonInfo::Abilities(const Pokemon::uniqueId &pokeid, Pokemon::ge
 {
     AbilityGroup ret;
 
+    const int index = flatIndex(pokeid);
+    if (index != -1 && gen.num >= GEN_MIN && gen.num-GEN_MIN < m_Flat.size()) {
+        for (int i = 0; i < 3; i++) {
+            ret._ab[i] = m_Flat[gen.num-GEN_MIN].abilities[i][index];
+        }
+        return ret;
+    }
+
     for (int i = 0; i < 3; i++) {
         ret._ab[i] = m_Abilities[i][gen.num-GEN_MIN].value(pokeid);
     }
@@ -1469,6 +1585,11 @@ int PokemonInfo::Ability(const Pokemon::uniqueId &pokeid, int slot, Pokemon::gen
 
 PokeBaseStats PokemonInfo::BaseStats(const Pokemon::uniqueId &pokeid, Pokemon::gen gen)
 {
+    const int index = flatIndex(pokeid);
+    if (index != -1 && gen.num >= GEN_MIN && gen.num-GEN_MIN < m_Flat.size()) {
+        return m_Flat[gen.num-GEN_MIN].baseStats[index];
+    }
+
     return m_BaseStats[gen.num-GEN_MIN].value(pokeid);
 }
 
@@ -1807,6 +1928,9 @@ void MoveInfo::init(const QString &dir)
 {
     m_Directory = dir;
 
+    m_Tables.clear();
+    m_TableOffsets.clear();
+
     loadNames();
     loadMoveMessages();
 
@@ -1827,6 +1951,8 @@ void MoveInfo::init(const QString &dir)
             }
         }
     }
+
+    flatten();
 }
 
 void MoveInfo::Gen::load(const QString &dir, Pokemon::gen gen)
@@ -1944,6 +2070,8 @@ void MoveInfo::retranslate()
     for (int i = 0; i < Version::NumberOfGens; i++) {
         gens[i].retranslate();
     }
+
+    flatten();
 }
 
 bool MoveInfo::isInit() {
@@ -2006,6 +2134,10 @@ QStringList MoveInfo::Names(Pokemon::gen gen)
 }
 
 #define move_find(var, mv, g) do {\
+    const Table *T = table(g); \
+    if (T && uint(mv) < uint(T->var.size())) { \
+    return T->var[mv]; \
+    } \
     Gen *G = &gens[g]; \
     while (!G->var.contains(mv) && G->parent != 0) { \
     G = G->parent; \
@@ -2014,11 +2146,100 @@ QStringList MoveInfo::Names(Pokemon::gen gen)
     } while(0)
 
 #define move_find2(type, res, var, mv, g) \
+    type res; \
+    do { \
+    const Table *T = table(g); \
+    if (T && uint(mv) < uint(T->var.size())) { \
+    res = T->var[mv]; \
+    break; \
+    } \
     Gen *G = &gens[g]; \
     while (!G->var.contains(mv) && G->parent != 0) { \
     G = G->parent; \
     } \
-    type res = G->var.value(mv)
+    res = G->var.value(mv); \
+    } while(0)
+
+#define move_flatten(var) do { \
+    t.var.resize(count); \
+    for (int mv = 0; mv < count; mv++) { \
+    Gen *G = &g; \
+    while (!G->var.contains(mv) && G->parent != 0) { \
+    G = G->parent; \
+    } \
+    t.var[mv] = G->var.value(mv); \
+    } \
+    } while(0)
+
+void MoveInfo::flatten()
+{
+    m_Tables.clear();
+    m_TableOffsets.clear();
+
+    int count = 0;
+    foreach(int mv, m_Names.keys()) {
+        count = std::max(count, mv + 1);
+    }
+
+    QVector<Table> tables;
+    QVector<int> offsets;
+
+    for (int i = GenInfo::GenMin(); i <= GenInfo::GenMax(); i++) {
+        offsets.push_back(tables.size());
+
+        for (int j = 0; j < GenInfo::NumberOfSubgens(i); j++) {
+            Gen &g = gens[Pokemon::gen(i, j)];
+            Table t;
+
+            move_flatten(accuracy);
+            move_flatten(category);
+            move_flatten(causedEffect);
+            move_flatten(critRate);
+            move_flatten(damageClass);
+            move_flatten(effect);
+            move_flatten(zeffect);
+            move_flatten(specialEffect);
+            move_flatten(effectChance);
+            move_flatten(flags);
+            move_flatten(flinchChance);
+            move_flatten(healing);
+            move_flatten(maxTurns);
+            move_flatten(minTurns);
+            move_flatten(minMaxHits);
+            move_flatten(stataffected);
+            move_flatten(statboost);
+            move_flatten(statrate);
+            move_flatten(power);
+            move_flatten(zpower);
+            move_flatten(pp);
+            move_flatten(priority);
+            move_flatten(range);
+            move_flatten(recoil);
+            move_flatten(type);
+
+            tables.push_back(t);
+        }
+    }
+    offsets.push_back(tables.size());
+
+    m_Tables = tables;
+    m_TableOffsets = offsets;
+}
+
+#undef move_flatten
+
+const MoveInfo::Table *MoveInfo::table(Pokemon::gen gen)
+{
+    const int i = gen.num - GenInfo::GenMin();
+
+    if (i < 0 || i + 1 >= m_TableOffsets.size()) {
+        return NULL;
+    }
+
+    const int index = m_TableOffsets[i] + gen.subnum;
+
+    return index < m_TableOffsets[i+1] ? m_Tables.constData() + index : NULL;
+}
 
 int MoveInfo::Type(int mv, Pokemon::gen g)
 {
@@ -3099,6 +3320,11 @@ int ItemInfo::Number(const QString &itemname)
 }
 
 int PokemonInfo::Weight(const Pokemon::uniqueId &pokeid) {
+    const int index = flatIndex(pokeid);
+    if (index != -1) {
+        return m_FlatWeights[index];
+    }
+
     return QString(m_Weights.value(pokeid)).remove('.').toInt();
 }
 
@@ -4,6 +4,7 @@
 #include "pokemon.h"
 #include "geninfo.h"
 #include "pokemonstructs.h"
+#include "movebitset.h"
 #include <QtCore>
 #include <QMovie>
 
@@ -48,15 +49,15 @@ struct PokemonMoves
 {
     //QSet<int> moves;
     /* All moves except egg & special */
-    QSet<int> regularMoves;
-    QSet<int> TMMoves;
-    QSet<int> preEvoMoves;
-    QSet<int> levelMoves;
-    QSet<int> eggMoves;
-    QSet<int> specialMoves;
-    QSet<int> tutorMoves;
-    QSet<int> genMoves;
-    QSet<int> dreamWorldMoves;
+    MoveBitset regularMoves;
+    MoveBitset TMMoves;
+    MoveBitset preEvoMoves;
+    MoveBitset levelMoves;
+    MoveBitset eggMoves;
+    MoveBitset specialMoves;
+    MoveBitset tutorMoves;
+    MoveBitset genMoves;
+    MoveBitset dreamWorldMoves;
 };
 
 
@@ -99,6 +100,9 @@ public:
     static QSet<int> SpecialMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen gen);
     static QSet<int> RegularMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen gen);
     static QSet<int> dreamWorldMoves(const Pokemon::uniqueId &pokeid, Pokemon::gen gen);
+    /* All the learnsets of the pokemon at once, without copying them. Empty if the
+       pokemon isn't in the gen. The reference stays valid as long as the gen isn't reloaded */
+    static const PokemonMoves &Learnset(const Pokemon::uniqueId &pokeid, Pokemon::gen gen);
     static QList<Pokemon::uniqueId> AllIds();
     // Base form do NOT count.
     static quint16 NumberOfAFormes(const Pokemon::uniqueId &pokeid);
@@ -207,6 +211,24 @@ private:
     // Keep it as QHash.
     // quint16 as only pokenum matters.
     static QHash<int, quint16> m_MaxForme;
+
+    /* Copies of the data the battles use the most, with the fallbacks on the original forme
+       already resolved, for lookups without hashing. m_Flat is indexed by gen, and each table
+       by flatIndex(pokemon). Built once everything is loaded */
+    struct Flat {
+        QVector<int> type1;
+        QVector<int> type2;
+        QVector<int> abilities[3];
+        QVector<PokeBaseStats> baseStats;
+    };
+    static QVector<Flat> m_Flat;
+    static QVector<int> m_FlatWeights;
+    /* Index of the first forme of each pokemon in the tables, plus the end of the last one */
+    static QVector<int> m_FormeOffsets;
+
+    static void flatten();
+    /* -1 if the pokemon isn't in the tables */
+    static int flatIndex(const Pokemon::uniqueId &pokeid);
     // Holds 1-letter options.
     // Sample use: if(m_Options.value(pokeid).contains('H')) whatever();
     // Values for pokemons.txt:
@@ -355,6 +377,44 @@ private:
     static void loadMoveMessages();
 
     static QString path(const QString &filename);
+
+    /* Gens with the parent chain resolved, for lookups without hashing. Indexed by move number,
+       built once everything is loaded */
+    struct Table {
+        QVector<char> accuracy;
+        QVector<char> category;
+        QVector<char> causedEffect;
+        QVector<char> critRate;
+        QVector<char> damageClass;
+        QVector<QString> effect;
+        QVector<QString> zeffect;
+        QVector<QString> specialEffect;
+        QVector<char> effectChance;
+        QVector<int> flags;
+        QVector<char> flinchChance;
+        QVector<signed char> healing;
+        QVector<char> maxTurns;
+        QVector<char> minTurns;
+        QVector<char> minMaxHits;
+        QVector<long> stataffected;
+        QVector<long> statboost;
+        QVector<long> statrate;
+        QVector<unsigned char> power;
+        QVector<unsigned char> zpower;
+        QVector<char> pp;
+        QVector<signed char> priority;
+        QVector<char> range;
+        QVector<signed char> recoil;
+        QVector<char> type;
+    };
+
+    static QVector<Table> m_Tables;
+    /* Index in m_Tables of the first subgen of each gen, plus the end of the last one */
+    static QVector<int> m_TableOffsets;
+
+    static void flatten();
+    /* NULL if the gen isn't in the tables */
+    static const Table *table(Pokemon::gen gen);
 };
 
 class ItemInfo
@@ -16,12 +16,14 @@ SOURCES += otherwidgets.cpp \
     qtableplus.cpp \
     qclicklabel.cpp \
     ziputils.cpp \
+    zipstream.cpp \
     qclosedockwidget.cpp \
     backtrace.cpp \
     qverticalscrollarea.cpp \
     qscrolldowntextbrowser.cpp \
     pluginmanager.cpp \
     antidos.cpp \
+    ipranges.cpp \
     antidoswindow.cpp \
     baseanalyzer.cpp \
     keypresseater.cpp \
@@ -38,6 +40,7 @@ HEADERS += otherwidgets.h \
     qtableplus.h \
     qclicklabel.h \
     ziputils.h \
+    zipstream.h \
     qclosedockwidget.h \
     backtrace.h \
     qverticalscrollarea.h \
@@ -45,10 +48,12 @@ HEADERS += otherwidgets.h \
     pluginmanager.h \
     plugininterface.h \
     antidos.h \
+    ipranges.h \
     antidoswindow.h \
     asiosocket.h \
     network.h \
     rankingtree.h \
+    mpscqueue.h \
     baseanalyzer.h \
     keypresseater.h \
     exesuffix.h \
@@ -95,8 +100,8 @@ contains(QT_VERSION, ^5\\.[0-9]\\..*) {
 
 include(../../Shared/Common.pri)
 
-windows: { LIBS += -L$$bin -lzip-2 }
-!windows: { LIBS += -lzip }
+windows: { LIBS += -L$$bin -lzip-2 -lzlib1 }
+!windows: { LIBS += -lzip -lz }
 
 FORMS += \
     pluginmanagerdialog.ui
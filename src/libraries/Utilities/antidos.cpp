@@ -1,11 +1,83 @@
-#include <ctime>
+#include <cstring>
+#include <algorithm>
 
 #include <QDebug>
 #include <QSettings>
 
 #include "antidos.h"
 
-AntiDos::AntiDos(QSettings &settings) {
+RateWindow::RateWindow(int seconds) : span(std::max(seconds / Buckets, 1)), slot(0), events(0), sum(0)
+{
+    memset(counts, 0, sizeof(counts));
+    memset(amounts, 0, sizeof(amounts));
+}
+
+void RateWindow::advance(qint64 now)
+{
+    qint64 current = now / span;
+
+    if (current <= slot) {
+        return;
+    }
+
+    /* Past a whole window, everything goes */
+    if (current - slot >= Buckets) {
+        memset(counts, 0, sizeof(counts));
+        memset(amounts, 0, sizeof(amounts));
+        events = 0;
+        sum = 0;
+    } else {
+        for (qint64 s = slot + 1; s <= current; s++) {
+            int i = s % Buckets;
+            events -= counts[i];
+            sum -= amounts[i];
+            counts[i] = 0;
+            amounts[i] = 0;
+        }
+    }
+
+    slot = current;
+}
+
+void RateWindow::add(qint64 now, quint32 amount)
+{
+    advance(now);
+
+    int i = slot % Buckets;
+    counts[i] += 1;
+    amounts[i] += amount;
+    events += 1;
+    sum += amount;
+}
+
+void RateWindow::removeLast(qint64 now, quint32 amount)
+{
+    advance(now);
+
+    int i = slot % Buckets;
+    if (counts[i] > 0) {
+        counts[i] -= 1;
+        events -= 1;
+        amount = std::min(amount, amounts[i]);
+        amounts[i] -= amount;
+        sum -= amount;
+    }
+}
+
+int RateWindow::count(qint64 now)
+{
+    advance(now);
+    return events;
+}
+
+qint64 RateWindow::total(qint64 now)
+{
+    advance(now);
+    return sum;
+}
+
+AntiDos::AntiDos(QSettings &settings) : connectedIps(0), trustedVersion(0) {
+    clock.start();
     loadVals(settings);
     // Clears history every day, to save RAM.
     connect(&timer, SIGNAL(timeout()), this, SLOT(clearData()));
@@ -19,7 +91,8 @@ void AntiDos::init(QSettings &settings)
 }
 
 void AntiDos::loadVals(QSettings &settings) {
-    trusted_ips = settings.value("AntiDOS/TrustedIps").toString().split(QRegExp("\\s*,\\s*"));
+    setTrustedIps(settings.value("AntiDOS/TrustedIps").toString().split(QRegExp("\\s*,\\s*")));
+    setBannedRanges(settings.value("AntiDOS/BannedRanges").toString().split(QRegExp("\\s*,\\s*")));
     max_people_per_ip = settings.value("AntiDOS/MaxPeoplePerIp").toInt();
     max_commands_per_user = settings.value("AntiDOS/MaxCommandsPerUser").toInt();
     max_kb_per_user = settings.value("AntiDOS/MaxKBPerUser").toInt();
@@ -29,78 +102,101 @@ void AntiDos::loadVals(QSettings &settings) {
     on = !settings.value("AntiDOS/Disabled").toBool();
 }
 
-bool AntiDos::connecting(const QString &ip)
+void AntiDos::setTrustedIps(const QStringList &ips)
 {
-    if (loginsPerIp.contains(ip)) {
-        QList<time_t> &l = loginsPerIp[ip];
+    trusted_ips = IpRanges(ips);
+    /* The connections will check their IP again */
+    trustedVersion += 1;
+}
 
-        int i = 0;
+void AntiDos::setBannedRanges(const QStringList &ranges)
+{
+    banned_ranges = IpRanges(ranges);
+}
 
-        /* Removing connections older than 1 minute */
-        while (i < l.size()) {
-            if (time(NULL)-l[i] > 60) {
-                i++;
-            }  else {
-                break;
-            }
-        }
+qint64 AntiDos::now() const
+{
+    return clock.elapsed() / 1000;
+}
 
-        l.erase(l.begin(), l.begin()+i);
+bool AntiDos::connecting(const QString &ip)
+{
+    if (on && banned_ranges.contains(ip)) {
+        return false;
+    }
 
-        if (l.size() >= max_login_per_ip && on && !trusted_ips.contains(ip)) {
-            //qDebug() << "Too many attempts for IP " << ip;
-            return false;
-        }
+    bool limited = on && !trusted_ips.contains(ip);
+    qint64 now = this->now();
+    IpData &data = ips[ip];
+
+    /* Connections of the last minute */
+    if (limited && data.logins.count(now) >= max_login_per_ip) {
+        //qDebug() << "Too many attempts for IP " << ip;
+        return false;
     }
 
-    if (connectionsPerIp.value(ip) >= max_people_per_ip && on && !trusted_ips.contains(ip)) {
+    if (limited && data.connections >= max_people_per_ip) {
         /* That way it won't appear in the logs if they spam DoS connections */
         if (rand() % 3)
-            loginsPerIp[ip].push_back(time(NULL));
+            data.logins.add(now);
         qDebug() << "Too many people for IP " << ip;
         return false;
     }
 
-
     /* Registering the connection */
-    loginsPerIp[ip].push_back(time(NULL));
-    connectionsPerIp[ip]++;
-    //Server::serverIns->printLine(tr("Connections for ip(+conn) %1 are %2").arg(ip).arg(connectionsPerIp[ip]));
+    data.logins.add(now);
+    if (data.connections++ == 0) {
+        connectedIps += 1;
+    }
+    //Server::serverIns->printLine(tr("Connections for ip(+conn) %1 are %2").arg(ip).arg(data.connections));
 
     return true;
 }
 
-void AntiDos::disconnect(const QString &ip, int id)
+void AntiDos::removeConnection(const QString &ip)
 {
-    connectionsPerIp[ip]--;
-    //Server::serverIns->printLine(tr("Connections for ip(-disc) %1 are %2").arg(ip).arg(connectionsPerIp[ip]));
-    transfersPerId.remove(id);
-    sizeOfTransfers.remove(id);
-    if (connectionsPerIp[ip]==0) {
-        connectionsPerIp.remove(ip);
+    QHash<QString, IpData>::iterator it = ips.find(ip);
+
+    if (it == ips.end() || it->connections <= 0) {
+        return;
+    }
+
+    if (--it->connections == 0) {
+        connectedIps -= 1;
     }
 }
 
+void AntiDos::disconnect(const QString &ip, int id)
+{
+    removeConnection(ip);
+    //Server::serverIns->printLine(tr("Connections for ip(-disc) %1 are %2").arg(ip).arg(connections(ip)));
+    ids.remove(id);
+}
+
 bool AntiDos::changeIP(const QString &newIp, const QString &oldIp)
 {
-    connectionsPerIp[oldIp]--;
-    //Server::serverIns->printLine(tr("Connections for ip(-change) %1 are %2").arg(oldIp).arg(connectionsPerIp[oldIp]));
-    loginsPerIp[oldIp].pop_back(); // remove a login
-    if (connectionsPerIp[oldIp] <= 0) {
-        connectionsPerIp.remove(oldIp);
+    removeConnection(oldIp);
+    //Server::serverIns->printLine(tr("Connections for ip(-change) %1 are %2").arg(oldIp).arg(connections(oldIp)));
+    if (ips.contains(oldIp)) {
+        ips[oldIp].logins.removeLast(now()); // remove a login
     }
     return connecting(newIp);
 }
 
 void AntiDos::clearIP(const QString &ip)
 {
-    connectionsPerIp.remove(ip);
+    QHash<QString, IpData>::iterator it = ips.find(ip);
+
+    if (it != ips.end() && it->connections > 0) {
+        it->connections = 0;
+        connectedIps -= 1;
+    }
 }
 
 
 int AntiDos::numberOfDiffIps()
 {
-    return connectionsPerIp.count();
+    return connectedIps;
 }
 
 bool AntiDos::transferBegin(int id, int length, const QString &ip)
@@ -109,79 +205,42 @@ bool AntiDos::transferBegin(int id, int length, const QString &ip)
         qFatal("Fatal! Negative id in AntiDOS: %d", id);
     }
 
+    IdData &data = ids[id];
+
+    if (data.trustedVersion != trustedVersion || data.ip != ip) {
+        data.ip = ip;
+        data.trusted = trusted_ips.contains(ip);
+        data.trustedVersion = trustedVersion;
+    }
+
     /* If the IP is in the Trusted Ips list, do not do anything */
-    if (trusted_ips.contains(ip)) {
+    if (data.trusted) {
         return true;
     }
 
-    if (transfersPerId.contains(id)) {
-        QList< QPair<time_t, size_t> > &l = transfersPerId[id];
-        int &len = sizeOfTransfers[id];
-        int orlen = len;
+    qint64 now = this->now();
 
-        int i = 0;
-
-        /* Removing commands older than 1 minute */
-        while (i < l.size()) {
-            if (time(NULL)-l[i].first > 60) {
-                len -= l[i].second;
-                i++;
-            }  else {
-                break;
-            }
-        }
-
-        if (len < 0) {
-            qFatal("Fatal! Negative length in antidos: %d > %d, id: %d, removed: %d", orlen, len, id, i);
-        }
-
-        l.erase(l.begin(), l.begin()+i);
-
-
-        if (l.size() >= max_commands_per_user && on) {
-            emit kick(id);
-            addKick(ip);
-            return false;
-        }
-
-
-        if (len + length > max_kb_per_user*1024 && on) {
-            emit kick(id);
-            addKick(ip);
-            return false;
-        }
-    } else if (length > max_kb_per_user*1024 && on) {
+    /* Commands of the last minute */
+    if (on && (data.transfers.count(now) >= max_commands_per_user || data.transfers.total(now) + length > max_kb_per_user*1024)) {
         emit kick(id);
         addKick(ip);
         return false;
     }
 
-    sizeOfTransfers[id] += length;
-    transfersPerId[id].push_back(QPair<time_t, size_t>(time(NULL), length));
+    data.transfers.add(now, length);
 
     return true;
 }
 
 void AntiDos::addKick(const QString &ip)
 {
-    QList<time_t> &l = kicksPerIp[ip];
-
-    int i = 0;
+    qint64 now = this->now();
+    RateWindow &kicks = ips[ip].kicks;
 
-    /* Removing kicks older than 15 minutes */
-    while (i < l.size()) {
-        if (time(NULL)-l[i] > 900) {
-            i++;
-        }  else {
-            break;
-        }
-    }
+    /* Kicks of the last 15 minutes */
+    kicks.add(now);
 
-    l.erase(l.begin(), l.begin()+i);
-
-    l.push_back(time(NULL));
-
-    if (l.size() >= ban_after_x_kicks && on) {
+    if (kicks.count(now) >= ban_after_x_kicks && on) {
         emit ban(ip);
     }
 }
@@ -189,17 +248,26 @@ void AntiDos::addKick(const QString &ip)
 void AntiDos::clearData()
 {
     // Clears the history every 24 hours to avoid memory consumption
-    loginsPerIp.clear();
-    kicksPerIp.clear();
+    QHash<QString, IpData>::iterator it = ips.begin();
+    while (it != ips.end()) {
+        if (it->connections > 0) {
+            it->logins = RateWindow();
+            it->kicks = RateWindow(15*60);
+            ++it;
+        } else {
+            it = ips.erase(it);
+        }
+    }
 }
 
 int AntiDos::connections(const QString &ip)
 {
-    return connectionsPerIp.value(ip);
+    QHash<QString, IpData>::const_iterator it = ips.constFind(ip);
+    return it == ips.constEnd() ? 0 : it->connections;
 }
 
 QString AntiDos::dump() const
 {
-    return QString("Antidos\n\tConnections Per IP> %1\n\tLogins per IP> %2\n\tTransfers Per Id> %3\n\tSize of Transfers> %4\n\tKicks per IP> %5\n").arg(connectionsPerIp.count()).arg(
-                loginsPerIp.count()).arg(transfersPerId.count()).arg(sizeOfTransfers.count()).arg(kicksPerIp.count());
+    return QString("Antidos\n\tConnections Per IP> %1\n\tIPs tracked> %2\n\tTransfers Per Id> %3\n").arg(connectedIps).arg(
+                ips.count()).arg(ids.count());
 }
@@ -4,12 +4,39 @@
 #include <QObject>
 #include <QString>
 #include <QHash>
-#include <QList>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QStringList>
 
+#include "ipranges.h"
+
 class QSettings;
 
+/* Events and amounts of the last minute (or of any other window), counted in a ring of
+   buckets so that adding and reading don't depend on the rate. Times are in seconds */
+class RateWindow
+{
+public:
+    enum { Buckets = 60 };
+
+    RateWindow(int seconds = 60);
+
+    void add(qint64 now, quint32 amount = 1);
+    /* Takes back an event, if the bucket it went in is still there */
+    void removeLast(qint64 now, quint32 amount = 1);
+    int count(qint64 now);
+    qint64 total(qint64 now);
+private:
+    /* Empties the buckets that went out of the window */
+    void advance(qint64 now);
+
+    int span;
+    qint64 slot;
+    quint32 counts[Buckets], amounts[Buckets];
+    int events;
+    qint64 sum;
+};
+
 /* A class to detect flood and ban DoSing IPs */
 class AntiDos : public QObject
 {
@@ -53,19 +80,43 @@ public slots:
     void loadVals(QSettings &settings);
     /* Clears data stored */
     void clearData();
+    /* IPs / ranges that are never limited, and ranges that can't connect */
+    void setTrustedIps(const QStringList &ips);
+    void setBannedRanges(const QStringList &ranges);
 private:
-    QHash<QString, int> connectionsPerIp;
-    QHash<QString, QList<time_t> > loginsPerIp;
-    QHash<int, QList<QPair<time_t, size_t> > > transfersPerId;
-    QHash<int, int> sizeOfTransfers;
-    QHash<QString, QList<time_t> > kicksPerIp;
+    struct IpData {
+        IpData() : connections(0), kicks(15*60) {}
+
+        int connections;
+        RateWindow logins;
+        RateWindow kicks;
+    };
+
+    struct IdData {
+        IdData() : trusted(false), trustedVersion(-1) {}
+
+        /* Whether the ip is trusted, checked again when it or the trusted IPs change */
+        QString ip;
+        bool trusted;
+        int trustedVersion;
+        RateWindow transfers;
+    };
+
+    QHash<QString, IpData> ips;
+    QHash<int, IdData> ids;
+    /* IPs with at least one connection */
+    int connectedIps;
     QTimer timer;
+    QElapsedTimer clock;
     static AntiDos *instance;
 
-    QStringList trusted_ips;
+    IpRanges trusted_ips, banned_ranges;
+    int trustedVersion;
     int max_people_per_ip, max_commands_per_user, max_kb_per_user, max_login_per_ip, ban_after_x_kicks;
     bool on;
 
+    qint64 now() const;
     void addKick(const QString &ip);
+    void removeConnection(const QString &ip);
 };
 #endif // ANTIDOS_H
@@ -45,6 +45,11 @@ AntiDosWindow::AntiDosWindow(QSettings &settings) : settings(settings)
     trusted_ips->setText(settings.value("AntiDOS/TrustedIps").toString());
     mylayout->addRow(tr("Trusted IPs (separated by comma)"),trusted_ips);
 
+    banned_ranges = new QLineEdit();
+    banned_ranges->setText(settings.value("AntiDOS/BannedRanges").toString());
+    banned_ranges->setPlaceholderText("10.0.0.0/8, 2001:db8::/32");
+    mylayout->addRow(tr("Banned IP ranges (separated by comma)"),banned_ranges);
+
     notificationsChannel = new QLineEdit(settings.value("AntiDOS/NotificationsChannel").toString());
     mylayout->addRow(tr("Channel in which to display overactive messages: "), notificationsChannel);
 
@@ -72,7 +77,8 @@ void AntiDosWindow::apply()
 {
     AntiDos *obj = AntiDos::obj();
 
-    obj->trusted_ips = trusted_ips->text().split(QRegExp("\\s*,\\s*"));
+    obj->setTrustedIps(trusted_ips->text().split(QRegExp("\\s*,\\s*")));
+    obj->setBannedRanges(banned_ranges->text().split(QRegExp("\\s*,\\s*")));
     obj->max_people_per_ip = max_people_per_ip->value();
     obj->max_commands_per_user = max_commands_per_user->value();
     obj->max_kb_per_user = max_kb_per_user->value();
@@ -86,7 +92,8 @@ void AntiDosWindow::apply()
     settings.setValue("AntiDOS/MaxKBPerUser", obj->max_kb_per_user);
     settings.setValue("AntiDOS/MaxConnectionRatePerIP", obj->max_login_per_ip);
     settings.setValue("AntiDOS/NumberOfInfractionsBeforeBan", obj->ban_after_x_kicks);
-    settings.setValue("AntiDOS/TrustedIps", obj->trusted_ips.join(","));
+    settings.setValue("AntiDOS/TrustedIps", obj->trusted_ips.toStringList().join(","));
+    settings.setValue("AntiDOS/BannedRanges", obj->banned_ranges.toStringList().join(","));
     settings.setValue("AntiDOS/Disabled", !obj->on);
     settings.setValue("AntiDOS/NotificationsChannel", notificationsChannel->text());
 
@@ -17,7 +17,7 @@ public slots:
     void apply();
 private:
     QSpinBox *max_people_per_ip, *max_commands_per_user, *max_kb_per_user, *max_login_per_ip, *ban_after_x_kicks;
-    QLineEdit *trusted_ips, *notificationsChannel;
+    QLineEdit *trusted_ips, *banned_ranges, *notificationsChannel;
     QCheckBox *aDosOn;
 
     QSettings &settings;
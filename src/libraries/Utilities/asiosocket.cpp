@@ -1,5 +1,6 @@
 #ifdef BOOST_SOCKETS
 
+#include <algorithm>
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
 #include "asiosocket.h"
@@ -19,52 +20,80 @@ struct deleteObjectLater {
 using boost::asio::ip::tcp;
 using namespace boost::asio;
 
-SocketManager::SocketManager() {
-    finished = false;
+SocketManager::Worker::Worker() : work(new io_service::work(service))
+{
 }
 
-SocketManager::~SocketManager() {
-    finished = true;
+void SocketManager::Worker::run() {
+    /* Blocks until the service is stopped, the work object keeps it from returning when idle */
+    boost::system::error_code ec;
+    service.run(ec);
+}
 
-    /* Wait till the thread finished */
-    while (finished) {
+SocketManager::SocketManager(int threads) : next(0) {
+    if (threads <= 0) {
+        threads = std::max(QThread::idealThreadCount(), 1);
+    }
+
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(new Worker());
     }
 }
 
-void SocketManager::run() {
-    while (!finished) {
-        io_service.reset();
+SocketManager::~SocketManager() {
+    foreach(Worker *w, workers) {
+        w->work.reset();
+        w->service.stop();
+    }
 
-        boost::system::error_code ec;
+    /* Wait till the threads finished */
+    foreach(Worker *w, workers) {
+        w->wait();
+        delete w;
+    }
+}
 
-        io_service.run_one(ec);
+void SocketManager::start() {
+    foreach(Worker *w, workers) {
+        w->start();
     }
+}
+
+int SocketManager::threadCount() const {
+    return workers.size();
+}
 
-    finished = false;
+/* Only called from the main thread */
+io_service &SocketManager::nextService() {
+    Worker *w = workers[next];
+    next = (next + 1) % workers.size();
+
+    return w->service;
 }
 
 SocketSQ::pointer SocketManager::createSocket() {
-    return SocketSQ::pointer(new SocketSQ(this, new tcp::socket(io_service)), deleteObjectLater());
+    return SocketSQ::pointer(new SocketSQ(this, new tcp::socket(nextService())), deleteObjectLater());
 }
 
 SocketSQ::pointer SocketManager::createServerSocket() {
-    return SocketSQ::pointer(new SocketSQ(this, new tcp::acceptor(io_service)), deleteObjectLater());
+    return SocketSQ::pointer(new SocketSQ(this, new tcp::acceptor(nextService())), deleteObjectLater());
 }
 
-SocketSQ::SocketSQ(SocketManager *manager, tcp::socket *s) : mysock(s), manager(manager), m(QMutex::Recursive), bufCounter(0), notifiedDced(false)
+SocketSQ::SocketSQ(SocketManager *manager, tcp::socket *s) : mysock(s), manager(manager), bufCounter(0), notified(0), sendPosted(0), closing(false), notifiedDced(false)
 {
     isServer = false;
     incoming = NULL;
     freeConnection = true;
 }
 
-SocketSQ::SocketSQ(SocketManager *manager, tcp::acceptor *s) : myserver(s), manager(manager), bufCounter(0), notifiedDced(false)
+SocketSQ::SocketSQ(SocketManager *manager, tcp::acceptor *s) : myserver(s), manager(manager), bufCounter(0), notified(0), sendPosted(0), closing(false), notifiedDced(false)
 {
     isServer = true;
     incoming = NULL;
     freeConnection = true;
 
-    incoming = new tcp::socket(manager->io_service);
+    /* Accepted connections go to the io_services in turn */
+    incoming = new tcp::socket(manager->nextService());
 }
 
 SocketSQ::~SocketSQ() {
@@ -120,7 +149,7 @@ SocketSQ::pointer SocketSQ::nextPendingConnection()
     boost::system::error_code ec;
     ret->myip = QString::fromStdString(incoming->remote_endpoint(ec).address().to_string());
 
-    incoming = new tcp::socket(manager->io_service);
+    incoming = new tcp::socket(manager->nextService());
     freeConnection = true;
     server().async_accept(*incoming, boost::bind(&SocketSQ::acceptHandler, this, boost::asio::placeholders::error));
 
@@ -134,13 +163,27 @@ SocketSQ::pointer SocketSQ::nextPendingConnection()
 }
 
 void SocketSQ::start() {
-    /* Starts the receiving loop */
-    readHandler(boost::system::error_code(), 0);
+    /* Starts the receiving loop, in the thread of the socket */
+    sock().get_io_service().post(boost::bind(&SocketSQ::readHandler, shared_from_this(), boost::system::error_code(), 0));
 }
 
 void SocketSQ::disconnectFromHost()
 {
-    sock().close();
+    /* Posted after the writes already queued, so they still go out */
+    sock().get_io_service().post(boost::bind(&SocketSQ::closeSocket, shared_from_this()));
+}
+
+void SocketSQ::closeSocket()
+{
+    /* The write handler closes the socket when everything is sent */
+    if (!sending.empty()) {
+        closing = true;
+        return;
+    }
+
+    closing = false;
+    boost::system::error_code ec;
+    sock().close(ec);
 }
 
 tcp::socket &SocketSQ::sock()
@@ -165,6 +208,9 @@ const tcp::acceptor &SocketSQ::server() const
 
 int SocketSQ::bytesAvailable()
 {
+    /* Cleared before looking at the buffer: whatever is received after that notifies again */
+    notified.fetchAndStoreOrdered(0);
+
     QMutexLocker l(&m);
 
     if (notifiedDced)
@@ -173,13 +219,25 @@ int SocketSQ::bytesAvailable()
     return buffer.size()-bufCounter;
 }
 
+void SocketSQ::notify()
+{
+    if (notified.fetchAndStoreOrdered(1) == 0) {
+        emit active();
+    }
+}
+
+void SocketSQ::notifyDisconnect()
+{
+    if (!notifiedDced) {
+        notifiedDced = true;
+        emit disconnected();
+    }
+}
+
 void SocketSQ::readHandler(const boost::system::error_code& ec, std::size_t bytes_transferred)
 {
     if (ec) {
-        if (!notifiedDced) {
-            notifiedDced = true;
-            emit disconnected();
-        }
+        notifyDisconnect();
         return;
     }
 
@@ -188,7 +246,7 @@ void SocketSQ::readHandler(const boost::system::error_code& ec, std::size_t byte
         buffer.append(innerBuffer, bytes_transferred);
         m.unlock();
 
-        emit active();
+        notify();
     }
 
     sock().async_read_some(boost::asio::buffer(innerBuffer, 10000),
@@ -197,24 +255,17 @@ void SocketSQ::readHandler(const boost::system::error_code& ec, std::size_t byte
 
 void SocketSQ::writeHandler(const boost::system::error_code& ec, std::size_t bytes_transferred)
 {
-    if (ec) {
-        if (!notifiedDced) {
-            notifiedDced = true;
-            emit disconnected();
-        }
-        return;
-    }
+    (void) bytes_transferred;
 
-    QMutexLocker l(&m);
+    sending.clear();
 
-    sending = sending.right(sending.size() - bytes_transferred) + toSend;
-    toSend.clear();
-
-    if (sending.size() == 0)
+    /* sendPosted stays set, nothing is written anymore */
+    if (ec) {
+        notifyDisconnect();
         return;
+    }
 
-    sock().async_send(boost::asio::buffer(sending.data(), sending.size()),
-                      boost::bind(&SocketSQ::writeHandler, shared_from_this(), boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred));
+    sendData();
 }
 
 void SocketSQ::acceptHandler(const boost::system::error_code& ec)
@@ -244,21 +295,23 @@ QByteArray SocketSQ::read(int length)
 {
     QMutexLocker l(&m);
 
+    length = std::max(std::min(length, buffer.size() - bufCounter), 0);
+
     QByteArray ret;
-    if (bufCounter == 0)
-        ret = buffer;
-    else {
+    if (bufCounter == 0 && length == buffer.size()) {
+        /* The usual case, everything is read: no copy */
+        ret.swap(buffer);
+    } else {
         ret = buffer.mid(bufCounter, length);
         buffer.remove(0, bufCounter+length);
-        bufCounter = 0;
     }
+    bufCounter = 0;
     return ret;
 }
 
 void SocketSQ::putChar(char c)
 {
-    QMutexLocker l(&m);
-    toSend.append(c);
+    write(QByteArray(1, c));
 }
 
 void SocketSQ::setLowDelay(bool lowDelay)
@@ -269,13 +322,16 @@ void SocketSQ::setLowDelay(bool lowDelay)
 
 void SocketSQ::write(const QByteArray &b)
 {
-    QMutexLocker l(&m);
-    if (toSend.length() == 0)
-        toSend = b;
-    else
-        toSend.append(b);
+    if (b.isEmpty()) {
+        return;
+    }
 
-    sendData();
+    toSend.push(b);
+
+    /* Only one sendData() at a time, the one already posted or running will see the buffer */
+    if (sendPosted.fetchAndStoreOrdered(1) == 0) {
+        sock().get_io_service().post(boost::bind(&SocketSQ::sendData, shared_from_this()));
+    }
 }
 
 QString SocketSQ::ip()
@@ -285,12 +341,41 @@ QString SocketSQ::ip()
 
 void SocketSQ::sendData()
 {
-    QMutexLocker l(&m);
-
-    if (sending.size() == 0 && toSend.size() > 0) {
-        writeHandler(boost::system::error_code(), 0);
+    /* The write handler calls back when it's done */
+    if (!sending.empty()) {
         return;
     }
+
+    QByteArray b;
+    while (toSend.pop(b)) {
+        sending.push_back(b);
+    }
+
+    while (sending.empty()) {
+        sendPosted.fetchAndStoreOrdered(0);
+
+        /* A buffer pushed before the flag was cleared wouldn't have been posted. If the flag
+           was set again meanwhile, its sendData() is the one to write */
+        if (toSend.empty() || sendPosted.fetchAndStoreOrdered(1) != 0) {
+            if (closing) {
+                closeSocket();
+            }
+            return;
+        }
+
+        while (toSend.pop(b)) {
+            sending.push_back(b);
+        }
+    }
+
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(sending.size());
+    for (std::vector<QByteArray>::const_iterator it = sending.begin(); it != sending.end(); ++it) {
+        buffers.push_back(boost::asio::buffer(it->constData(), it->size()));
+    }
+
+    boost::asio::async_write(sock(), buffers,
+                      boost::bind(&SocketSQ::writeHandler, shared_from_this(), boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred));
 }
 
 #endif
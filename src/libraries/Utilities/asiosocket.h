@@ -5,13 +5,21 @@
 
 #include <QtCore>
 #include <iostream>
+#include <vector>
 #include <boost/asio.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
+#include "mpscqueue.h"
+
 class SocketManager;
 
-/* Never delete a Socket SQ directly */
+/* Never delete a Socket SQ directly.
+
+   The socket runs on the io_service it was created on, its handlers are all called from the
+   thread of that io_service. The public functions are for the main thread: what they need to
+   do on the socket is posted to the io_service. */
 class SocketSQ : public QObject, public boost::enable_shared_from_this<SocketSQ>
 {
     Q_OBJECT
@@ -58,43 +66,75 @@ private:
     SocketManager *manager;
     QString myip;
 
-    /* Only called by socket manager */
-    void fill();
+    /* Signals the main thread, unless it wasn't done reading since the last time */
+    void notify();
+    void notifyDisconnect();
+
+    /* Called in the thread of the io_service */
     void sendData();
+    void closeSocket();
 
     void readHandler(const boost::system::error_code& ec, std::size_t bytes_transferred);
     void writeHandler(const boost::system::error_code& ec, std::size_t bytes_transferred);
     void acceptHandler(const boost::system::error_code& ec);
 
     char innerBuffer[10000];
+    /* Received data not yet read by the main thread, from bufCounter */
     QByteArray buffer;
-    QByteArray toSend;
-    QByteArray sending;
-    QMutex m;
-    /* From where in the buffer to start reading. Gets incremented when you read chars one by one.
-        Counter is resetted when external actually reads a chunk. */
     int bufCounter;
+    QMutex m;
+    /* Set when active() was emitted, cleared when the main thread reads. The reads of the io_service
+       thread pile up in the buffer meanwhile, so the main thread gets them with a single event */
+    QAtomicInt notified;
+
+    /* Written by the main thread, consumed in the thread of the io_service. The buffers are shared
+       with the writer, and they go out in a single scatter/gather write */
+    MpscQueue<QByteArray> toSend;
+    /* Set by whoever posts sendData(), and cleared by it when there's nothing more to write */
+    QAtomicInt sendPosted;
+    /* Only used in the thread of the io_service */
+    std::vector<QByteArray> sending;
+    bool closing;
+
     volatile bool notifiedDced;
     volatile bool freeConnection;
     boost::asio::ip::tcp::socket *incoming;
 };
 
-class SocketManager : public QThread
+/* Runs the sockets on one io_service per thread, each with a thread of its own.
+   New sockets are given to the io_services in turn. */
+class SocketManager : public QObject
 {
     Q_OBJECT
 public:
-    SocketManager();
+    /* By default, one thread per core */
+    SocketManager(int threads = 0);
     ~SocketManager();
 
     SocketSQ::pointer createSocket();
     SocketSQ::pointer createServerSocket();
 
-    boost::asio::io_service io_service;
-protected:
-    void run();
-private slots:
+    /* Starts the threads */
+    void start();
+    int threadCount() const;
+
+    /* The io_service of the next socket */
+    boost::asio::io_service &nextService();
 private:
-    volatile bool finished;
+    class Worker : public QThread
+    {
+    public:
+        Worker();
+
+        boost::asio::io_service service;
+        /* Keeps the service running when it has nothing to do */
+        boost::scoped_ptr<boost::asio::io_service::work> work;
+    protected:
+        void run();
+    };
+
+    QVector<Worker*> workers;
+    int next;
 };
 
 typedef SocketSQ::pointer GenericSocket;
@@ -9,6 +9,8 @@ BaseAnalyzer::~BaseAnalyzer()
     /* Very important feature. If you don't do this it might crash.
         this makes the stillValid of Network redundant, but still.*/
     close();
+
+    delete deflater;
 }
 
 void BaseAnalyzer::connectTo(const QString &host, quint16 port)
@@ -19,6 +21,8 @@ void BaseAnalyzer::connectTo(const QString &host, quint16 port)
 
 void BaseAnalyzer::close() {
     if (dummy) {return;}
+    /* Messages like kicks are sent right before closing */
+    flushZipStream();
     socket().close();
 }
 
@@ -105,9 +109,73 @@ void BaseAnalyzer::setVersion(const ProtocolVersion &v)
 
 void BaseAnalyzer::sendPacket(const QByteArray &packet)
 {
+    if (deflater && packet.length() > 4) {
+        /* No use compressing twice the packets already compressed */
+        if (packet[4] == char(ZipCommand)) {
+            flushZipStream();
+        } else {
+            queueZipped(packet.mid(4));
+            return;
+        }
+    }
     emit packetToSend(packet);
 }
 
+void BaseAnalyzer::enableZipStream(const QByteArray &dictionary)
+{
+    if (dummy || deflater) {
+        return;
+    }
+
+    deflater = new ZipDeflater(dictionary);
+
+    if (!deflater->isValid()) {
+        delete deflater;
+        deflater = NULL;
+    }
+}
+
+void BaseAnalyzer::queueZipped(const QByteArray &command)
+{
+    if (zipBuffer.isEmpty()) {
+        /* Everything sent during this event loop iteration goes in the same batch */
+        QTimer::singleShot(0, this, SLOT(flushZipStream()));
+    }
+
+    const quint32 l = command.length();
+    char length[4] = {char(l >> 24), char(l >> 16), char(l >> 8), char(l)};
+
+    zipBuffer.append(length, 4);
+    zipBuffer.append(command);
+
+    if (zipBuffer.length() >= 64*1024) {
+        flushZipStream();
+    }
+}
+
+void BaseAnalyzer::flushZipStream()
+{
+    if (!deflater || zipBuffer.isEmpty()) {
+        return;
+    }
+
+    QByteArray compressed = deflater->compress(zipBuffer);
+    zipBuffer.clear();
+
+    if (compressed.isEmpty()) {
+        emit connectionError(UnknownCommand, tr("Compression error"));
+        return;
+    }
+
+    QByteArray tosend;
+    tosend.reserve(2 + compressed.length());
+    tosend.append(char(ZipCommand));
+    tosend.append(char(ZipStreamChunk));
+    tosend.append(compressed);
+
+    emit sendCommand(tosend);
+}
+
 void BaseAnalyzer::undelay()
 {
     delayCount -=1;
@@ -3,6 +3,7 @@
 
 #include <Utilities/network.h>
 #include <Utilities/coreclasses.h>
+#include <Utilities/zipstream.h>
 /* for ProtocolVersion */
 #include <PokemonInfo/networkstructs.h>
 
@@ -41,10 +42,21 @@ public:
     void swapIds(BaseAnalyzer *other);
     void setId(int id);
     void setVersion(const ProtocolVersion &version);
+    const ProtocolVersion &protocolVersion() const {
+        return version;
+    }
+
+    /* From then on, the commands sent are batched and compressed in a deflate stream
+       kept for the whole connection. Only to use if the other side said it supports it. */
+    void enableZipStream(const QByteArray &dictionary = QByteArray());
 
     /* Convenience functions to avoid writing a new one every time */
     inline void emitCommand(const QByteArray &command) {
-        emit sendCommand(command);
+        if (deflater) {
+            queueZipped(command);
+        } else {
+            emit sendCommand(command);
+        }
     }
 
     template <typename ...Params>
@@ -76,12 +88,27 @@ public slots:
 
     void undelay();
     void keepAlive(){}//do something
+
+    /* Sends the commands batched in the deflate stream */
+    void flushZipStream();
 protected:
     GenericNetwork &socket();
     const GenericNetwork &socket() const;
 
     virtual void dealWithCommand(const QByteArray &command);
 
+    enum ZipContent {
+        ZipSingleCommand = 0,
+        ZipMultipleCommands = 1,
+        ZipStreamChunk = 2
+    };
+
+    void queueZipped(const QByteArray &command);
+
+    ZipDeflater *deflater;
+    /* Commands waiting to go in the deflate stream, each prefixed by its length */
+    QByteArray zipBuffer;
+
     QLinkedList<QByteArray> delayedCommands;
     int delayCount;
 
@@ -94,7 +121,7 @@ protected:
 };
 
 template<class SocketClass>
-BaseAnalyzer::BaseAnalyzer(const SocketClass &sock, int id, bool dummy) : mysocket(new Network<SocketClass>(sock, id)), dummy(dummy)
+BaseAnalyzer::BaseAnalyzer(const SocketClass &sock, int id, bool dummy) : deflater(NULL), mysocket(new Network<SocketClass>(sock, id)), dummy(dummy)
 {
     socket().setParent(this);
     delayCount = 0;
@@ -136,7 +163,7 @@ void BaseAnalyzer::notify_expand(int command, const T& paramList)
         ++it;
     }
 
-    emit sendCommand(tosend);
+    emitCommand(tosend);
 }
 
 #endif // BASEANALYZER_H
@@ -1,12 +1,169 @@
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include "contextswitch.h"
 
+#if defined(MAP_ANON) && !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
 QMutex ContextSwitcher::guardian;
 
-ContextSwitcher::ContextSwitcher() : current_context(NULL), context_to_delete(NULL), finished(false)
+QMutex ContextStackPool::guardian;
+QHash<long, QVector<void *> > ContextStackPool::freeStacks;
+ContextStackPool::Stats ContextStackPool::statistics;
+
+long ContextStackPool::pageSize()
 {
-    connect(this, SIGNAL(finished()), SLOT(deleteLater()));
+#ifndef _WIN32
+    static long size = sysconf(_SC_PAGESIZE);
+    return size;
+#else
+    return 4096;
+#endif
+}
 
-    pauseController.release(1000);
+long ContextStackPool::roundSize(long size)
+{
+    long page = pageSize();
+    return (size + page - 1) / page * page;
+}
+
+void *ContextStackPool::acquire(long size)
+{
+    {
+        QMutexLocker l(&guardian);
+
+        statistics.inUse += 1;
+
+        QHash<long, QVector<void *> >::iterator it = freeStacks.find(size);
+        if (it != freeStacks.end() && !it->isEmpty()) {
+            void *stack = it->back();
+            it->pop_back();
+            statistics.cached -= 1;
+            statistics.reused += 1;
+            return stack;
+        }
+
+        statistics.allocated += 1;
+    }
+
+    return allocate(size);
+}
+
+void ContextStackPool::release(void *stack, long size)
+{
+    if (!stack) {
+        return;
+    }
+
+    /* Done outside of the lock, the stack is ours only */
+    long depth = measure(stack, size);
+
+    QMutexLocker l(&guardian);
+
+    statistics.inUse -= 1;
+    if (depth >= 0) {
+        statistics.measured += 1;
+        statistics.totalDepth += depth;
+        if (depth > statistics.highWaterMark) {
+            statistics.highWaterMark = depth;
+        }
+    }
+
+    QVector<void *> &stacks = freeStacks[size];
+    if (stacks.size() < maxCached) {
+        stacks.push_back(stack);
+        statistics.cached += 1;
+        return;
+    }
+
+    l.unlock();
+    deallocate(stack, size);
+}
+
+ContextStackPool::Stats ContextStackPool::stats()
+{
+    QMutexLocker l(&guardian);
+    return statistics;
+}
+
+QString ContextStackPool::report()
+{
+    Stats s = stats();
+
+    QString ret = QString("Coroutine stacks: %1 in use, %2 cached, %3 allocated, %4 reused").arg(s.inUse).arg(s.cached).arg(s.allocated).arg(s.reused);
+    if (s.measured > 0) {
+        ret += QString(", high-water mark %1 KiB (average %2 KiB)").arg(s.highWaterMark/1024).arg(s.totalDepth/s.measured/1024);
+    }
+
+    return ret;
+}
+
+void *ContextStackPool::allocate(long size)
+{
+#if !defined(_WIN32) && !defined(CORO2)
+    long guard = pageSize();
+    char *base = (char*) mmap(NULL, size + guard, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (base == MAP_FAILED) {
+        qFatal("Context Stack Pool: unable to map a stack of %ld bytes", size);
+    }
+    /* Stacks grow downwards, so the guard page is at the bottom */
+    if (mprotect(base, guard, PROT_NONE) != 0) {
+        qWarning() << "Context Stack Pool: unable to protect the guard page of a stack";
+    }
+
+    return base + guard;
+#else
+    return malloc(size);
+#endif
+}
+
+void ContextStackPool::deallocate(void *stack, long size)
+{
+#if !defined(_WIN32) && !defined(CORO2)
+    long guard = pageSize();
+    munmap((char*)stack - guard, size + guard);
+#else
+    (void) size;
+    free(stack);
+#endif
+}
+
+long ContextStackPool::measure(void *stack, long size)
+{
+#if defined(Q_OS_LINUX) && !defined(CORO2)
+    long page = pageSize();
+    QVarLengthArray<unsigned char, 256> resident(size / page);
+
+    if (mincore(stack, size, resident.data()) != 0) {
+        return -1;
+    }
+
+    /* The lowest page used by the stack tells how deep it went */
+    long depth = 0;
+    for (int i = 0; i < resident.size(); i++) {
+        if (resident[i] & 1) {
+            depth = size - i * page;
+            break;
+        }
+    }
+
+    /* Gives the pages back, the next coroutine starts with a clean stack and we can measure it too */
+    madvise(stack, size, MADV_DONTNEED);
+
+    return depth;
+#else
+    (void) stack;
+    (void) size;
+    return -1;
+#endif
+}
+
+ContextSwitcher::ContextSwitcher() : pauseCount(0), finished(false)
+{
 }
 
 ContextSwitcher::~ContextSwitcher()
@@ -15,29 +172,243 @@ ContextSwitcher::~ContextSwitcher()
     /* Normally, all contexts should have disappeared before though */
     finish();
 
-    //to suppress "no effect" warning
-    (void) coro_destroy(&main_context);
+    foreach(ContextWorker *worker, workers) {
+        worker->wait();
+        delete worker;
+    }
+    workers.clear();
 
     qDebug() << "End Deleting a context switcher ";
 }
 
 void ContextSwitcher::finish()
 {
-    foreach(ContextCallee *context, contexts) {
+    contextsGuardian.lock();
+    QSet<ContextCallee *> remaining = contexts;
+    contextsGuardian.unlock();
+
+    foreach(ContextCallee *context, remaining) {
         terminate(context);
     }
+    contextsGuardian.lock();
     contexts.clear();
+    contextsGuardian.unlock();
+
     finished = true;
-    streamController.release(1);
+    foreach(ContextWorker *worker, workers) {
+        worker->wake();
+    }
+}
+
+int ContextSwitcher::maxWorkers()
+{
+#if defined(CORO2) || defined(CORO_PTHREAD)
+    /* Those backends have all the coroutines share a single lock / thread */
+    return 1;
+#else
+    return 64;
+#endif
+}
+
+void ContextSwitcher::start(int count)
+{
+    if (count <= 0) {
+        count = QThread::idealThreadCount();
+    }
+    if (count > maxWorkers()) {
+        qWarning() << "Context Switcher: using" << maxWorkers() << "worker(s) instead of" << count;
+        count = maxWorkers();
+    }
+    count = qMax(count, 1);
+
+    for (int i = 0; i < count; i++) {
+        ContextWorker *worker = new ContextWorker(this);
+        /* In case we were paused before being started */
+        for (int j = 0; j < pauseCount; j++) {
+            worker->pauseController.acquire();
+        }
+        workers.push_back(worker);
+    }
+
+    foreach(ContextWorker *worker, workers) {
+        worker->start();
+    }
+}
+
+int ContextSwitcher::workerCount() const
+{
+    return workers.size();
+}
+
+void ContextSwitcher::pause()
+{
+    pauseCount += 1;
+    foreach(ContextWorker *worker, workers) {
+        worker->pauseController.acquire();
+    }
+}
+
+void ContextSwitcher::unpause()
+{
+    pauseCount -= 1;
+    foreach(ContextWorker *worker, workers) {
+        worker->pauseController.release();
+    }
+}
+
+void ContextSwitcher::enqueue(const pair &p)
+{
+    if (workers.isEmpty()) {
+        qCritical() << "Context Switcher: scheduling a context before starting the workers!";
+        return;
+    }
+
+    /* A context goes back to the worker that ran it last, the new ones are spread */
+    ContextWorker *target = p.first->worker.loadAcquire();
+    if (!target) {
+        target = workers[unsigned(nextWorker.fetchAndAddRelaxed(1)) % workers.size()];
+    }
+
+    target->push(p);
+
+    if (target->idle.loadAcquire()) {
+        return;
+    }
+
+    /* The worker is busy, someone idle can steal the context in the meantime */
+    foreach(ContextWorker *worker, workers) {
+        if (worker != target && worker->idle.loadAcquire()) {
+            worker->wake();
+            break;
+        }
+    }
+}
+
+bool ContextSwitcher::steal(ContextWorker *thief, pair &p)
+{
+    if (workers.size() <= 1) {
+        return false;
+    }
+
+    QMutexLocker l(&contextsGuardian);
+
+    int index = workers.indexOf(thief);
+    for (int i = 1; i < workers.size(); i++) {
+        ContextWorker *victim = workers[(index + i) % workers.size()];
+
+        if (victim->takeBack(p)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ContextSwitcher::claim(ContextWorker *worker, const pair &p)
+{
+    QMutexLocker l(&contextsGuardian);
+
+    ContextCallee *c = p.first;
+
+    if (p.second == Start) {
+        contexts.insert(c);
+    } else if (!contexts.contains(c)) {
+        return false;
+    }
+
+    if (c->running) {
+        /* Pinned to the worker running it, it'll have it once the context yields */
+        c->worker.loadAcquire()->push(p);
+        return false;
+    }
+
+    if (p.second == Cease) {
+        contexts.remove(c);
+        c->needsToExit = true;
+    }
+
+    c->running = true;
+    c->worker.storeRelease(worker);
+
+    return true;
+}
+
+void ContextSwitcher::release(ContextCallee *c)
+{
+    QMutexLocker l(&contextsGuardian);
+    c->running = false;
+}
+
+void ContextSwitcher::runNewCalleeS(void *p)
+{
+    ContextCallee *callee = (ContextCallee*) p;
+
+    try {
+        callee->run();
+    } catch (ContextQuitEx) {
+
+    }
+
+    callee->ctx->contextsGuardian.lock();
+    callee->ctx->contexts.remove(callee);
+    callee->ctx->contextsGuardian.unlock();
+
+    /* We can't use the stack after we set finished() to true, because then this might get deleted.
+       So we will do that in the main context instead of here. The callee may have been moved
+       to another worker since it started, so ask the one currently running it. */
+    ContextWorker *worker = callee->worker.loadAcquire();
+    worker->context_to_delete = callee;
+    /* Gets back to the main context */
+    worker->yield();
+}
+
+void ContextSwitcher::runNewCallee(ContextCallee *callee)
+{
+    enqueue(pair (callee, Start));
+}
+
+void ContextSwitcher::schedule(ContextCallee *callee)
+{
+    enqueue(pair (callee, Continue));
+}
+
+void ContextSwitcher::terminate(ContextCallee *callee)
+{
+    enqueue(pair (callee, Cease));
+}
+
+void ContextSwitcher::create_context(coro_context *c, coro_func function, void *param, void *stack, long stacksize)
+{
+    (void) c;
+    (void) function;
+    (void) param;
+    (void) stack;
+    (void) stacksize;
+#ifndef CORO2
+    guardian.lock();
+    coro_create(c, function, param, stack, stacksize);
+    guardian.unlock();
+#endif
+}
+
+ContextWorker::ContextWorker(ContextSwitcher *owner) : owner(owner), current_context(NULL), context_to_delete(NULL), idle(0)
+{
+    pauseController.release(1000);
+}
+
+ContextWorker::~ContextWorker()
+{
+    //to suppress "no effect" warning
+    (void) coro_destroy(&main_context);
 }
 
-void ContextSwitcher::run()
+void ContextWorker::run()
 {
 #ifdef CORO2
     coro_create(&main_context);
     coro_main(&main_context);
 #else
-    create_context(&main_context);
+    owner->create_context(&main_context);
 #endif
     pauseController.acquire(1000);
     forever {
@@ -52,124 +423,107 @@ void ContextSwitcher::run()
          * they will acquire() the pause controller and lock the loop
          * right here */
         pauseController.release(1000);
-        /* Pauses the thread until a new task is scheduled */
-        streamController.acquire(1);
-        pauseController.acquire(1000);
 
-        if (finished) {
-            goto end;
+        ContextSwitcher::pair p;
+        bool found = take(p) || owner->steal(this, p);
+
+        if (!found) {
+            /* Pauses the thread until a new task is scheduled */
+            idle.storeRelease(1);
+            if (!take(p)) {
+                streamController.acquire(1);
+            } else {
+                found = true;
+            }
+            idle.storeRelease(0);
         }
+        pauseController.acquire(1000);
 
-        ownGuardian.lock();
-
-        if (scheduled.size() == 0) {
-            ownGuardian.unlock();
-            continue;
+        if (owner->finished) {
+            break;
         }
 
-        pair p = scheduled.takeFirst();
-
-        ownGuardian.unlock();
-
-        if (!contexts.contains(p.first) && p.second != Start) {
+        if (!found || !owner->claim(this, p)) {
             continue;
         }
 
         switch (p.second) {
-        case Cease: {
-            contexts.remove(p.first);
-            p.first->needsToExit = true;
-
+        case ContextSwitcher::Cease:
+        case ContextSwitcher::Continue:
             switch_context(p.first);
             break;
-        }
-        case Start: {
-            contexts.insert(p.first);
-            startpair sp(this, p.first);
+        case ContextSwitcher::Start: {
 #ifdef CORO2
             coro_create(&p.first->context);
             current_context = p.first;
-            coro_start(&main_context, &(p.first->context), &ContextSwitcher::runNewCalleeS, &sp);
+            coro_start(&main_context, &(p.first->context), &ContextSwitcher::runNewCalleeS, p.first);
 #else
-            create_context(&p.first->context, &ContextSwitcher::runNewCalleeS, &sp, p.first->stack, p.first->stacksize);
+            owner->create_context(&p.first->context, &ContextSwitcher::runNewCalleeS, p.first, p.first->stack, p.first->stacksize);
             switch_context(p.first);
 #endif
             break;
         }
-        case Continue:
-            switch_context(p.first);
-            break;
         }
+
+        owner->release(p.first);
     }
-    end:;
     pauseController.release(1000);
 }
 
-void ContextSwitcher::pause()
+void ContextWorker::push(const ContextSwitcher::pair &p)
 {
-    pauseController.acquire();
-}
+    ownGuardian.lock();
+    scheduled.push_back(p);
+    ownGuardian.unlock();
 
-void ContextSwitcher::unpause()
-{
-    pauseController.release();
+    wake();
 }
 
-void ContextSwitcher::switch_context(ContextCallee *new_context)
+bool ContextWorker::take(ContextSwitcher::pair &p)
 {
-    current_context = new_context;
-    coro_transfer(&main_context, &current_context->context);
+    QMutexLocker l(&ownGuardian);
+
+    if (scheduled.isEmpty()) {
+        return false;
+    }
+
+    p = scheduled.takeFirst();
+    return true;
 }
 
-void ContextSwitcher::runNewCalleeS(void *p)
+bool ContextWorker::takeBack(ContextSwitcher::pair &p)
 {
-    /* It is important to copy the pair here, because when we will switch back to the main
-        context (within run()), the variable p will be deallocated */
-    startpair sp = * ((startpair*) p);
+    /* Called with the owner's contextsGuardian locked */
+    QMutexLocker l(&ownGuardian);
 
-    try {
-        sp.second->run();
-    } catch (ContextQuitEx) {
-
-    }
-    /* We can't use the stack after we set finished() to true, because then this might get deleted.
-       Not using the stack means not using sp.
-       So we will do that in the main context instead of here */
-    sp.first->contexts.remove(sp.second);
-    sp.first->context_to_delete = sp.second;
-    /* Gets back to the main context */
-    sp.first->yield();
-}
+    for (int i = scheduled.size() - 1; i >= 0; i--) {
+        const ContextSwitcher::pair &candidate = scheduled[i];
 
+        if (candidate.second != ContextSwitcher::Start) {
+            if (!owner->contexts.contains(candidate.first) || candidate.first->running) {
+                continue;
+            }
+        }
 
-void ContextSwitcher::runNewCallee(ContextCallee *callee)
-{
-    ownGuardian.lock();
-    scheduled.push_back(pair (callee, Start));
-    ownGuardian.unlock();
+        p = scheduled.takeAt(i);
+        return true;
+    }
 
-    streamController.release(1);
+    return false;
 }
 
-void ContextSwitcher::schedule(ContextCallee *callee)
+void ContextWorker::wake()
 {
-    ownGuardian.lock();
-    scheduled.push_back(pair (callee, Continue));
-    ownGuardian.unlock();
-
     streamController.release(1);
 }
 
-void ContextSwitcher::terminate(ContextCallee *callee)
+void ContextWorker::switch_context(ContextCallee *new_context)
 {
-    ownGuardian.lock();
-    scheduled.push_back(pair (callee, Cease));
-    ownGuardian.unlock();
-
-    streamController.release(1);
+    current_context = new_context;
+    coro_transfer(&main_context, &current_context->context);
 }
 
-void ContextSwitcher::yield()
+void ContextWorker::yield()
 {
     if (!current_context) {
         qCritical() << "Context Switcher: No current context while yielding!";
@@ -182,23 +536,9 @@ void ContextSwitcher::yield()
     coro_transfer(&tmp->context, &main_context);
 }
 
-void ContextSwitcher::create_context(coro_context *c, coro_func function, void *param, void *stack, long stacksize)
-{
-    (void) c;
-    (void) function;
-    (void) param;
-    (void) stack;
-    (void) stacksize;
-#ifndef CORO2
-    guardian.lock();
-    coro_create(c, function, param, stack, stacksize);
-    guardian.unlock();
-#endif
-}
-
-ContextCallee::ContextCallee(long stacksize) : ctx(NULL), stacksize(stacksize), needsToExit(false), _finished(false)
+ContextCallee::ContextCallee(long stacksize) : ctx(NULL), worker(NULL), running(false), stacksize(ContextStackPool::roundSize(stacksize)), needsToExit(false), _finished(false)
 {
-    stack = malloc(stacksize);
+    stack = ContextStackPool::acquire(this->stacksize);
 }
 
 ContextCallee::~ContextCallee()
@@ -211,7 +551,7 @@ ContextCallee::~ContextCallee()
     /* Not needed unless you use PThreads, because it causes a warning otherwise it's been warning'd out :/. */
     (void) coro_destroy(&context);
 
-    free(stack);
+    ContextStackPool::release(stack, stacksize);
     //qDebug() << "Destroyed context callee " << this;
 }
 
@@ -235,7 +575,8 @@ void ContextCallee::schedule()
 
 void ContextCallee::yield()
 {
-    ctx->yield();
+    /* We may be resumed by a different worker than the one we yield to */
+    worker.loadAcquire()->yield();
     /* If for example the main thread or w/e requested the exit */
     if (needsToExit) {
         exit();
@@ -83,14 +83,70 @@ int main()
 */
 
 class ContextCallee;
+class ContextWorker;
 
 class ContextQuitEx {
 
 };
 
-class ContextSwitcher : public QThread
+/*
+  Recycles the stacks of the coroutines, so that battles starting and ending all the time
+  don't make the allocator churn.
+
+  On unix the stacks are mmap'd with a guard page below them: overflowing the stack crashes
+  right away instead of silently corrupting whatever was allocated next to it. When a stack is
+  given back, the pages the coroutine touched are counted to know how deep it went (the high-water
+  mark), and they are then handed back to the system. The mapping itself stays in the pool for the
+  next coroutine.
+*/
+class ContextStackPool
+{
+public:
+    struct Stats {
+        Stats() : allocated(0), reused(0), measured(0), inUse(0), cached(0), highWaterMark(0), totalDepth(0) {}
+
+        quint64 allocated, reused, measured;
+        int inUse, cached;
+        /* In bytes. The deepest any stack went, and the sum of all the depths measured */
+        long highWaterMark;
+        quint64 totalDepth;
+    };
+
+    /* Stacks are allocated in whole pages, call that on the size before acquiring */
+    static long roundSize(long size);
+    static void *acquire(long size);
+    static void release(void *stack, long size);
+
+    static Stats stats();
+    /* One line summary, for logging */
+    static QString report();
+
+    /* Number of unused stacks kept for each size, the others are freed */
+    static const int maxCached = 256;
+private:
+    static void *allocate(long size);
+    static void deallocate(void *stack, long size);
+    /* Returns how many bytes of the stack were used, or -1 if unknown */
+    static long measure(void *stack, long size);
+    static long pageSize();
+
+    static QMutex guardian;
+    static QHash<long, QVector<void *> > freeStacks;
+    static Stats statistics;
+};
+
+/*
+  The ContextSwitcher runs its coroutines on a pool of worker threads.
+
+  Each worker has its own queue of scheduled contexts. A context that is rescheduled goes back
+  in the queue of the last worker that ran it, but a worker with nothing to do will steal work
+  from the back of the other queues. A context is only ever run by one worker at a time, but when
+  it yields it may be continued by another worker.
+*/
+class ContextSwitcher
 {
     friend class ContextCallee;
+    friend class ContextWorker;
 public:
     enum Scheduling {
         Start = 0,
@@ -99,56 +155,98 @@ public:
     };
 
     typedef QPair<ContextCallee *, Scheduling> pair;
-    typedef QPair<ContextSwitcher *, ContextCallee *> startpair;
 
     ContextSwitcher();
     ~ContextSwitcher();
 
     void finish();
 
-    /* Starts the main loop. */
-    void run();
+    /* Starts the worker threads. */
+    void start(int workers = 1);
+    int workerCount() const;
 
-    /* pause/unpause the whole thing thread. pausing may lock while the current context
-     * finishes its task */
+    /* pause/unpause all the worker threads. pausing may lock while the current contexts
+     * finish their task */
     void pause();
     void unpause();
 
-    /* Thread safe. Ends the run() by throwing an exception, that is caught. It will be executed in the ContextSwitcher thread
-        so it might not execute directly, but will do as soon as the current ContextCallee yields. */
+    /* Thread safe. Ends the run() by throwing an exception, that is caught. It will be executed in a worker thread
+        so it might not execute directly, but will do as soon as the ContextCallee yields. */
     void terminate(ContextCallee *c);
 private:
     /* Creating contexts is not even reentrant, but with a mutex
        it's fine */
     static QMutex guardian;
-    QMutex ownGuardian;
-    QSemaphore streamController, pauseController;
+    /* Protects contexts, and who is running which context */
+    QMutex contextsGuardian;
 
-    coro_context main_context;
     QSet<ContextCallee *> contexts;
-    ContextCallee *current_context;
-    ContextCallee *context_to_delete;
+    QVector<ContextWorker *> workers;
+    QAtomicInt nextWorker;
+    int pauseCount;
 
-    QList<pair> scheduled;
     bool finished;
 
     void create_context(coro_context *c, coro_func function=NULL, void *param=NULL, void *stack=NULL, long stacksize=0);
-    void switch_context(ContextCallee *new_context);
+
+    /* Puts the callee in the queue of a worker and wakes someone up to run it */
+    void enqueue(const pair &p);
+    /* Called by an idle worker, takes a context to run from another worker's queue */
+    bool steal(ContextWorker *thief, pair &p);
+    /* Marks the callee as run by the worker. Returns false if the callee
+       isn't to be run by it (finished, or running elsewhere in which case it's requeued) */
+    bool claim(ContextWorker *worker, const pair &p);
+    /* Releases the callee once it gave the hand back to the worker */
+    void release(ContextCallee *c);
+    /* The coroutine backends that can't run in parallel are limited to one worker */
+    static int maxWorkers();
 protected:
     /* Adds the callee and runs it */
     void runNewCallee(ContextCallee *callee);
 
-    /* Takes a QPair<ContextSwitcher*, ContextCalle*> * as a parameter. Freeing the arg if dynamicly allocated
-       is the responsability of the caller */
+    /* Takes the ContextCallee * as a parameter */
     static void runNewCalleeS(void *);
 
     void schedule(ContextCallee *c);
+};
+
+/* One of the threads of the ContextSwitcher */
+class ContextWorker : public QThread
+{
+    friend class ContextSwitcher;
+    friend class ContextCallee;
+public:
+    ContextWorker(ContextSwitcher *owner);
+    ~ContextWorker();
+
+    /* Starts the main loop. */
+    void run();
+private:
+    ContextSwitcher *owner;
+
+    coro_context main_context;
+    ContextCallee *current_context;
+    ContextCallee *context_to_delete;
+
+    QMutex ownGuardian;
+    QSemaphore streamController, pauseController;
+    QList<ContextSwitcher::pair> scheduled;
+    QAtomicInt idle;
+
+    void push(const ContextSwitcher::pair &p);
+    bool take(ContextSwitcher::pair &p);
+    /* Takes from the back of the queue a context not running anywhere */
+    bool takeBack(ContextSwitcher::pair &p);
+    void wake();
+
+    void switch_context(ContextCallee *new_context);
     void yield();
 };
 
 class ContextCallee : public QObject
 {
     friend class ContextSwitcher;
+    friend class ContextWorker;
 public:
     ContextCallee(long stacksize = 500*1024);
     ~ContextCallee();
@@ -178,6 +276,10 @@ protected:
     void exit();
 private:
     ContextSwitcher *ctx;
+    /* The worker running the context, or the last one that did */
+    QAtomicPointer<ContextWorker> worker;
+    /* Set while a worker is running the context */
+    bool running;
 
     long stacksize;
     void *stack;
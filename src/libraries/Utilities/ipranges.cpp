@@ -0,0 +1,135 @@
+#include <cstring>
+
+#include <QHostAddress>
+
+#include "ipranges.h"
+
+/* Bytes of the address as IPv6, false if it's not an address */
+static bool toBytes(const QString &ip, Q_IPV6ADDR &bytes, bool &v4)
+{
+    QHostAddress address;
+
+    if (!address.setAddress(ip)) {
+        return false;
+    }
+
+    v4 = address.protocol() == QAbstractSocket::IPv4Protocol;
+    if (v4) {
+        quint32 a = address.toIPv4Address();
+
+        memset(&bytes, 0, sizeof(bytes));
+        bytes[10] = bytes[11] = 0xFF;
+        bytes[12] = a >> 24;
+        bytes[13] = a >> 16;
+        bytes[14] = a >> 8;
+        bytes[15] = a;
+    } else {
+        bytes = address.toIPv6Address();
+    }
+
+    return true;
+}
+
+static inline int bit(const Q_IPV6ADDR &bytes, int i)
+{
+    return (bytes[i/8] >> (7 - i%8)) & 1;
+}
+
+IpRanges::IpRanges() : nodes(1)
+{
+}
+
+IpRanges::IpRanges(const QStringList &ranges) : nodes(1)
+{
+    foreach(const QString &range, ranges) {
+        insert(range);
+    }
+}
+
+bool IpRanges::insert(const QString &range)
+{
+    QString trimmed = range.trimmed();
+
+    if (trimmed.isEmpty()) {
+        return true;
+    }
+
+    int slash = trimmed.indexOf('/');
+    Q_IPV6ADDR bytes;
+    bool v4;
+
+    if (!toBytes(slash == -1 ? trimmed : trimmed.left(slash), bytes, v4)) {
+        names.insert(trimmed);
+        ranges.push_back(trimmed);
+        return true;
+    }
+
+    int length = 128;
+    if (slash != -1) {
+        bool ok;
+        length = trimmed.mid(slash+1).toInt(&ok);
+
+        if (!ok || length < 0 || length > (v4 ? 32 : 128)) {
+            return false;
+        }
+        if (v4) {
+            length += 96;
+        }
+    }
+
+    int node = 0;
+    for (int i = 0; i < length && !nodes[node].end; i++) {
+        int b = bit(bytes, i);
+
+        if (!nodes[node].child[b]) {
+            nodes[node].child[b] = nodes.size();
+            nodes.push_back(Node());
+        }
+        node = nodes[node].child[b];
+    }
+    nodes[node].end = true;
+
+    ranges.push_back(trimmed);
+    return true;
+}
+
+bool IpRanges::contains(const QString &ip) const
+{
+    if (names.contains(ip)) {
+        return true;
+    }
+
+    Q_IPV6ADDR bytes;
+    bool v4;
+
+    /* No need to parse the address when there are only names */
+    if ((nodes.size() == 1 && !nodes[0].end) || !toBytes(ip, bytes, v4)) {
+        return false;
+    }
+
+    int node = 0;
+    for (int i = 0; i < 128; i++) {
+        if (nodes[node].end) {
+            return true;
+        }
+        node = nodes[node].child[bit(bytes, i)];
+        if (!node) {
+            return false;
+        }
+    }
+
+    return nodes[node].end;
+}
+
+void IpRanges::clear()
+{
+    nodes.resize(1);
+    nodes[0] = Node();
+    names.clear();
+    ranges.clear();
+}
+
+bool IpRanges::isEmpty() const
+{
+    return ranges.isEmpty();
+}
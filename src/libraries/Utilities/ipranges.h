@@ -0,0 +1,47 @@
+#ifndef IPRANGES_H
+#define IPRANGES_H
+
+#include <QVector>
+#include <QSet>
+#include <QStringList>
+
+/* Set of IP ranges in CIDR notation ("10.0.0.0/8", "2001:db8::/32", or a single address),
+   looked up in a binary trie over the bits of the addresses.
+
+   IPv4 addresses are stored as IPv4-mapped IPv6 ones (::ffff:a.b.c.d), so that
+   an IPv4 range also matches the addresses of dual stack sockets. Entries that
+   aren't addresses, like "localhost", only match the same string */
+class IpRanges
+{
+public:
+    IpRanges();
+    IpRanges(const QStringList &ranges);
+
+    /* Returns false if the range is an address with an invalid prefix length */
+    bool insert(const QString &range);
+    bool contains(const QString &ip) const;
+    void clear();
+
+    bool isEmpty() const;
+    /* The ranges as they were inserted */
+    const QStringList &toStringList() const {
+        return ranges;
+    }
+private:
+    struct Node {
+        Node() : end(false) {
+            child[0] = child[1] = 0;
+        }
+
+        /* Indexes in nodes, 0 when there's none as the root can't be a child */
+        int child[2];
+        /* A range ends here, all the addresses below match */
+        bool end;
+    };
+
+    QVector<Node> nodes;
+    QSet<QString> names;
+    QStringList ranges;
+};
+
+#endif // IPRANGES_H
@@ -0,0 +1,72 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <QAtomicPointer>
+
+/* Queue with any number of threads pushing and a single one popping, without locks.
+
+   Pushing is one atomic exchange: the new node becomes the head, and is then linked to
+   the previous head. Between the two a consumer sees the queue as empty up to that node,
+   so a producer that needs to wake the consumer must do it after push() returns.
+
+   Only the consumer may call pop() and empty(). */
+template <class T>
+class MpscQueue
+{
+public:
+    MpscQueue() : tail(new Node()) {
+        head.storeRelease(tail);
+    }
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+            ;
+        }
+        delete tail;
+    }
+
+    void push(const T &value) {
+        Node *n = new Node(value);
+        Node *prev = head.fetchAndStoreOrdered(n);
+        prev->next.storeRelease(n);
+    }
+
+    bool pop(T &value) {
+        Node *next = tail->next.loadAcquire();
+
+        if (!next) {
+            return false;
+        }
+
+        value = next->value;
+        next->value = T();
+
+        /* next becomes the placeholder in front of the queue */
+        delete tail;
+        tail = next;
+
+        return true;
+    }
+
+    bool empty() const {
+        return !tail->next.loadAcquire();
+    }
+private:
+    struct Node {
+        Node() : next(nullptr) {}
+        Node(const T &value) : next(nullptr), value(value) {}
+
+        QAtomicPointer<Node> next;
+        T value;
+    };
+
+    QAtomicPointer<Node> head;
+    /* Owned by the consumer, its value was already popped */
+    Node *tail;
+
+    MpscQueue(const MpscQueue &);
+    MpscQueue &operator=(const MpscQueue &);
+};
+
+#endif // MPSCQUEUE_H
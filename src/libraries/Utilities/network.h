@@ -38,6 +38,7 @@ public slots:
     virtual void send(const QByteArray &message){(void) message;}
     virtual void sendPacket(const QByteArray&){}
     virtual void onSocketConnected(){}
+    virtual void flushSends(){}
 };
 
 template <class S>
@@ -71,15 +72,30 @@ public:
     virtual void manageError(QAbstractSocket::SocketError);
     virtual void send(const QByteArray &message);
     virtual void sendPacket(const QByteArray&);
+    /* Writes what was queued by send() / sendPacket() to the socket */
+    virtual void flushSends();
 private:
     void makeSocketConnections();
+    void scheduleFlush();
     void attributeIp();
+    /* Appends everything available on the socket to the receive buffer */
+    void readAvailable();
 
     /* internal socket */
     S mysocket;
     /* internal variables for the protocol */
     bool commandStarted;
     quint32 remainingLength;
+    /* Data received and not yet handed out as commands, from receivePos. It starts
+       with the body of the current command if commandStarted, otherwise with its length.
+       The position is a member so that commands handed out in a nested call (if a receiver
+       runs an event loop) aren't handed out again. */
+    QByteArray receiveBuffer;
+    int receivePos;
+    /* Framed commands waiting to be written, all the ones sent during the same
+       event loop iteration go to the socket in a single write */
+    QByteArray sendBuffer;
+    bool flushScheduled;
     /* errors stored when disconnected */
     int myerror;
     QString myerrorString;
@@ -100,7 +116,7 @@ private:
 #include "antidos.h"
 
 template <class S>
-Network<S>::Network(S sock, int id) : mysocket(sock), commandStarted(false), myid(id), stillValid(true)
+Network<S>::Network(S sock, int id) : mysocket(sock), commandStarted(false), remainingLength(0), receivePos(0), flushScheduled(false), myid(id), stillValid(true)
 {
     makeSocketConnections();
 }
@@ -175,6 +191,8 @@ void Network<S>::manageError(QAbstractSocket::SocketError err)
 template <class S>
 void Network<S>::close() {
     //qDebug() << "beginning to close a network " << this;
+    /* Messages like kicks or wrong password are sent right before closing */
+    flushSends();
     stillValid = false;
     if (socket()) {
         //qDebug() << "valid socket " << this;
@@ -265,6 +283,7 @@ template <class S>
 void Network<S>::onDisconnect()
 {
     stillValid = false;
+    sendBuffer.clear();
     if (socket()) {
         S sock = mysocket;
         mysocket = S(0);
@@ -283,40 +302,80 @@ void Network<S>::onSocketConnected()
     emit connected();
 }
 
+template <class S>
+void Network<S>::readAvailable()
+{
+    receiveBuffer.append(socket()->read(socket()->bytesAvailable()));
+}
+
+template <>
+inline void Network<QTcpSocket*>::readAvailable()
+{
+    qint64 available = socket()->bytesAvailable();
+
+    if (available <= 0) {
+        return;
+    }
+
+    /* Read straight at the end of the buffer, no intermediate copy */
+    int size = receiveBuffer.length();
+    receiveBuffer.resize(size + int(available));
+    qint64 read = socket()->read(receiveBuffer.data() + size, available);
+    receiveBuffer.resize(size + int(qMax(read, qint64(0))));
+}
+
 template <class S>
 void Network<S>::onReceipt()
 {
-    if (stillValid && socket())
-    {
+    if (!stillValid || !socket()) {
+        return;
+    }
+
+    readAvailable();
+
+    /* Hands out all the complete commands in one go */
+    while (stillValid && socket()) {
         if (commandStarted == false) {
             /* There it's a new message we are receiving.
                To start receiving it we must know its length, i.e. the 4 first bytes */
-            if (socket()->bytesAvailable() < 4) {
-                return;
+            if (receiveBuffer.length() - receivePos < 4) {
+                break;
             }
-            /* Ok now we can start */
-            commandStarted=true;
-            /* getting the length of the message */
-            char c1, c2, c3, c4;
-            socket()->getChar(&c1), socket()->getChar(&c2); socket()->getChar(&c3), socket()->getChar(&c4);
-            remainingLength= (uchar(c1) << 24) + (uchar(c2) << 16) + (uchar(c3) << 8) + uchar(c4);
-
-            /* Just a little check :p */
+
+            const uchar *c = (const uchar*) receiveBuffer.constData() + receivePos;
+            remainingLength = (quint32(c[0]) << 24) + (c[1] << 16) + (c[2] << 8) + c[3];
+            receivePos += 4;
+            commandStarted = true;
+
+            /* Just a little check :p, before waiting for the whole command */
             if (AntiDos::obj() &&  myid > 0 && !AntiDos::obj()->transferBegin(myid, remainingLength, ip())) {
+                /* We're being kicked, no use keeping what was sent */
+                receiveBuffer.clear();
+                receivePos = 0;
                 return;
             }
+        }
 
-            /* Recursive call to write less code =) */
-            onReceipt();
-        } else {
-            /* Checking if the command is complete! */
-            if (socket()->bytesAvailable() >= remainingLength) {
-                emit isFull(socket()->read(remainingLength));
-                commandStarted = false;
-                /* Recursive call to spare code =), there may be still data pending */
-                onReceipt();
-            }
+        /* Checking if the command is complete! */
+        if (quint32(receiveBuffer.length() - receivePos) < remainingLength) {
+            break;
         }
+
+        commandStarted = false;
+        /* Copied out, as the receivers may keep it */
+        QByteArray command = receiveBuffer.mid(receivePos, remainingLength);
+        receivePos += remainingLength;
+
+        emit isFull(command);
+    }
+
+    if (!stillValid || !socket() || receivePos >= receiveBuffer.length()) {
+        receiveBuffer.clear();
+        receivePos = 0;
+    } else if (receivePos > 0) {
+        /* Only what's left of the last command is moved */
+        receiveBuffer.remove(0, receivePos);
+        receivePos = 0;
     }
 }
 
@@ -357,21 +416,12 @@ void Network<S>::send(const QByteArray &message)
 {
     if (!isConnected())
         return;
-    quint32 length = message.length();
-    uchar c1, c2, c3, c4;
-    c1 = length & 0xFF;
-    length >>= 8;
-    c2 = length & 0xFF;
-    length >>= 8;
-    c3 = length & 0xFF;
-    length >>= 8;
-    c4 = length & 0xFF;
-
-    socket()->putChar(c4);
-    socket()->putChar(c3);
-    socket()->putChar(c2);
-    socket()->putChar(c1);
-    socket()->write(message);
+    const quint32 length = message.length();
+    const char header[4] = {char(length >> 24), char(length >> 16), char(length >> 8), char(length)};
+
+    sendBuffer.append(header, 4);
+    sendBuffer.append(message);
+    scheduleFlush();
 }
 
 template <class S>
@@ -390,8 +440,41 @@ template <class S>
 void Network<S>::sendPacket(const QByteArray &p)
 {
     if (socket()) {
-        socket()->write(p);
+        /* When nothing else is queued, the packet is shared instead of copied, which is
+           what broadcasts rely on to hand the same packet to all the connections */
+        sendBuffer.append(p);
+        scheduleFlush();
+    }
+}
+
+template <class S>
+void Network<S>::scheduleFlush()
+{
+    /* Big enough, no use waiting */
+    if (sendBuffer.length() >= 64*1024) {
+        flushSends();
+        return;
+    }
+
+    if (!flushScheduled) {
+        flushScheduled = true;
+        QTimer::singleShot(0, this, SLOT(flushSends()));
+    }
+}
+
+template <class S>
+void Network<S>::flushSends()
+{
+    flushScheduled = false;
+
+    if (sendBuffer.isEmpty()) {
+        return;
+    }
+
+    if (socket()) {
+        socket()->write(sendBuffer);
     }
+    sendBuffer.clear();
 }
 
 typedef Network<QTcpSocket*> StandardNetwork;
@@ -0,0 +1,137 @@
+#ifdef __WIN32
+#include "../../SpecialIncludes/zlib.h"
+#else
+#include <zlib.h>
+#endif
+
+#include "zipstream.h"
+
+namespace {
+    /* 4KB window, and 16KB for the hash tables */
+    const int windowBits = 12;
+    const int memLevel = 5;
+    const int chunkSize = 4096;
+}
+
+ZipDeflater::ZipDeflater(const QByteArray &dictionary) : stream(new z_stream)
+{
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+
+    valid = deflateInit2(stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, memLevel, Z_DEFAULT_STRATEGY) == Z_OK;
+
+    if (valid && dictionary.length() > 0) {
+        valid = deflateSetDictionary(stream, (const Bytef*)dictionary.constData(), dictionary.length()) == Z_OK;
+    }
+}
+
+ZipDeflater::~ZipDeflater()
+{
+    deflateEnd(stream);
+    delete stream;
+}
+
+bool ZipDeflater::isValid() const
+{
+    return valid;
+}
+
+QByteArray ZipDeflater::compress(const QByteArray &data)
+{
+    if (!valid) {
+        return QByteArray();
+    }
+
+    QByteArray ret;
+    int written = 0;
+
+    stream->next_in = (Bytef*)data.constData();
+    stream->avail_in = data.length();
+
+    /* The output of a sync flush can be bigger than the input for small packets */
+    do {
+        ret.resize(written + chunkSize);
+
+        stream->next_out = (Bytef*)ret.data() + written;
+        stream->avail_out = chunkSize;
+
+        int res = deflate(stream, Z_SYNC_FLUSH);
+
+        if (res != Z_OK && res != Z_BUF_ERROR) {
+            valid = false;
+            return QByteArray();
+        }
+
+        written += chunkSize - stream->avail_out;
+    } while (stream->avail_out == 0);
+
+    ret.resize(written);
+    return ret;
+}
+
+ZipInflater::ZipInflater(const QByteArray &dictionary) : stream(new z_stream), dictionary(dictionary)
+{
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    stream->next_in = Z_NULL;
+    stream->avail_in = 0;
+
+    valid = inflateInit(stream) == Z_OK;
+}
+
+ZipInflater::~ZipInflater()
+{
+    inflateEnd(stream);
+    delete stream;
+}
+
+bool ZipInflater::isValid() const
+{
+    return valid;
+}
+
+bool ZipInflater::decompress(const QByteArray &data, QByteArray &out)
+{
+    out.clear();
+
+    if (!valid) {
+        return false;
+    }
+
+    int written = 0;
+
+    stream->next_in = (Bytef*)data.constData();
+    stream->avail_in = data.length();
+
+    forever {
+        out.resize(written + chunkSize);
+
+        stream->next_out = (Bytef*)out.data() + written;
+        stream->avail_out = chunkSize;
+
+        int res = inflate(stream, Z_SYNC_FLUSH);
+        written += chunkSize - stream->avail_out;
+
+        if (res == Z_NEED_DICT) {
+            if (dictionary.length() == 0 || inflateSetDictionary(stream, (const Bytef*)dictionary.constData(), dictionary.length()) != Z_OK) {
+                valid = false;
+                return false;
+            }
+            continue;
+        }
+
+        if (res != Z_OK && res != Z_BUF_ERROR) {
+            valid = false;
+            return false;
+        }
+
+        if (stream->avail_out != 0) {
+            break;
+        }
+    }
+
+    out.resize(written);
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef ZIPSTREAM_H
+#define ZIPSTREAM_H
+
+#include <QByteArray>
+
+struct z_stream_s;
+
+/*
+  Compression of a whole connection as one deflate stream.
+
+  Compressing each packet separately (like qCompress does) gives poor results
+  on the small packets that make most of the traffic. Keeping the same stream for
+  the whole connection allows each packet to refer to what was sent before.
+
+  Each call to compress() gives a chunk ending with a sync flush, that can be
+  decompressed right away on the other side with the same (persistent) ZipInflater.
+
+  Both sides can start with a preset dictionary, so the first packets compress well too.
+  The deflater uses a small window to keep the memory used per connection low (~32KB),
+  only the last 4KB of the dictionary are used.
+*/
+class ZipDeflater
+{
+public:
+    ZipDeflater(const QByteArray &dictionary = QByteArray());
+    ~ZipDeflater();
+
+    bool isValid() const;
+    /* Returns an empty array on error */
+    QByteArray compress(const QByteArray &data);
+private:
+    z_stream_s *stream;
+    bool valid;
+
+    ZipDeflater(const ZipDeflater&);
+    ZipDeflater& operator = (const ZipDeflater&);
+};
+
+class ZipInflater
+{
+public:
+    /* The dictionary is only used if the stream asks for it */
+    ZipInflater(const QByteArray &dictionary = QByteArray());
+    ~ZipInflater();
+
+    bool isValid() const;
+    /* Returns false if the data is corrupted, in which case the stream is unusable */
+    bool decompress(const QByteArray &data, QByteArray &out);
+private:
+    z_stream_s *stream;
+    QByteArray dictionary;
+    bool valid;
+
+    ZipInflater(const ZipInflater&);
+    ZipInflater& operator = (const ZipInflater&);
+};
+
+#endif // ZIPSTREAM_H
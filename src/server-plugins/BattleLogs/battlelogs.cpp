@@ -9,6 +9,7 @@
 #include <BattleManager/battleinput.h>
 #include <BattleManager/battleclientlog.h>
 #include <BattleManager/battledatatypes.h>
+#include <BattleManager/defaulttheme.h>
 #include "../Shared/battlecommands.h"
 
 
@@ -16,6 +17,51 @@ BattleServerPlugin * createBattleServerPlugin() {
     return new BattleLogs();
 }
 
+/* Plays the commands of a battle that's over through the client log, and saves the html */
+class HtmlLogTask : public QRunnable
+{
+public:
+    HtmlLogTask(const FullBattleConfiguration &conf, const TeamBattle &team1, const TeamBattle &team2,
+                const QByteArray &commands, const QString &fileName)
+        : conf(conf), team1(team1), team2(team2), commands(commands), fileName(fileName) {
+        this->conf.teams[0] = &this->team1;
+        this->conf.teams[1] = &this->team2;
+    }
+
+    void run() {
+        BattleDefaultTheme theme;
+        BattleInput input(&conf, conf.protocolVersion);
+        battledata_basic data(&conf);
+        BattleServerLog log(&data, &theme);
+
+        input.addOutput(&data);
+        input.addOutput(&log);
+
+        /* Teams as they were when the battle started */
+        data.reloadTeam(0);
+        data.reloadTeam(1);
+
+        DataStream in(commands);
+        qint32 time;
+        QByteArray command;
+
+        while (!in.atEnd()) {
+            in >> time >> command;
+            input.receiveData(command);
+        }
+
+        QFile out(fileName);
+        out.open(QIODevice::WriteOnly);
+        out.write(log.getLog().join("").toUtf8());
+        out.close();
+    }
+private:
+    FullBattleConfiguration conf;
+    TeamBattle team1, team2;
+    QByteArray commands;
+    QString fileName;
+};
+
 BattleLogs::BattleLogs()
 {
     QSettings s("config_battleLogs", QSettings::IniFormat);
@@ -27,6 +73,15 @@ BattleLogs::BattleLogs()
 
     QSettings server("config", QSettings::IniFormat);
     webUrl = server.value("Server/Web", "http://web.pkmn.co").toString();
+
+    /* The battles come first, leave them most of the cores */
+    htmlPool.setMaxThreadCount(qMax(QThread::idealThreadCount() / 4, 1));
+}
+
+BattleLogs::~BattleLogs()
+{
+    /* Their code is in the plugin */
+    htmlPool.waitForDone();
 }
 
 QString BattleLogs::pluginName() const
@@ -46,7 +101,7 @@ BattlePlugin* BattleLogs::getBattlePlugin(BattleInterface* b)
             return NULL;
     }
 
-    return new BattleLogsPlugin(b, saveRawFiles, saveTextFiles, webUrl);
+    return new BattleLogsPlugin(b, saveRawFiles, saveTextFiles, webUrl, &htmlPool);
 }
 
 bool BattleLogs::hasConfigurationWidget () const
@@ -111,21 +166,12 @@ void BattleLogsWidget::done()
 /************************/
 /************************/
 
-BattleLogsPlugin::BattleLogsPlugin(BattleInterface *b, bool raw, bool plain, const QString &url) : commands(&toSend, QIODevice::WriteOnly), raw(raw), text(plain), url(url), m(QMutex::Recursive)
+BattleLogsPlugin::BattleLogsPlugin(BattleInterface *b, bool raw, bool plain, const QString &url, QThreadPool *htmlPool) : commands(&toSend, QIODevice::WriteOnly), raw(raw), text(plain), url(url),
+    htmlPool(htmlPool), m(QMutex::Recursive)
 {
     //qDebug() << "plugin start";
-    input = NULL;
-
     conf = b->configuration();
 
-    if (text) {
-        input = new BattleInput(&conf, conf.protocolVersion);
-        data = new battledata_basic(&conf);
-        log = new BattleServerLog(data, &theme);
-        input->addOutput(data);
-        input->addOutput(log);
-    }
-
     started = false;
     logging = true;
     t.start();
@@ -134,11 +180,6 @@ BattleLogsPlugin::BattleLogsPlugin(BattleInterface *b, bool raw, bool plain, con
 BattleLogsPlugin::~BattleLogsPlugin()
 {
     //qDebug() << "plugin deleted";
-    if (input) {
-        input->deleteTree();
-    }
-
-    delete input, input = NULL;
 }
 
 QHash<QString, BattlePlugin::Hook> BattleLogsPlugin::getHooks()
@@ -156,16 +197,9 @@ int BattleLogsPlugin::battleStarting(BattleInterface &b)
 {
     //qDebug() << "battle started";
     QMutexLocker l(&m);
-    if (raw) {
-        team1 = b.team(0);
-        team2 = b.team(1);
-    }
-
     //team may have been reordered with wifi clause?
-    if (text) {
-        data->reloadTeam(0);
-        data->reloadTeam(1);
-    }
+    team1 = b.team(0);
+    team2 = b.team(1);
 
     id1 = b.id(0);
     id2 = b.id(1);
@@ -179,7 +213,6 @@ int BattleLogsPlugin::battleEnded(BattleInterface &b)
     //qDebug() << "battle ended";
     QMutexLocker l(&m);
 
-    (void) b;
     logging = false;
 
     //if (started) {
@@ -208,6 +241,15 @@ int BattleLogsPlugin::battleEnded(BattleInterface &b)
             outd << conf;
 
             out.write(toSend);
+
+            /* Readers of the commands stop at the empty one, the rest is to play the battle again */
+            outd << qint32(t.elapsed()) << QByteArray("");
+
+            DataStream resim(&out, 4);
+            resim << quint32(b.seed()) << qint32(b.rating(0)) << qint32(b.rating(1));
+            resim << team1.fullSerial() << team2.fullSerial();
+            resim << b.recordedChoices();
+
             out.close();
 
             /* Privacy concerns will be dealt with if they arise */
@@ -215,11 +257,14 @@ int BattleLogsPlugin::battleEnded(BattleInterface &b)
         }
 
         if (text) {
-            QFile out;
-            out.setFileName(QString("logs/battles/%1/%2-%3-%4.html").arg(date, hash));
-            out.open(QIODevice::WriteOnly);
-            out.write(log->getLog().join("").toUtf8());
-            out.close();
+            HtmlLogTask *task = new HtmlLogTask(conf, team1, team2, toSend, QString("logs/battles/%1/%2-%3-%4.html").arg(date, hash));
+
+            if (htmlPool) {
+                htmlPool->start(task);
+            } else {
+                task->run();
+                delete task;
+            }
         }
     //}
     return 0;
@@ -239,12 +284,9 @@ int BattleLogsPlugin::emitCommand(BattleInterface &, int, int players, QByteArra
     //if (players != BattleInterface::AllButPlayer && players < 10000) {
     /* Only spectator side */
     if (players == BattleInterface::AllButPlayer || players == BattleInterface::All) {
-        if (raw) {
+        if (raw || text) {
             commands << qint32(t.elapsed()) << b;
         }
-        if (text) {
-            input->receiveData(b);
-        }
     }
 
     return 0;
@@ -4,8 +4,6 @@
 #include "BattleLogs_global.h"
 #include "../BattleServer/plugininterface.h"
 #include "../BattleServer/battleinterface.h"
-#include <BattleManager/defaulttheme.h>
-#include <BattleManager/battledatatypes.h>
 #include <PokemonInfo/battlestructs.h>
 #include <Utilities/coreclasses.h>
 #include <QtCore>
@@ -40,7 +38,17 @@ class QTextEdit;
 
  V3-
  Now putting nature in PokeBattle before happiness (wasn't serialized before)
+
+ Since then, an empty command follows the last one, where readers stop. After it comes what's needed
+ to play the battle again (BattleServer --resimulate), serialized with all the fields of the teams (version 4):
+ <seed (32 bits)><rating1 (32 bits)><rating2 (32 bits)>
+ <team1 (TeamBattle::FullSerializer)><team2 (TeamBattle::FullSerializer)>
+ <choices (QList<BattleChoice>)>
+
  Current version output: V3
+
+ Html logs are made from the same commands once the battle is over, in the threads of the
+ plugin's pool, so that the battle thread only appends the commands.
 */
 
 extern "C" {
@@ -48,15 +56,14 @@ BATTLELOGSSHARED_EXPORT BattleServerPlugin * createBattleServerPlugin();
 }
 
 class PokeBattle;
-class BattleInput;
-class BattleClientLog;
 
 class BATTLELOGSSHARED_EXPORT BattleLogs
     : public BattleServerPlugin
 {
 public:
     BattleLogs();
-    virtual ~BattleLogs() {}
+    /* Waits for the html logs still being made */
+    virtual ~BattleLogs();
 
     QString pluginName() const;
 
@@ -71,6 +78,9 @@ public:
     bool saveRawFiles;
     bool saveTextFiles;
     QString webUrl;
+
+    /* Makes the html logs */
+    QThreadPool htmlPool;
 };
 
 class BATTLELOGSSHARED_EXPORT BattleLogsWidget : public QWidget
@@ -91,7 +101,7 @@ class BATTLELOGSSHARED_EXPORT BattleLogsPlugin
     : public BattlePlugin
 {
 public:
-    BattleLogsPlugin(BattleInterface *b= NULL, bool raw=true, bool text=false, const QString &url="");
+    BattleLogsPlugin(BattleInterface *b= NULL, bool raw=true, bool text=false, const QString &url="", QThreadPool *htmlPool=NULL);
     ~BattleLogsPlugin();
 
     QHash<QString, Hook> getHooks();
@@ -103,21 +113,19 @@ public:
     bool logging;
     int id1, id2;
 
+    /* The commands sent to the spectators, with their time, for both the raw and the html logs */
     QByteArray toSend;
     DataStream commands;
     QElapsedTimer t;
 
     FullBattleConfiguration conf;
-    BattleDefaultTheme theme;
-    BattleInput *input;
-    BattleClientLog *log;
-    battledata_basic *data;
 
     TeamBattle team1, team2;
 
     bool raw, text;
 
     QString url;
+    QThreadPool *htmlPool;
 private:
     QMutex m;
 };
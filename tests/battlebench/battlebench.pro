@@ -0,0 +1,64 @@
+#-------------------------------------------------
+#
+# Headless benchmark of the battle engine
+#
+#-------------------------------------------------
+
+QT += network
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+EXTRAS = test
+
+INCLUDEPATH += ../../src/
+INCLUDEPATH += ../common/
+
+include(../../src/Shared/Common.pri)
+
+LIBS += $$pokemoninfo
+
+TARGET = bench-battles
+
+SOURCES += main.cpp \
+    benchmark.cpp \
+    ../../src/BattleServer/rbymoves.cpp \
+    ../../src/BattleServer/mechanicsbase.cpp \
+    ../../src/BattleServer/mechanics.cpp \
+    ../../src/BattleServer/berries.cpp \
+    ../../src/BattleServer/battlerby.cpp \
+    ../../src/BattleServer/battlepluginstruct.cpp \
+    ../../src/BattleServer/battlecounters.cpp \
+    ../../src/BattleServer/battlebase.cpp \
+    ../../src/BattleServer/battle.cpp \
+    ../../src/BattleServer/abilities.cpp \
+    ../../src/BattleServer/items.cpp \
+    ../../src/BattleServer/pluginmanager.cpp \
+    ../../src/BattleServer/moves.cpp \
+    ../../src/BattleServer/effecthooks.cpp
+
+HEADERS += \
+    benchmark.h \
+    benchbattle.h \
+    ../../src/BattleServer/rbymoves.h \
+    ../../src/BattleServer/miscmoves.h \
+    ../../src/BattleServer/miscabilities.h \
+    ../../src/BattleServer/mechanicsbase.h \
+    ../../src/BattleServer/mechanics.h \
+    ../../src/BattleServer/berries.h \
+    ../../src/BattleServer/battlerby.h \
+    ../../src/BattleServer/battlepluginstruct.h \
+    ../../src/BattleServer/battleinterface.h \
+    ../../src/BattleServer/battlefunctions.h \
+    ../../src/BattleServer/battlecounters.h \
+    ../../src/BattleServer/battlecounterindex.h \
+    ../../src/BattleServer/battlebase.h \
+    ../../src/BattleServer/battle.h \
+    ../../src/BattleServer/abilities.h \
+    ../../src/BattleServer/moves.h \
+    ../../src/BattleServer/items.h \
+    ../../src/BattleServer/plugininterface.h \
+    ../../src/BattleServer/pluginmanager.h \
+    ../../src/BattleServer/effecthooks.h
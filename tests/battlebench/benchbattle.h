@@ -0,0 +1,127 @@
+#ifndef BENCHBATTLE_H
+#define BENCHBATTLE_H
+
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <Utilities/mtrand.h>
+#include <BattleServer/battlebase.h>
+
+/* What a group of battles measured */
+struct TurnStats
+{
+    TurnStats() : turns(0), battles(0), unfinished(0) {}
+
+    /* Time spent in the engine for each turn, in nanoseconds */
+    QVector<qint64> latencies;
+    qint64 turns;
+    int battles;
+    /* Battles stopped at the turn limit, or with no valid choice */
+    int unfinished;
+};
+
+/* A battle playing itself: choices are picked at random among the valid ones, with a generator
+   of its own so that the battle's generator is used the same way as in a real battle */
+template <class Battle>
+class BenchBattle : public Battle
+{
+public:
+    enum {
+        MaxTurns = 1000
+    };
+
+    BenchBattle(const BattlePlayer &p1, const BattlePlayer &p2, const ChallengeInfo &c, int id, const TeamBattle &t1,
+                const TeamBattle &t2, quint32 seed, TurnStats *stats)
+        : Battle(p1, p2, c, id, t1, t2, nullptr), ai(seed ^ 0x9e3779b9u), stats(stats), lastTurn(-1), spent(0)
+    {
+        this->script(seed, QList<BattleChoice>(), c.clauses);
+        timer.start();
+    }
+
+protected:
+    void playScriptedChoices() override {
+        spent += timer.nsecsElapsed();
+
+        /* Several waits can happen in the same turn, when a pokemon has to be replaced */
+        if (this->turn() != lastTurn) {
+            if (lastTurn != -1) {
+                stats->latencies.push_back(spent);
+                stats->turns += 1;
+            }
+            lastTurn = this->turn();
+            spent = 0;
+        }
+
+        if (this->turn() >= MaxTurns) {
+            stop();
+        }
+
+        for (int slot = 0; slot < this->numberOfSlots(); slot++) {
+            if (this->hasChoice[slot]) {
+                BattleChoice c;
+                if (!pick(slot, c)) {
+                    stop();
+                }
+                this->storeChoice(c);
+            }
+        }
+
+        for (int i = 0; i < this->numberOfSlots(); i++) {
+            this->couldMove[i] = false;
+        }
+
+        timer.start();
+    }
+
+private:
+    void stop() {
+        stats->unfinished += 1;
+        emit this->battleFinished(this->publicId(), Close, this->id(BattleBase::Player1), this->id(BattleBase::Player2));
+        this->exit();
+    }
+
+    bool pick(int slot, BattleChoice &ret) {
+        QList<BattleChoice> attacks, switches;
+
+        const BattleChoices &options = this->options[slot];
+
+        if (options.attacksAllowed) {
+            for (int move = options.struggle() ? -1 : 0; move < (options.struggle() ? 0 : 4); move++) {
+                for (int target = 0; target < this->numberOfSlots(); target++) {
+                    AttackChoice a = {qint8(move), qint8(target), false, false};
+                    BattleChoice c(slot, a);
+                    if (this->validChoice(c)) {
+                        attacks.push_back(c);
+                    }
+                }
+            }
+        }
+        if (options.switchAllowed) {
+            for (int poke = 0; poke < 6; poke++) {
+                SwitchChoice s = {qint8(poke)};
+                BattleChoice c(slot, s);
+                if (this->validChoice(c)) {
+                    switches.push_back(c);
+                }
+            }
+        }
+
+        /* Mostly attacking, so that the battles end */
+        if (!attacks.empty() && (switches.empty() || unsigned(ai()) % 8 != 0)) {
+            ret = attacks[unsigned(ai()) % attacks.size()];
+        } else if (!switches.empty()) {
+            ret = switches[unsigned(ai()) % switches.size()];
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    MTRand_int32 ai;
+    TurnStats *stats;
+    QElapsedTimer timer;
+    int lastTurn;
+    qint64 spent;
+};
+
+#endif // BENCHBATTLE_H
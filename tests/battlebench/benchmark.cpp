@@ -0,0 +1,195 @@
+#include <cstdio>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QFile>
+
+#include <Utilities/coreclasses.h>
+#include <PokemonInfo/geninfo.h>
+#include <BattleServer/battle.h>
+#include <BattleServer/battlerby.h>
+
+#include "benchmark.h"
+
+/* Teams generated for each gen */
+static const int teamsPerGen = 32;
+
+Benchmark::Benchmark(int battles, quint32 seed, const QString &teamFile)
+    : battles(battles), seed(seed), teamFile(teamFile), currentGroup(0), currentBattle(0), battle(nullptr),
+      startAllocations(0)
+{
+}
+
+bool Benchmark::init()
+{
+    foreach(int g, GenInfo::AllGens()) {
+        Pokemon::gen gen(g, GenInfo::NumberOfSubgens(g) - 1);
+
+        Group group = {gen, ChallengeInfo::Singles};
+        groups.push_back(group);
+
+        if (g >= 3) {
+            group.mode = ChallengeInfo::Doubles;
+            groups.push_back(group);
+        }
+        if (g == 5 || g == 6) {
+            group.mode = ChallengeInfo::Triples;
+            groups.push_back(group);
+            group.mode = ChallengeInfo::Rotation;
+            groups.push_back(group);
+        }
+    }
+
+    loadTeams();
+
+    bool generated = false;
+    foreach(const Group &group, groups) {
+        QList<TeamBattle> &list = teams[group.gen];
+
+        while (list.size() < teamsPerGen) {
+            TeamBattle t;
+            t.gen = group.gen;
+            t.generateRandom(group.gen, false);
+            list.push_back(t);
+            generated = true;
+        }
+    }
+
+    if (generated) {
+        saveTeams();
+    }
+
+    return !groups.empty();
+}
+
+void Benchmark::loadTeams()
+{
+    QFile in(teamFile);
+
+    if (!in.open(QIODevice::ReadOnly) || in.readLine().trimmed() != "battlebench_teams_v1") {
+        return;
+    }
+
+    DataStream stream(&in, 4);
+
+    qint32 count;
+    stream >> count;
+
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        TeamBattle t;
+        stream >> t.fullSerial();
+        teams[t.gen].push_back(t);
+    }
+}
+
+void Benchmark::saveTeams()
+{
+    QFile out(teamFile);
+
+    if (!out.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "Couldn't save the teams to %s, the next run will play different battles.\n", qPrintable(teamFile));
+        return;
+    }
+
+    out.write("battlebench_teams_v1\n");
+
+    DataStream stream(&out, 4);
+
+    qint32 count = 0;
+    foreach(const QList<TeamBattle> &list, teams) {
+        count += list.size();
+    }
+    stream << count;
+
+    foreach(const QList<TeamBattle> &list, teams) {
+        foreach(const TeamBattle &t, list) {
+            stream << t.fullSerial();
+        }
+    }
+}
+
+void Benchmark::start()
+{
+    ctx.start(1);
+
+    fprintf(stdout, "%-5s %-9s %8s %8s %10s %12s %9s %9s\n", "gen", "mode", "battles", "turns", "turns/s", "allocs/turn", "p50 (us)", "p99 (us)");
+
+    currentGroup = 0;
+    currentBattle = 0;
+    startBattle();
+}
+
+void Benchmark::startBattle()
+{
+    if (currentBattle == 0) {
+        stats = TurnStats();
+        startAllocations = allocations();
+        timer.start();
+    }
+
+    const Group &g = groups[currentGroup];
+    const QList<TeamBattle> &list = teams[g.gen];
+
+    BattlePlayer p1("Bench 1", 1), p2("Bench 2", 2);
+    ChallengeInfo c(0, 0, ChallengeInfo::SleepClause | ChallengeInfo::NoTimeOut, g.mode);
+    c.gen = g.gen;
+
+    const TeamBattle &t1 = list[(2 * currentBattle) % list.size()];
+    const TeamBattle &t2 = list[(2 * currentBattle + 1) % list.size()];
+
+    quint32 battleSeed = seed + quint32(currentGroup) * 100003u + quint32(currentBattle);
+    int id = currentGroup * battles + currentBattle + 1;
+
+    if (g.gen <= 1) {
+        battle = new BenchBattle<BattleRBY>(p1, p2, c, id, t1, t2, battleSeed, &stats);
+    } else {
+        battle = new BenchBattle<BattleSituation>(p1, p2, c, id, t1, t2, battleSeed, &stats);
+    }
+
+    connect(battle, SIGNAL(battleFinished(int,int,int,int)), SLOT(onBattleFinished()));
+    battle->start(ctx);
+}
+
+void Benchmark::onBattleFinished()
+{
+    battle->deleteLater();
+    battle = nullptr;
+
+    stats.battles += 1;
+
+    if (++currentBattle < battles) {
+        startBattle();
+        return;
+    }
+
+    report(groups[currentGroup], stats, timer.nsecsElapsed(), allocations() - startAllocations);
+
+    currentBattle = 0;
+    if (++currentGroup < groups.size()) {
+        startBattle();
+        return;
+    }
+
+    QCoreApplication::exit(0);
+}
+
+void Benchmark::report(const Group &g, const TurnStats &stats, qint64 nsecs, quint64 allocs)
+{
+    QVector<qint64> latencies = stats.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](int p) {
+        return latencies.empty() ? 0. : latencies[std::min(latencies.size() - 1, latencies.size() * p / 100)] / 1000.;
+    };
+
+    double turnsPerSec = nsecs > 0 ? stats.turns * 1e9 / nsecs : 0;
+    double allocsPerTurn = stats.turns > 0 ? double(allocs) / stats.turns : 0;
+
+    fprintf(stdout, "%-5d %-9s %8d %8lld %10.0f %12.1f %9.1f %9.1f\n", g.gen.num, qPrintable(ChallengeInfo::modeName(g.mode)),
+            stats.battles, stats.turns, turnsPerSec, allocsPerTurn, percentile(50), percentile(99));
+
+    if (stats.unfinished > 0) {
+        fprintf(stdout, "      (%d battle(s) stopped before the end)\n", stats.unfinished);
+    }
+    fflush(stdout);
+}
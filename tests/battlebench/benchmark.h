@@ -0,0 +1,59 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <Utilities/contextswitch.h>
+#include <PokemonInfo/battlestructs.h>
+
+#include "benchbattle.h"
+
+/* Plays battles for each generation and mode one after the other, and reports how fast
+   the engine went */
+class Benchmark : public QObject
+{
+    Q_OBJECT
+public:
+    Benchmark(int battles, quint32 seed, const QString &teamFile);
+
+    /* Returns false if no team could be loaded or generated */
+    bool init();
+    void start();
+
+    /* Number of calls to operator new so far, counted in main.cpp */
+    static quint64 allocations();
+public slots:
+    void onBattleFinished();
+private:
+    struct Group {
+        Pokemon::gen gen;
+        int mode;
+    };
+
+    void loadTeams();
+    void saveTeams();
+    void startBattle();
+    void report(const Group &g, const TurnStats &stats, qint64 nsecs, quint64 allocs);
+
+    int battles;
+    quint32 seed;
+    QString teamFile;
+
+    /* Teams of each gen, generated once and saved so that every run plays the same battles */
+    QHash<Pokemon::gen, QList<TeamBattle> > teams;
+
+    QList<Group> groups;
+    int currentGroup;
+    int currentBattle;
+    BattleBase *battle;
+
+    TurnStats stats;
+    QElapsedTimer timer;
+    quint64 startAllocations;
+
+    ContextSwitcher ctx;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,136 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <atomic>
+#include <algorithm>
+
+#include <QCoreApplication>
+
+#include <PokemonInfo/pokemoninfo.h>
+#include <PokemonInfo/movesetchecker.h>
+#include <BattleServer/abilities.h>
+#include <BattleServer/items.h>
+#include <BattleServer/moves.h>
+#include <BattleServer/rbymoves.h>
+
+#include "benchmark.h"
+
+#define PRINTOPT(a, b) (fprintf(stdout, "  %-25s\t%s\n", a, b))
+
+/* Every allocation of the program goes through here, so that the benchmark can tell how
+   many allocations a turn costs */
+static std::atomic<quint64> allocationCount(0);
+
+quint64 Benchmark::allocations()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void *operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+static void loadDatabase()
+{
+    PokemonInfoConfig::setFillMode(FillMode::Server);
+    PokemonInfoConfig::changeMod("");
+
+    GenInfo::init("db/gens/");
+    PokemonInfo::init("db/pokes/");
+    MoveSetChecker::init("db/pokes/");
+    ItemInfo::init("db/items/");
+    MoveInfo::init("db/moves/");
+    TypeInfo::init("db/types/");
+    NatureInfo::init("db/natures/");
+    CategoryInfo::init("db/categories/");
+    AbilityInfo::init("db/abilities/");
+    HiddenPowerInfo::init("db/types/");
+    StatInfo::init("db/status/");
+    GenderInfo::init("db/genders/");
+
+    PokemonInfo::loadStadiumTradebacks();
+
+    MoveEffect::init();
+    RBYMoveEffect::init();
+    ItemEffect::init();
+    AbilityEffect::init();
+}
+
+int main(int argc, char *argv[])
+{
+    int battles = 200;
+    quint32 seed = 42;
+    QString teamFile = "battlebench-teams.dat";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            fprintf(stdout, "Plays battles between random AIs for each generation and mode, and reports\n");
+            fprintf(stdout, "the turns per second, allocations per turn and turn latencies of the battle engine.\n");
+            fprintf(stdout, "\n");
+            fprintf(stdout, "Usage: ./bench-battles [[options]]\n");
+            fprintf(stdout, "Options:\n");
+            PRINTOPT("-h, --help", "Displays this help.");
+            PRINTOPT("-b, --battles [N]", "Number of battles for each generation and mode (default: 200).");
+            PRINTOPT("-s, --seed [S]", "Seed of the battles and of the AIs (default: 42).");
+            PRINTOPT("-t, --teams [FILE]", "Teams to use, generated and saved there if missing (default: battlebench-teams.dat).");
+            fprintf(stdout, "\n");
+            return 0;
+        } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--battles") == 0) {
+            if (++i == argc) {
+                fprintf(stderr, "No number of battles provided.\n");
+                return 1;
+            }
+            battles = std::max(atoi(argv[i]), 1);
+        } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seed") == 0) {
+            if (++i == argc) {
+                fprintf(stderr, "No seed provided.\n");
+                return 1;
+            }
+            seed = strtoul(argv[i], nullptr, 10);
+        } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--teams") == 0) {
+            if (++i == argc) {
+                fprintf(stderr, "No team file provided.\n");
+                return 1;
+            }
+            teamFile = QString::fromLocal8Bit(argv[i]);
+        }
+    }
+
+    QCoreApplication a(argc, argv);
+
+    loadDatabase();
+
+    Benchmark benchmark(battles, seed, teamFile);
+
+    if (!benchmark.init()) {
+        fprintf(stderr, "No battle to play.\n");
+        return 1;
+    }
+
+    benchmark.start();
+
+    return a.exec();
+}
@@ -1,6 +1,7 @@
 #include <QCoreApplication>
 #include "testimportexportteam.h"
 #include "testiteminfo.h"
+#include "testmovebitset.h"
 #include "pokemontestrunner.h"
 
 int main(int argc, char *argv[])
@@ -11,6 +12,7 @@ int main(int argc, char *argv[])
     runner.setName("pokemoninfo");
     runner.addTest(new TestImportExportTeam());
     runner.addTest(new TestItemInfo());
+    runner.addTest(new TestMoveBitset());
     runner.start();
 
     return a.exec();
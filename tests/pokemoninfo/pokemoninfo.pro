@@ -25,11 +25,13 @@ SOURCES += main.cpp \
     ../common/testrunner.cpp \
     testimportexportteam.cpp \
     ../common/pokemontestrunner.cpp \
-    testiteminfo.cpp
+    testiteminfo.cpp \
+    testmovebitset.cpp
 
 HEADERS += \
     ../common/test.h \
     ../common/testrunner.h \
     testimportexportteam.h \
     ../common/pokemontestrunner.h \
-    testiteminfo.h
+    testiteminfo.h \
+    testmovebitset.h
@@ -0,0 +1,45 @@
+#include <PokemonInfo/pokemoninfo.h>
+#include <PokemonInfo/movesetchecker.h>
+#include "testmovebitset.h"
+
+void TestMoveBitset::run()
+{
+    MoveBitset set, other;
+
+    assert(set.isEmpty());
+    assert(set.first() == -1);
+
+    set.insert(1);
+    set.insert(64);
+    set.insert(MoveBitset::Size - 1);
+    set.insert(MoveBitset::Size);
+    set.insert(-1);
+
+    assert(set.count() == 3);
+    assert(set.first() == 1);
+    assert(set.contains(64) && !set.contains(63) && !set.contains(MoveBitset::Size));
+    assert(set.toList() == (QList<int>() << 1 << 64 << MoveBitset::Size - 1));
+
+    other.insert(64);
+    assert(set.contains(other) && !other.contains(set));
+    assert(set.intersects(other));
+
+    other.insert(65);
+    assert(!set.contains(other));
+    assert(MoveBitset(set).intersect(other).toSet() == (QSet<int>() << 64));
+    assert(MoveBitset(set).subtract(other).toSet() == (QSet<int>() << 1 << MoveBitset::Size - 1));
+    assert(MoveBitset(set.toSet()) == set);
+
+    /* The QSet getters are a view of the bitsets */
+    Pokemon::gen gen = GenInfo::GenMax();
+    assert(!PokemonInfo::Learnset(Pokemon::Pikachu, gen).genMoves.isEmpty());
+    assert(PokemonInfo::Moves(Pokemon::Pikachu, gen) == PokemonInfo::Learnset(Pokemon::Pikachu, gen).genMoves.toSet());
+
+    int move = PokemonInfo::Learnset(Pokemon::Pikachu, gen).regularMoves.first();
+    assert(MoveSetChecker::isValid(Pokemon::Pikachu, gen, QSet<int>() << move));
+
+    /* Moves out of the bitsets are refused, not dropped */
+    QSet<int> invalid;
+    assert(!MoveSetChecker::isValid(Pokemon::Pikachu, gen, QSet<int>() << move << 5000, 0, 0, 100, false, &invalid));
+    assert(invalid.contains(5000));
+}
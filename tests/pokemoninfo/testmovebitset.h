@@ -0,0 +1,12 @@
+#ifndef TESTMOVEBITSET_H
+#define TESTMOVEBITSET_H
+
+#include "test.h"
+
+class TestMoveBitset : public Test
+{
+public:
+    void run();
+};
+
+#endif // TESTMOVEBITSET_H
@@ -0,0 +1,17 @@
+#include <QCoreApplication>
+#include "testrunner.h"
+#include "testladderfile.h"
+#include "testmemberfile.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    TestRunner runner;
+    runner.setName("serverfiles");
+    runner.addTest(new TestLadderFile());
+    runner.addTest(new TestMemberFile());
+    runner.start();
+
+    return a.exec();
+}
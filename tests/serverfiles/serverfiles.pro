@@ -0,0 +1,39 @@
+#-------------------------------------------------
+#
+# Memory mapped files of the server, when not using SQL
+#
+#-------------------------------------------------
+
+QT       += widgets
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+EXTRAS = test
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../src/
+INCLUDEPATH += ../common/
+
+include(../../src/Shared/Common.pri)
+
+LIBS += $$utilities
+
+TARGET = test-serverfiles
+
+SOURCES += main.cpp \
+    ../common/test.cpp \
+    ../common/testrunner.cpp \
+    ../../src/Server/ladderfile.cpp \
+    ../../src/Server/memberfile.cpp \
+    testladderfile.cpp \
+    testmemberfile.cpp
+
+HEADERS += \
+    ../common/test.h \
+    ../common/testrunner.h \
+    ../../src/Server/ladderfile.h \
+    ../../src/Server/memberfile.h \
+    testladderfile.h \
+    testmemberfile.h
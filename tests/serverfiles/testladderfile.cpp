@@ -0,0 +1,55 @@
+#include <QTemporaryDir>
+#include <Server/tier.h>
+#include <Server/ladderfile.h>
+#include "testladderfile.h"
+
+void TestLadderFile::run()
+{
+    QTemporaryDir dir;
+    assert(dir.isValid());
+
+    QString path = dir.path() + "/tier_test.dat";
+    LadderFile ladder;
+    bool opened = ladder.open(path);
+    assert(opened);
+
+    /* The file starts with room for 1024 members, so it has to grow a few times */
+    const int count = 3000;
+    bool written;
+    for (int i = 0; i < count; i++) {
+        MemberRating m(QString("Player %1").arg(i), i, 1000 + i);
+        written = ladder.write(m);
+        assert(written && m.filePos == i);
+    }
+    assert(ladder.records() == count);
+
+    /* Updates stay in place */
+    MemberRating updated("Player 1500", 7, 1234);
+    updated.filePos = 1500;
+    written = ladder.write(updated);
+    assert(written && updated.filePos == 1500);
+
+    ladder.close();
+    opened = ladder.open(path);
+    assert(opened && ladder.records() == count);
+
+    for (int i = 0; i < count; i++) {
+        MemberRating m;
+        bool read = ladder.read(i, m);
+        assert(read && m.name == QString("Player %1").arg(i) && m.filePos == i);
+        assert(m.rating == (i == 1500 ? 1234 : 1000 + i));
+    }
+
+    /* Shrinks the file back, and it can grow again */
+    ladder.clear();
+    assert(ladder.records() == 0);
+
+    for (int i = 0; i < 2000; i++) {
+        MemberRating m(QString("Player %1").arg(i));
+        written = ladder.write(m);
+        assert(written);
+    }
+    assert(ladder.records() == 2000);
+
+    ladder.close();
+}
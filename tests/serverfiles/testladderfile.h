@@ -0,0 +1,12 @@
+#ifndef TESTLADDERFILE_H
+#define TESTLADDERFILE_H
+
+#include "test.h"
+
+class TestLadderFile : public Test
+{
+public:
+    void run();
+};
+
+#endif // TESTLADDERFILE_H
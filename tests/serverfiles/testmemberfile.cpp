@@ -0,0 +1,54 @@
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <Server/security.h>
+#include <Server/memberfile.h>
+#include "testmemberfile.h"
+
+static QString ipOf(int i)
+{
+    return QString("10.0.%1.%2").arg(i / 256).arg(i % 256);
+}
+
+void TestMemberFile::run()
+{
+    QTemporaryDir dir;
+    assert(dir.isValid());
+
+    QString path = dir.path() + "/members";
+    MemberFile members;
+    bool opened = members.open(path);
+    assert(opened);
+    qint64 indexSize = QFileInfo(path + ".idx").size();
+
+    /* More than the 1024 records the file starts with, and enough for the index to grow its buckets */
+    const int count = 5000;
+    bool written;
+    for (int i = 0; i < count; i++) {
+        SecurityManager::Member m(QString("Member %1").arg(i), "2026-10-18", i % 5 == 0, false, "", "", ipOf(i));
+        written = members.write(m);
+        assert(written && m.filepos == i);
+    }
+    assert(members.count() == count && members.flagged().size() == count / 5);
+    assert(QFileInfo(path + ".idx").size() > indexSize);
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < count; i++) {
+            /* Names are looked up regardless of the case */
+            int index = members.find(QString("MEMBER %1").arg(i));
+            assert(index == i);
+            assert(members.findByIp(ipOf(i)) == QList<int>() << i);
+
+            SecurityManager::Member m;
+            bool read = members.read(index, m);
+            assert(read && m.name == QString("Member %1").arg(i) && m.auth == (i % 5 == 0));
+        }
+        assert(members.find("Member 5000") == -1 && members.findByIp("10.1.0.0").isEmpty());
+
+        /* Then the same from the files */
+        members.close();
+        opened = members.open(path);
+        assert(opened && members.count() == count);
+    }
+
+    members.close();
+}
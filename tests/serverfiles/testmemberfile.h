@@ -0,0 +1,12 @@
+#ifndef TESTMEMBERFILE_H
+#define TESTMEMBERFILE_H
+
+#include "test.h"
+
+class TestMemberFile : public Test
+{
+public:
+    void run();
+};
+
+#endif // TESTMEMBERFILE_H
@@ -3,4 +3,6 @@ TEMPLATE = subdirs
 SUBDIRS = utilities \
         pokemoninfo \
         battleserver \
+        battlebench \
+        serverfiles \
         server
@@ -3,6 +3,7 @@
 #include "testfunctions.h"
 #include "testinsensitivemap.h"
 #include "testrankingtree.h"
+#include "testipranges.h"
 
 int main(int argc, char *argv[])
 {
@@ -13,6 +14,7 @@ int main(int argc, char *argv[])
     runner.addTest(new TestInsensitiveMap());
     runner.addTest(new TestFunctions());
     runner.addTest(new TestRankingTree());
+    runner.addTest(new TestIpRanges());
     runner.start();
 
     return a.exec();
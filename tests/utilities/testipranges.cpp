@@ -0,0 +1,32 @@
+#include <Utilities/ipranges.h>
+#include "testipranges.h"
+
+void TestIpRanges::run()
+{
+    IpRanges ranges(QStringList() << "127.0.0.1" << "::1%0" << "localhost" << "10.0.0.0/8" << "192.168.1.0/24" << "2001:db8::/32");
+
+    assert(ranges.contains("127.0.0.1") && !ranges.contains("127.0.0.2"));
+    assert(ranges.contains("::1") && ranges.contains("localhost"));
+    assert(ranges.contains("10.255.0.1") && !ranges.contains("11.0.0.1"));
+    assert(ranges.contains("192.168.1.77") && !ranges.contains("192.168.2.1"));
+    /* IPv4 addresses of dual stack sockets */
+    assert(ranges.contains("::ffff:10.1.2.3") && !ranges.contains("::ffff:11.1.2.3"));
+    assert(ranges.contains("2001:db8:1::5") && !ranges.contains("2001:db9::5"));
+    assert(!ranges.contains("example.com") && !ranges.contains(""));
+
+    assert(!ranges.insert("10.0.0.0/33") && !ranges.insert("::/129"));
+    assert(ranges.toStringList().size() == 6);
+
+    /* Larger ranges contain the smaller ones inserted before */
+    ranges.insert("192.168.0.0/16");
+    assert(ranges.contains("192.168.2.1"));
+
+    ranges.insert("0.0.0.0/0");
+    assert(ranges.contains("8.8.8.8") && !ranges.contains("2001:db9::5"));
+
+    ranges.clear();
+    assert(ranges.isEmpty() && !ranges.contains("127.0.0.1") && !ranges.contains("localhost"));
+
+    ranges.insert("::/0");
+    assert(ranges.contains("2001:db9::5") && ranges.contains("8.8.8.8"));
+}
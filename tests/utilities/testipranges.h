@@ -0,0 +1,12 @@
+#ifndef TESTIPRANGES_H
+#define TESTIPRANGES_H
+
+#include "test.h"
+
+class TestIpRanges : public Test
+{
+public:
+    void run();
+};
+
+#endif // TESTIPRANGES_H
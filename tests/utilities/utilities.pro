@@ -15,6 +15,7 @@ SOURCES += main.cpp \
     testinsensitivemap.cpp \
     testfunctions.cpp \
     testrankingtree.cpp \
+    testipranges.cpp \
     ../common/test.cpp \
     ../common/testrunner.cpp
 
@@ -31,6 +32,7 @@ HEADERS += \
     testinsensitivemap.h \
     testfunctions.h \
     testrankingtree.h \
+    testipranges.h \
     ../common/test.h \
     ../common/testrunner.h
 